@@ -41,9 +41,28 @@ DISTFILES += \
 
 SOURCES +=  \
     algorithms/algorithms.cpp \
+    algorithms/balanced_dag.cpp \
+    algorithms/batch_location.cpp \
+    algorithms/dag_layout.cpp \
+    algorithms/durable_map.cpp \
+    algorithms/live_map.cpp \
+    algorithms/map_clone.cpp \
+    algorithms/parallel_build.cpp \
+    algorithms/parallel_insertion.cpp \
+    algorithms/point_locator.cpp \
+    algorithms/simd_location.cpp \
+    algorithms/versioned_map.cpp \
     data_structures/dag.cpp \
+    data_structures/insertion_journal.cpp \
+    data_structures/insertion_log.cpp \
+    data_structures/map_snapshot.cpp \
     data_structures/node.cpp \
+    data_structures/packed_geometry.cpp \
+    data_structures/packed_trapezoids.cpp \
+    data_structures/query_profile.cpp \
     data_structures/segment_intersection_checker.cpp \
+    data_structures/slab_tree.cpp \
+    data_structures/snapshot_publisher.cpp \
     data_structures/trapezoid.cpp \
     data_structures/trapezoidalmap.cpp \
     data_structures/trapezoidalmap_dataset.cpp \
@@ -52,6 +71,7 @@ SOURCES +=  \
     main.cpp \
     managers/trapezoidalmap_manager.cpp \
     utils/fileutils.cpp \
+    utils/predicates.cpp \
     utils/projectUtils.cpp
 
 FORMS += \
@@ -59,9 +79,32 @@ FORMS += \
 
 HEADERS += \
     algorithms/algorithms.h \
+    algorithms/balanced_dag.h \
+    algorithms/batch_location.h \
+    algorithms/dag_layout.h \
+    algorithms/dag_traversal.h \
+    algorithms/durable_map.h \
+    algorithms/live_map.h \
+    algorithms/map_clone.h \
+    algorithms/parallel_build.h \
+    algorithms/parallel_insertion.h \
+    algorithms/point_locator.h \
+    algorithms/quantized_location.h \
+    algorithms/simd_location.h \
+    algorithms/versioned_map.h \
+    data_structures/chunked_vector.h \
     data_structures/dag.h \
+    data_structures/insertion_journal.h \
+    data_structures/insertion_log.h \
+    data_structures/map_snapshot.h \
     data_structures/node.h \
+    data_structures/packed_geometry.h \
+    data_structures/packed_trapezoids.h \
+    data_structures/quantized_geometry.h \
+    data_structures/query_profile.h \
     data_structures/segment_intersection_checker.h \
+    data_structures/slab_tree.h \
+    data_structures/snapshot_publisher.h \
     data_structures/trapezoid.h \
     data_structures/trapezoidalmap.h \
     data_structures/trapezoidalmap_dataset.h \
@@ -69,6 +112,7 @@ HEADERS += \
     drawables/drawable_trapezoidalmap_dataset.h \
     managers/trapezoidalmap_manager.h \
     utils/fileutils.h \
+    utils/predicates.h \
     utils/projectUtils.h
 
 
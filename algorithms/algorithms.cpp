@@ -1,5 +1,7 @@
 #include "algorithms.h"
-#include <cg3/geometry/utils2.h> // To use the isPoitAtLeft() utility
+#include "dag_traversal.h"
+#include "utils/predicates.h" // Adaptive precision orientation (isPointAbove, isPointBelow)
+#include <unordered_set>
 
 //Limits for the bounding box
 //It defines where points can be added
@@ -16,37 +18,7 @@ namespace algorithms{
  * @return The index of the trapezoid in which lies the left endpoint of the query segment
 */
 size_t querySegment(const cg3::Segment2d &querySegment, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData){
-    Node node = dag.getRoot();
-    // Search in the dag until a leaf is found
-    while(node.getType() != Node::NodeType::LEAF){
-        // If the node is type "X" it refer to a point
-        if(node.getType() == Node::NodeType::X){
-            // The point "q" is to the left or to the right of the point
-            const cg3::Point2d &point = trapezoidalMapData.getPoint(node.getIdx());
-            if(querySegment.p1().x() < point.x() ){// If the point lies to the left of the segment's left endpoint
-                node = dag.getNode(node.getLeftIdx());
-            }else{ //If the point lies to the right of the segment's right endpoint
-                node = dag.getNode(node.getRightIdx());
-            }
-        }else if(node.getType() == Node::NodeType::Y){ // The node refer to a segment
-            // The point "q" is above or below the segment
-            cg3::Segment2d segment = trapezoidalMapData.getSegment(node.getIdx());
-            ProjectUtils::orderSegment(segment);
-            if(cg3::isPointAtLeft(segment, querySegment.p1())){ // return true if the left endpoint point is above, false otherwise
-                node = dag.getNode(node.getLeftIdx());
-            }else if(cg3::isPointAtRight(segment, querySegment.p1())){ // If the left endpoint is below
-                node = dag.getNode(node.getRightIdx());
-            }else{ // Check right endpoint
-                if(cg3::isPointAtLeft(segment, querySegment.p2())){
-                    node = dag.getNode(node.getLeftIdx());
-                }else{
-                    node = dag.getNode(node.getRightIdx());
-                }
-            }
-        }
-    }
-
-    return node.getIdx();
+    return traverseDag(dag, trapezoidalMapData, SegmentPolicy(querySegment));
 }
 
 /**
@@ -58,36 +30,63 @@ size_t querySegment(const cg3::Segment2d &querySegment, const Dag &dag, const Tr
  * Perform the search in the Dag search structure by exploiting the different node types (x: point, y: segment, leaf: trapezoid)
 */
 size_t queryPoint(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData){
+    // Descent with the point predicates: left of the x-nodes if q.x is smaller, above the y-nodes if q is strictly above the segment
+    return traverseDag(dag, trapezoidalMapData, PointPolicy(q));
+}
 
-    // Getting the root of the dag
-    Node node = dag.getRoot();
-
-    // Search in the dag until a leaf is found
-    while(node.getType() != Node::NodeType::LEAF){
-        // If the node is type "X" it refer to a point
-        if(node.getType() == Node::NodeType::X){
-            // The point "q" is to the left or to the right of the point
-            const cg3::Point2d &point = trapezoidalMapData.getPoint(node.getIdx());
-            if(q.x() < point.x() ){// If the point lies to the left of q
-                node = dag.getNode(node.getLeftIdx());
-            }else{ //If the point lies to the right of q
-                node = dag.getNode(node.getRightIdx());
-            }
-        }else if(node.getType() == Node::NodeType::Y){ // The node refer to a segment
-            // The point "q" is above or below the segment
-            cg3::Segment2d segment = trapezoidalMapData.getSegment(node.getIdx());
-            ProjectUtils::orderSegment(segment);
-            if(cg3::isPointAtLeft(segment, q)){ // return true if the point is above, false otherwise
-                node = dag.getNode(node.getLeftIdx());
-            }else{
-                node = dag.getNode(node.getRightIdx());
-            }
+/**
+ * @brief Locate in which trapezoid lies the given point q on a snapshot of the map
+ * @param[in] q Query point
+ * @param[in] snapshot the snapshot, with the Dag and the geometry of the dataset
+ * @return The index of the trapezoid of the snapshot in which lies the query point
+*/
+size_t queryPoint(const cg3::Point2d &q, const MapSnapshot &snapshot){
+    return traverseDag(snapshot.getDag(), snapshot, PointPolicy(q));
+}
 
-            // Maybe handle also the case when the point lies on the segment?
-        }
+/**
+ * @brief Locate in which trapezoid lies the given point q, recording the visited nodes in a query profile
+ * @param[in] q Query point
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[out] profile the profile where the visits are recorded
+ * @return The index of the trapezoid in which lies the query point (the same answer of queryPoint)
+ * Used during a sampling period, to collect the statistics for the profile guided layout of the Dag
+*/
+size_t queryPoint(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData, QueryProfile &profile){
+    ProfileVisitor visitor(profile);
+    return traverseDag(dag, trapezoidalMapData, PointPolicy(q), visitor);
+}
+
+/**
+ * @brief Vertical ray-shooting query: find the segments directly above and below the given point q
+ * @param[in] q Query point
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return A pair containing the dataset index of the segment above q (first) and of the segment below q (second)
+ * Locate q in the Dag and read the top and bottom edges of the found trapezoid, a null index is returned when the edge is the bounding box
+*/
+std::pair<size_t, size_t> queryAboveBelow(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
+    const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(queryPoint(q, dag, trapezoidalMapData));
+    return std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx());
+}
+
+/**
+ * @brief Vertical ray-shooting query for a batch of points
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return A vector containing, for each query point, the dataset index of the segment above (first) and below (second) the point
+ */
+std::vector<std::pair<size_t, size_t>> queryAboveBelow(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
+    std::vector<std::pair<size_t, size_t>> aboveBelow;
+    aboveBelow.reserve(queryPoints.size());
+    for(const cg3::Point2d &q : queryPoints){
+        aboveBelow.push_back(queryAboveBelow(q, dag, trapezoidalMap, trapezoidalMapData));
     }
-    // Index of the trapezoid containing the point q
-    return node.getIdx();
+    return aboveBelow;
 }
 
 /**
@@ -99,9 +98,23 @@ size_t queryPoint(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDat
  * @return A vector containing the index of all the trapezoids intersected by the given segment
  */
 std::vector<size_t> followSegment(const cg3::Segment2d &segment, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
-
-    // Vector that will contain all trapezoids intersected by the segment
     std::vector<size_t> intersectedTrapezoids;
+    followSegment(segment, dag, trapezoidalMap, trapezoidalMapData, intersectedTrapezoids);
+    return intersectedTrapezoids;
+}
+
+/**
+ * @brief Find the trapezoids intersected by a given segment, in a given vector
+ * @param[in] segment The given segment
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[out] intersectedTrapezoids the index of all the trapezoids intersected by the given segment (the vector is cleared first,
+ * so its storage is reused)
+ */
+void followSegment(const cg3::Segment2d &segment, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                   std::vector<size_t> &intersectedTrapezoids){
+    intersectedTrapezoids.clear();
     assert(segment.p1().x() < segment.p2().x());
     // Need to search the left endpoint of s in the DAG to find the trapezoid zero
     size_t idxTrapezoid = querySegment(segment, dag, trapezoidalMapData);
@@ -112,7 +125,7 @@ std::vector<size_t> followSegment(const cg3::Segment2d &segment, const Dag &dag,
     // Check if p2 lies to the right of the right endpoint of the trapezoid
     while(segment.p2().x() > rightPoint.x()){
         // If the right point of the trapezoid lies above the segment put the lower right neighbor in the intersected trapezoids vector and go on with it
-        if(cg3::isPointAtLeft(segment, rightPoint)){
+        if(ProjectUtils::isPointAbove(segment, rightPoint)){
             idxTrapezoid = trapezoidalMap.getTrapezoid(idxTrapezoid).getLowerRightNeighbor();
         }else{ // it is below set upper right neighbor
             idxTrapezoid = trapezoidalMap.getTrapezoid(idxTrapezoid).getUpperRightNeighbor();
@@ -122,8 +135,243 @@ std::vector<size_t> followSegment(const cg3::Segment2d &segment, const Dag &dag,
         // Setting the rightPoint of the new trapezoid
         rightPoint = trapezoidalMap.getTrapezoid(idxTrapezoid).getRightPoint();
     }
+}
 
-    return intersectedTrapezoids;
+/**
+ * @brief Locate the trapezoid lying immediately above (or below) a segment of the map at a given point of the segment
+ * @param[in] crossingPoint the point of the crossed segment
+ * @param[in] crossedSegmentIdx the dataset index of the crossed segment
+ * @param[in] above true to locate the trapezoid above the segment, false to locate the one below
+ * @param[in] direction a point used to break the ties when the crossing point lies on another segment (the next point of the walk)
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return The index of the trapezoid on the given side of the crossed segment
+ * The y-nodes of the crossed segment are forced to the requested side, so the result does not depend on the rounding of the crossing point
+*/
+size_t locateAcrossSegment(const cg3::Point2d &crossingPoint, size_t crossedSegmentIdx, bool above, const cg3::Point2d &direction, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData){
+    return traverseDag(dag, trapezoidalMapData, CrossingPolicy(crossingPoint, crossedSegmentIdx, above, direction));
+}
+
+/**
+ * @brief Find the trapezoids traversed and the segments crossed by an arbitrary query segment
+ * @param[in] querySeg the query segment (it can have any orientation, also vertical, and it does not need to be in the dataset)
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[out] crossedTrapezoids the indexes of the traversed trapezoids, from the left (lower) endpoint to the other one
+ * @param[out] crossedSegments the dataset indexes of the crossed segments, in the same order
+ * The trapezoid containing the first endpoint is located with the Dag, then the walk goes through the right neighbors of the trapezoids;
+ * when the query leaves a trapezoid through its top or bottom edge, the trapezoid on the other side of the crossed segment is located at the crossing point.
+ * The read-only version of followSegment, it does not require the segment to be inserted or to be non-crossing. A vertical query
+ * walks upward with queryVerticalCrossing.
+*/
+void querySegmentCrossing(const cg3::Segment2d &querySeg, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                          std::vector<size_t> &crossedTrapezoids, std::vector<size_t> &crossedSegments){
+    size_t nullIdx = std::numeric_limits<size_t>::max();
+    crossedTrapezoids.clear();
+    crossedSegments.clear();
+
+    // Ordering the segment, p1 is the left endpoint (the lower one for a vertical segment)
+    cg3::Segment2d segment = querySeg;
+    if(segment.p2() < segment.p1()){
+        segment.setP1(querySeg.p2());
+        segment.setP2(querySeg.p1());
+    }
+    if(segment.p1().x() == segment.p2().x()){
+        queryVerticalCrossing(segment, dag, trapezoidalMap, trapezoidalMapData, crossedTrapezoids, crossedSegments);
+        return;
+    }
+
+    size_t idxTrapezoid = querySegment(segment, dag, trapezoidalMapData);
+    crossedTrapezoids.push_back(idxTrapezoid);
+
+    while(true){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(idxTrapezoid);
+        // Point of the query segment where it leaves the x-range of the trapezoid
+        double xEnd = std::min(segment.p2().x(), trapezoid.getRightPoint().x());
+        cg3::Point2d endPoint = xEnd == segment.p2().x() ? segment.p2() : cg3::Point2d(xEnd, ProjectUtils::segmentYAt(segment, xEnd));
+
+        cg3::Segment2d topSegment = trapezoid.getTopSegment();
+        ProjectUtils::orderSegment(topSegment);
+        cg3::Segment2d bottomSegment = trapezoid.getBottomSegment();
+        ProjectUtils::orderSegment(bottomSegment);
+
+        size_t nextTrapezoid = nullIdx;
+        if(trapezoid.getTopSegmentIdx() != nullIdx && ProjectUtils::isPointAbove(topSegment, endPoint)){ // Leaves the trapezoid crossing the top edge
+            cg3::Point2d crossingPoint = ProjectUtils::linesIntersection(segment, topSegment);
+            crossedSegments.push_back(trapezoid.getTopSegmentIdx());
+            nextTrapezoid = locateAcrossSegment(crossingPoint, trapezoid.getTopSegmentIdx(), true, segment.p2(), dag, trapezoidalMapData);
+        }else if(trapezoid.getBottomSegmentIdx() != nullIdx && ProjectUtils::isPointBelow(bottomSegment, endPoint)){ // Leaves the trapezoid crossing the bottom edge
+            cg3::Point2d crossingPoint = ProjectUtils::linesIntersection(segment, bottomSegment);
+            crossedSegments.push_back(trapezoid.getBottomSegmentIdx());
+            nextTrapezoid = locateAcrossSegment(crossingPoint, trapezoid.getBottomSegmentIdx(), false, segment.p2(), dag, trapezoidalMapData);
+        }else if(xEnd < segment.p2().x()){ // Leaves the trapezoid through its right side, as in followSegment
+            if(ProjectUtils::isPointAbove(segment, trapezoid.getRightPoint())){
+                nextTrapezoid = trapezoid.getLowerRightNeighbor();
+            }else{
+                nextTrapezoid = trapezoid.getUpperRightNeighbor();
+            }
+        }
+        // The last endpoint lies in the trapezoid (or the walk cannot go on)
+        if(nextTrapezoid == nullIdx || nextTrapezoid == idxTrapezoid) break;
+
+        idxTrapezoid = nextTrapezoid;
+        crossedTrapezoids.push_back(idxTrapezoid);
+    }
+}
+
+/**
+ * @brief Find the trapezoids traversed and the segments crossed by a vertical query segment, walking upward
+ * @param[in] querySeg the vertical query segment, with p1 the lower endpoint
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[out] crossedTrapezoids the indexes of the traversed trapezoids, from the bottom to the top
+ * @param[out] crossedSegments the dataset indexes of the crossed segments, from the bottom to the top
+ * As for the x-nodes, the query lies just to the right of its x. Every step crosses the top segment of the trapezoid and locates the one
+ * just above it, comparing the segments of the y-nodes with the crossed one: the walk is decided exactly, so it always goes upward and
+ * visits one trapezoid per crossed segment. The descent for the point above the crossed segment takes the same path as the last one up to
+ * the y-node of that segment, so it resumes from there instead of starting again from the root.
+*/
+void queryVerticalCrossing(const cg3::Segment2d &querySeg, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                           std::vector<size_t> &crossedTrapezoids, std::vector<size_t> &crossedSegments){
+    size_t nullIdx = std::numeric_limits<size_t>::max();
+    crossedTrapezoids.clear();
+    crossedSegments.clear();
+    assert(querySeg.p1().x() == querySeg.p2().x() && querySeg.p1().y() <= querySeg.p2().y());
+
+    std::vector<size_t> path;
+    PathVisitor visitor(path);
+    size_t idxTrapezoid = traverseDag(dag, trapezoidalMapData, VerticalPointPolicy(querySeg.p1()), visitor);
+    crossedTrapezoids.push_back(idxTrapezoid);
+
+    while(true){
+        size_t topSegmentIdx = trapezoidalMap.getTrapezoid(idxTrapezoid).getTopSegmentIdx();
+        if(topSegmentIdx == nullIdx) break;
+        cg3::Segment2d topSegment = trapezoidalMapData.getSegment(topSegmentIdx);
+        ProjectUtils::orderSegment(topSegment);
+        // The upper endpoint lies in the trapezoid
+        if(!ProjectUtils::isPointAboveRight(topSegment, querySeg.p2())) break;
+        crossedSegments.push_back(topSegmentIdx);
+
+        // Resume from the upper child of the y-node of the crossed segment, or from the root if the path does not contain it
+        size_t startIdx = 0;
+        size_t pathLength = 0;
+        for(size_t i = 0; i < path.size(); i++){
+            const Node &node = dag.getNode(path[i]);
+            if(node.getType() == Node::NodeType::Y && node.getIdx() == topSegmentIdx){
+                startIdx = node.getLeftIdx();
+                pathLength = i + 1;
+                break;
+            }
+        }
+        path.resize(pathLength);
+        idxTrapezoid = traverseDag(dag, trapezoidalMapData, AboveSegmentPolicy(querySeg.p1().x(), topSegmentIdx, topSegment), visitor, startIdx);
+        crossedTrapezoids.push_back(idxTrapezoid);
+    }
+}
+
+/**
+ * @brief Vertical line stabbing query: find the segments crossing the vertical line at a given x
+ * @param[in] x the x coordinate of the vertical line
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return the dataset indexes of the segments crossing the line, ordered from the bottom to the top
+ * The bottom trapezoid is located with the Dag, then the walk goes upward through the chain of trapezoids stacked at x
+ * (the crossing of a vertical segment spanning the bounding box). As for the x-nodes, a segment whose right endpoint has
+ * the given x is not reported, while a segment whose left endpoint has the given x is.
+*/
+std::vector<size_t> stabVertical(double x, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
+    std::vector<size_t> crossedTrapezoids, crossedSegments;
+    cg3::Segment2d verticalLine(cg3::Point2d(x, -BOUNDINGBOX), cg3::Point2d(x, BOUNDINGBOX));
+    queryVerticalCrossing(verticalLine, dag, trapezoidalMap, trapezoidalMapData, crossedTrapezoids, crossedSegments);
+    return crossedSegments;
+}
+
+/**
+ * @brief Compute the x-range in which a trapezoid intersects an axis-aligned window
+ * @param[in] trapezoid the trapezoid
+ * @param[in] window the window
+ * @param[out] xMin the lower limit of the range
+ * @param[out] xMax the upper limit of the range
+ * @return true if the trapezoid intersects the window, false otherwise
+*/
+bool trapezoidWindowRange(const Trapezoid &trapezoid, const cg3::BoundingBox2 &window, double &xMin, double &xMax){
+    xMin = std::max(trapezoid.getLeftPoint().x(), window.min().x());
+    xMax = std::min(trapezoid.getRightPoint().x(), window.max().x());
+    if(xMin > xMax) return false;
+    // The top edge must reach the bottom of the window and the bottom edge must reach its top
+    return ProjectUtils::clipRangeAboveBelow(trapezoid.getTopSegment(), window.min().y(), true, xMin, xMax) &&
+           ProjectUtils::clipRangeAboveBelow(trapezoid.getBottomSegment(), window.max().y(), false, xMin, xMax);
+}
+
+/**
+ * @brief Window query: find the trapezoids and the segments intersecting an axis-aligned rectangle
+ * @param[in] window the query rectangle
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[out] windowTrapezoids the indexes of the trapezoids intersecting the window
+ * @param[out] windowSegments the dataset indexes of the segments intersecting the window
+ * The lower left corner of the window is located with the Dag, then the trapezoids are flood-filled through their neighbor links.
+ * Since the trapezoids have no links through their top and bottom edges, for each segment crossing the window the trapezoid
+ * on its other side is located once at a point of the segment inside the window. The cost depends only on the output size.
+*/
+void queryWindow(const cg3::BoundingBox2 &window, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                 std::vector<size_t> &windowTrapezoids, std::vector<size_t> &windowSegments){
+    size_t nullIdx = std::numeric_limits<size_t>::max();
+    windowTrapezoids.clear();
+    windowSegments.clear();
+
+    std::unordered_set<size_t> visitedTrapezoids;
+    // Segment sides already used to enter the trapezoids on the other side (2 * segment index, +1 for the upper side)
+    std::unordered_set<size_t> crossedSides;
+    std::vector<size_t> toVisit;
+
+    size_t seed = queryPoint(window.min(), dag, trapezoidalMapData);
+    visitedTrapezoids.insert(seed);
+    toVisit.push_back(seed);
+
+    while(!toVisit.empty()){
+        size_t idxTrapezoid = toVisit.back();
+        toVisit.pop_back();
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(idxTrapezoid);
+
+        double xMin, xMax;
+        if(!trapezoidWindowRange(trapezoid, window, xMin, xMax)) continue;
+        windowTrapezoids.push_back(idxTrapezoid);
+
+        // Neighbors to the left and to the right
+        size_t neighbors[4] = {trapezoid.getUpperLeftNeighbor(), trapezoid.getLowerLeftNeighbor(), trapezoid.getUpperRightNeighbor(), trapezoid.getLowerRightNeighbor()};
+        for(size_t neighbor : neighbors){
+            if(neighbor != nullIdx && visitedTrapezoids.insert(neighbor).second) toVisit.push_back(neighbor);
+        }
+
+        // Trapezoids on the other side of the top and bottom edges
+        for(int side = 0; side < 2; side++){
+            bool top = side == 0;
+            size_t segmentIdx = top ? trapezoid.getTopSegmentIdx() : trapezoid.getBottomSegmentIdx();
+            if(segmentIdx == nullIdx) continue;
+
+            // Part of the edge inside the window
+            cg3::Segment2d segment = top ? trapezoid.getTopSegment() : trapezoid.getBottomSegment();
+            ProjectUtils::orderSegment(segment);
+            double segXMin = std::max(xMin, segment.p1().x()), segXMax = std::min(xMax, segment.p2().x());
+            if(segXMin > segXMax ||
+               !ProjectUtils::clipRangeAboveBelow(segment, window.min().y(), true, segXMin, segXMax) ||
+               !ProjectUtils::clipRangeAboveBelow(segment, window.max().y(), false, segXMin, segXMax)) continue;
+
+            // The top edge is crossed upward, the bottom edge downward
+            if(!crossedSides.insert(2 * segmentIdx + (top ? 1 : 0)).second) continue;
+            if(!crossedSides.count(2 * segmentIdx + (top ? 0 : 1))) windowSegments.push_back(segmentIdx);
+
+            double x = (segXMin + segXMax) / 2;
+            cg3::Point2d crossingPoint(x, ProjectUtils::segmentYAt(segment, x));
+            size_t other = locateAcrossSegment(crossingPoint, segmentIdx, top, crossingPoint, dag, trapezoidalMapData);
+            if(visitedTrapezoids.insert(other).second) toVisit.push_back(other);
+        }
+    }
 }
 
 /**
@@ -132,7 +380,7 @@ std::vector<size_t> followSegment(const cg3::Segment2d &segment, const Dag &dag,
  * @param[in] trapezoidalMap The trapezoidal Map data structure
  * Initializes the structures with the first trapezoid that is represented by the bounding box
  */
-void initializeStructures(Dag &dag, DrawableTrapezoidalMap &trapezoidalMap){
+void initializeStructures(Dag &dag, TrapezoidalMap &trapezoidalMap){
     // The trapezoidal map for the empty set consist of a single trapezoid, which is the bounding rectangle.
     cg3::Segment2d topSegment = cg3::Segment2d(cg3::Point2d(-BOUNDINGBOX, BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX));
     cg3::Segment2d bottomSegment = cg3::Segment2d(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, -BOUNDINGBOX));
@@ -151,18 +399,46 @@ void initializeStructures(Dag &dag, DrawableTrapezoidalMap &trapezoidalMap){
     dag.addNode(boundingBoxNode);
 }
 
+/**
+ * @brief Reserve the storage of the Trapezoidal Map and of the DAG for a number of segments
+ * @param[in] expectedSegments the number of segments that will be inserted
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * The map of n segments has at most 3n+1 trapezoids. The size of the Dag depends on the insertion order, it is reserved for 10n+1
+ * nodes, a bit more than its size for a random order (if it grows beyond, it allocates new chunks as usual, the nodes never move).
+ * The storage is allocated here, so the insertions within the reserved size do not allocate.
+ */
+void reserveStructures(size_t expectedSegments, Dag &dag, TrapezoidalMap &trapezoidalMap){
+    trapezoidalMap.reserve(3 * expectedSegments + 1);
+    dag.reserve(10 * expectedSegments + 1);
+}
+
+/**
+ * @brief Incremental building algorithm for Trapezoidal Map and the DAG structures
+ * @param[in] segment the segment added to the trapezoidal map
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * Insert the segment with new scratch buffers (see the version with the build context)
+ */
+void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData){
+    BuildContext context;
+    buildTrapezoidalMap(segment, dag, trapezoidalMap, trapezoidalMapData, context);
+}
+
 /**
  * @brief Incremental building algorithm for Trapezoidal Map and the DAG structures
  * @param[in] segment the segment added to the trapezoidal map
  * @param[in] dag The DAG search structure
  * @param[in] trapezoidalMap The trapezoidal Map data structure
  * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * @param[in] context the scratch buffers of the insertions (with the same context, and the structures reserved with
+ * reserveStructures, an insertion does not allocate)
  * First compute the intersection by calling the function followSegment, then if the number of intersection is 1 call the function oneIntersectedTrapezoid
  * if more trapezoid are intersected then call the moreIntersectedTrapezoids function.
  *
  */
-void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData){
-    trapezoidalMap.setHighlightedTrap(std::numeric_limits<size_t>::max()); // Setting no one highlighted trapezoid
+void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, BuildContext &context){
     // Before adding a segment is necessary to: Determine a bounding box R that contains all segments of S, and initialize the trapezoidal map structure T and search structure D for it.
     // Ordering the segment for ensuring that the second point (p2) is the right endpoint of the segment
     cg3::Segment2d orderedSegment = segment;
@@ -172,31 +448,122 @@ void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, DrawableTrapez
     }
 
     // Get the intersected trapezoids with the function followSegment
-    std::vector<size_t> intersectedTrapezoids = followSegment(orderedSegment, dag, trapezoidalMap, trapezoidalMapData);
+    std::vector<size_t> &intersectedTrapezoids = context.intersectedTrapezoids;
+    followSegment(orderedSegment, dag, trapezoidalMap, trapezoidalMapData, intersectedTrapezoids);
     assert(intersectedTrapezoids.size() >= 1);
 
+    // Indexes of the segment and of its endpoints in the dataset
+    SegmentIndexes indexes;
+    bool found = false;
+    indexes.segmentIdx = trapezoidalMapData.findSegment(orderedSegment, found);
+    assert(found == true);
+    indexes.leftPointIdx = trapezoidalMapData.findPoint(orderedSegment.p1(), found);
+    assert(found == true);
+    indexes.rightPointIdx = trapezoidalMapData.findPoint(orderedSegment.p2(), found);
+    assert(found == true);
+
+    // Save what the insertion overwrites, to undo it
+    if(context.journal != nullptr) recordInsertion(indexes.segmentIdx, intersectedTrapezoids, dag, trapezoidalMap, *context.journal);
+
+    // The new trapezoids and nodes are added at the end of the structures
+    InsertionSlots slots = {trapezoidalMap.numTrapezoids(), dag.numNodes()};
+    insertSegment(orderedSegment, indexes, intersectedTrapezoids, slots, dag, trapezoidalMap);
+}
+
+/**
+ * @brief Update the structures with a segment, given the trapezoids it intersects
+ * @param[in] segment the inserted segment, with p1 as left endpoint
+ * @param[in] indexes the dataset indexes of the segment and of its endpoints (the null index for an open end: the inserted part of the
+ * segment ends on the edge of the first or last intersected trapezoid, without an x-node)
+ * @param[in] intersectedTrapezoids the trapezoids intersected by the segment (see followSegment)
+ * @param[in] slots the indexes of the new trapezoids and nodes, updated with the ones used
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * The update does not use the dataset, so it works on every copy of the structures.
+ */
+void insertSegment(const cg3::Segment2d &segment, const SegmentIndexes &indexes, const std::vector<size_t> &intersectedTrapezoids, InsertionSlots &slots,
+                   Dag &dag, TrapezoidalMap &trapezoidalMap){
     // Split in two case to handle - the segment intersect only one trapezoid and the segment intersect more trapezoid
     // Only one trapezoid intersected
     if(intersectedTrapezoids.size() == 1){
         // In this case the trapezoid will be replaced with at most 4 trapezoid. Is possible that there is no left or right trapezoid
         size_t intersectedTrapIdx = intersectedTrapezoids[0];
-        oneIntersectedTrapezoid(orderedSegment, intersectedTrapIdx, dag, trapezoidalMap, trapezoidalMapData);
+        oneIntersectedTrapezoid(segment, intersectedTrapIdx, indexes, slots, dag, trapezoidalMap);
     }else{ // If more trapezoids are intersected by the segment
-        moreIntersectedTrapezoids(orderedSegment, intersectedTrapezoids, dag, trapezoidalMap, trapezoidalMapData);
+        moreIntersectedTrapezoids(segment, intersectedTrapezoids, indexes, slots, dag, trapezoidalMap);
+    }
+}
+
+/**
+ * @brief Record in the journal the state of the structures overwritten by an insertion
+ * @param[in] segmentIdx the dataset index of the inserted segment
+ * @param[in] intersectedTrapezoids the trapezoids intersected by the inserted segment
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] journal the journal of the insertions
+ * The insertion rewrites only the intersected trapezoids, the neighbor indexes of their neighbors and the leaves of the intersected
+ * trapezoids, the other trapezoids and nodes are appended.
+ */
+void recordInsertion(size_t segmentIdx, const std::vector<size_t> &intersectedTrapezoids, const Dag &dag, const TrapezoidalMap &trapezoidalMap, InsertionJournal &journal){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    journal.beginInsertion(segmentIdx, dag, trapezoidalMap);
+    for(size_t trapezoidIdx : intersectedTrapezoids){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        journal.saveTrapezoid(trapezoidIdx, trapezoid);
+        journal.saveNode(trapezoid.getNodeIdx(), dag.getNode(trapezoid.getNodeIdx()));
+        size_t neighbors[4] = {trapezoid.getUpperLeftNeighbor(), trapezoid.getLowerLeftNeighbor(), trapezoid.getUpperRightNeighbor(), trapezoid.getLowerRightNeighbor()};
+        for(size_t neighborIdx : neighbors){
+            if(neighborIdx != nullIdx) journal.saveTrapezoid(neighborIdx, trapezoidalMap.getTrapezoid(neighborIdx));
+        }
+    }
+}
+
+/**
+ * @brief Store a trapezoid created by an insertion at its index
+ * @param[in] trapezoid the trapezoid
+ * @param[in] idx the index of the trapezoid (an intersected trapezoid, or a new one)
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] slots the next free indexes of the insertion
+ * A new trapezoid is added at the end of the map, unless its index was already allocated (the parallel insertion allocates all the
+ * new trapezoids of a round before the insertions)
+ */
+void placeTrapezoid(Trapezoid &trapezoid, size_t idx, TrapezoidalMap &trapezoidalMap, InsertionSlots &slots){
+    if(!trapezoidalMap.replaceTrapezoid(trapezoid, idx)){
+        assert(idx == trapezoidalMap.numTrapezoids());
+        trapezoidalMap.addTrapezoid(trapezoid);
+    }
+    if(idx >= slots.nextTrapezoid) slots.nextTrapezoid = idx + 1;
+}
+
+/**
+ * @brief Store a node created by an insertion at its index
+ * @param[in] node the node
+ * @param[in] idx the index of the node (the leaf of an intersected trapezoid, or a new one)
+ * @param[in] dag The DAG search structure
+ * @param[in] slots the next free indexes of the insertion
+ */
+void placeNode(Node &node, size_t idx, Dag &dag, InsertionSlots &slots){
+    if(idx < dag.numNodes()){
+        dag.replaceNode(node, idx);
+    }else{
+        assert(idx == dag.numNodes());
+        dag.addNode(node);
     }
+    if(idx >= slots.nextNode) slots.nextNode = idx + 1;
 }
 
 /**
  * @brief Update the structures (trapezoidal map and dag) when the inserted segment intersect only one trapezoid.
  * @param[in] segment the inserted segment
  * @param[in] intersectedTrapIdx the index of the intersected trapezoid
+ * @param[in] indexes the dataset indexes of the segment and of its endpoints (stored in the new nodes)
+ * @param[in] slots the indexes of the new trapezoids and nodes, updated with the ones used
  * @param[in] dag The DAG search structure
  * @param[in] trapezoidalMap The trapezoidal Map data structure
- * @param[in] trapezoidalMapData the trapezoidal map dataset structure
  * Compute the trapezoidal map after the insertion of a segment that intersect only one trapezoid.
  * The insertion can create at least 2 new trapezoid (top and bottom) and at most 4 trapezoids (Top, bottom, left and right).
  */
-void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTrapIdx, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData){
+void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTrapIdx, const SegmentIndexes &indexes, InsertionSlots &slots, Dag &dag, TrapezoidalMap &trapezoidalMap){
 
     // Utility - use the max value of size_t as arbitrary index for a null index
     size_t nullIdx = std::numeric_limits<size_t>::max();
@@ -204,12 +571,19 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
     // Copy of the intersected trapezoid
     Trapezoid intersectedTrapCopy = trapezoidalMap.getTrapezoid(intersectedTrapIdx);
 
+    // Index of the inserted segment in the dataset (stored in the y-node and in the new trapezoids)
+    size_t segmentIdx = indexes.segmentIdx;
+
+    // Ends of the inserted part: an open end (null point index) lies beyond the part inserted in a slab, on the edge of the trapezoid
+    const cg3::Point2d leftEnd = indexes.leftPointIdx == nullIdx ? intersectedTrapCopy.getLeftPoint() : segment.p1();
+    const cg3::Point2d rightEnd = indexes.rightPointIdx == nullIdx ? intersectedTrapCopy.getRightPoint() : segment.p2();
+
     // Checking if left and right trapezoid exist
-    bool leftTrapezoidExists = segment.p1() != intersectedTrapCopy.getLeftPoint();   // If the leftPoint of the trapezoid is equal to the left endpoint of the segment the left trapezoid not exist
-    bool rightTrapezoidExists = segment.p2() != intersectedTrapCopy.getRightPoint(); // Same with rightPoint and right endpoint of the segment for the right trapezoid
+    bool leftTrapezoidExists = leftEnd != intersectedTrapCopy.getLeftPoint();   // If the leftPoint of the trapezoid is equal to the left endpoint of the segment the left trapezoid not exist
+    bool rightTrapezoidExists = rightEnd != intersectedTrapCopy.getRightPoint(); // Same with rightPoint and right endpoint of the segment for the right trapezoid
 
     // Setting IDX of new trapezoids
-    size_t newIdx = trapezoidalMap.numTrapezoids();  // new index - after the last trapezoid in vector
+    size_t newIdx = slots.nextTrapezoid;  // new index - after the last trapezoid in vector
     size_t topTrapezoidIdx = intersectedTrapIdx;  // Taking the idx of the intersected trapezoid
     size_t bottomTrapezoidIdx = newIdx++;  // Taking the idx next to the last trapezoid in the vector
     // left and right Trapezoid may not exist so the index is given after checking if they exist
@@ -225,18 +599,18 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
 
     if(leftTrapezoidExists){// the first x-node only if left trapezoid exist
         xNodeLeft = newIdx;
-        newIdx = dag.numNodes(); // Taking the index next to the last node in the vector
+        newIdx = slots.nextNode; // Taking the index next to the last node in the vector
         leafTrapLeft = newIdx++;
     }
     if(rightTrapezoidExists){        // The second x-node only if the right trapezoid exist
         xNodeRight = !leftTrapezoidExists ? newIdx : newIdx++;
-        if(!leftTrapezoidExists) newIdx = dag.numNodes();
+        if(!leftTrapezoidExists) newIdx = slots.nextNode;
         leafTrapRight = newIdx++;
     }
     // Y-node
     size_t yNode = leftTrapezoidExists || rightTrapezoidExists ? newIdx++ : newIdx;
     // If left and righ trap not exist need to take the index next to the last node in the vector
-    if( !(leftTrapezoidExists || rightTrapezoidExists) ) newIdx = dag.numNodes();
+    if( !(leftTrapezoidExists || rightTrapezoidExists) ) newIdx = slots.nextNode;
     // Top and Bottom Trap
     size_t topTrapLeaf = newIdx++;
     size_t bottomTrapLeaf = newIdx;
@@ -262,7 +636,7 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
     // --------------UPDATING THE TRAPEZOIDAL MAP------------------
     // TOP TRAPEZOID
 
-    Trapezoid topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, segment.p1(), segment.p2());
+    Trapezoid topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, leftEnd, rightEnd);
     if(leftTrapezoidExists) topTrapezoid.setUpperLeftNeighbor(leftTrapezoidIdx);
     else if (! ProjectUtils::leftPointEqualTopLeftEndpoint(intersectedTrapCopy)) topTrapezoid.setUpperLeftNeighbor(intersectedTrapCopy.getUpperLeftNeighbor());
     else topTrapezoid.setUpperLeftNeighbor(nullIdx);
@@ -273,13 +647,16 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
     // - No lower Neighbor
     topTrapezoid.setLowerLeftNeighbor(nullIdx);
     topTrapezoid.setLowerRightNeighbor(nullIdx);
+    // Dataset indexes of the edges
+    topTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+    topTrapezoid.setBottomSegmentIdx(segmentIdx);
     // Dag leaf idx
     topTrapezoid.setNodeIdx(topTrapLeaf);
     // Add to the trapezoidal map in place of the intesected trapezoid
     trapezoidalMap.replaceTrapezoid(topTrapezoid, topTrapezoidIdx);
 
     // BOTTOM TRAPEZOID
-    Trapezoid bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), segment.p1(), segment.p2());
+    Trapezoid bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), leftEnd, rightEnd);
     // - No upper Neighbor
     bottomTrapezoid.setUpperLeftNeighbor(nullIdx);
     bottomTrapezoid.setUpperRightNeigbor(nullIdx);
@@ -291,31 +668,37 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
     if(rightTrapezoidExists) bottomTrapezoid.setLowerRightNeighbor(rightTrapezoidIdx);
     else if(!ProjectUtils::rightPointEqualBottomRightEndpoint(intersectedTrapCopy)) bottomTrapezoid.setLowerRightNeighbor(intersectedTrapCopy.getLowerRightNeighbor());
     else bottomTrapezoid.setLowerRightNeighbor(nullIdx);
+    bottomTrapezoid.setTopSegmentIdx(segmentIdx);
+    bottomTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
     bottomTrapezoid.setNodeIdx(bottomTrapLeaf);
-    trapezoidalMap.addTrapezoid(bottomTrapezoid);
+    placeTrapezoid(bottomTrapezoid, bottomTrapezoidIdx, trapezoidalMap, slots);
 
     // LEFT TRAPEZOID
     if(leftTrapezoidExists){
         Trapezoid leftTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), intersectedTrapCopy.getBottomSegment(),
-                                            intersectedTrapCopy.getLeftPoint(), segment.p1());
+                                            intersectedTrapCopy.getLeftPoint(), leftEnd);
         leftTrapezoid.setUpperLeftNeighbor(intersectedTrapCopy.getUpperLeftNeighbor());
         leftTrapezoid.setUpperRightNeigbor(topTrapezoidIdx);
         leftTrapezoid.setLowerLeftNeighbor(intersectedTrapCopy.getLowerLeftNeighbor());
         leftTrapezoid.setLowerRightNeighbor(bottomTrapezoidIdx);
+        leftTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+        leftTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
         leftTrapezoid.setNodeIdx(leafTrapLeft); // Dag leaf index
-        trapezoidalMap.addTrapezoid(leftTrapezoid);
+        placeTrapezoid(leftTrapezoid, leftTrapezoidIdx, trapezoidalMap, slots);
     }
 
     // RIGHT TRAPEZOID
     if(rightTrapezoidExists){
         Trapezoid rightTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), intersectedTrapCopy.getBottomSegment(),
-                                             segment.p2(), intersectedTrapCopy.getRightPoint());
+                                             rightEnd, intersectedTrapCopy.getRightPoint());
         rightTrapezoid.setUpperLeftNeighbor(topTrapezoidIdx);
         rightTrapezoid.setUpperRightNeigbor(intersectedTrapCopy.getUpperRightNeighbor());
         rightTrapezoid.setLowerLeftNeighbor(bottomTrapezoidIdx);
         rightTrapezoid.setLowerRightNeighbor(intersectedTrapCopy.getLowerRightNeighbor());
+        rightTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+        rightTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
         rightTrapezoid.setNodeIdx(leafTrapRight);
-        trapezoidalMap.addTrapezoid(rightTrapezoid);
+        placeTrapezoid(rightTrapezoid, rightTrapezoidIdx, trapezoidalMap, slots);
     }
 
     // -------------------- UPDATE THE DAG ------------------------------
@@ -328,74 +711,68 @@ void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTr
 
     // Updating the dag
     if(leftTrapezoidExists){
-        bool found = false;
-        size_t pointIdx = trapezoidalMapData.findPoint(segment.p1(), found);
-        assert(found == true);
         // X node
-        Node newNode = Node(Node::NodeType::X, pointIdx, leafTrapLeft, rightTrapezoidExists ? xNodeRight : yNode);
+        Node newNode = Node(Node::NodeType::X, indexes.leftPointIdx, leafTrapLeft, rightTrapezoidExists ? xNodeRight : yNode);
         dag.replaceNode(newNode, xNodeLeft);
         // Left trapezoid leaf
         newNode = Node(Node::NodeType::LEAF, leftTrapezoidIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, leafTrapLeft, dag, slots);
     }
 
     if(rightTrapezoidExists){
-        bool found = false;
-        size_t pointIdx = trapezoidalMapData.findPoint(segment.p2(), found);
-        assert(found == true);
         // X node
-        Node newNode = Node(Node::NodeType::X, pointIdx, yNode, leafTrapRight);
-        if(leftTrapezoidExists) dag.addNode(newNode);
-        else dag.replaceNode(newNode, xNodeRight);
+        Node newNode = Node(Node::NodeType::X, indexes.rightPointIdx, yNode, leafTrapRight);
+        placeNode(newNode, xNodeRight, dag, slots);
         // Right trapezoid Leaf
         newNode = Node(Node::NodeType::LEAF, rightTrapezoidIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, leafTrapRight, dag, slots);
     }
 
     // Y node
-    bool found = false;
-    size_t segmentIdx = trapezoidalMapData.findSegment(segment, found); // SE NON FUNZIONA RIMETTERE SEMGMENT INVECE DI ORDERED SEGMENT
-    assert(found == true);
-
     Node newNode = Node(Node::NodeType::Y, segmentIdx, topTrapLeaf, bottomTrapLeaf);
-    if(leftTrapezoidExists || rightTrapezoidExists) dag.addNode(newNode);
-    else dag.replaceNode(newNode, yNode);
+    placeNode(newNode, yNode, dag, slots);
 
     // Top trapezoid Leaf
     newNode = Node(Node::NodeType::LEAF, topTrapezoidIdx, nullIdx, nullIdx);
-    dag.addNode(newNode);
+    placeNode(newNode, topTrapLeaf, dag, slots);
 
     // Bottom trapezoid Leaf
     newNode = Node(Node::NodeType::LEAF, bottomTrapezoidIdx, nullIdx, nullIdx);
-    dag.addNode(newNode);
+    placeNode(newNode, bottomTrapLeaf, dag, slots);
 }
 
 /**
  * @brief Update the structures (trapezoidal map and dag) when the inserted segment intersect more than one trapezoid.
  * @param[in] segment the inserted segment
  * @param[in] intersectedTraps the indexes of the intersected trapezoids
+ * @param[in] indexes the dataset indexes of the segment and of its endpoints (stored in the new nodes)
+ * @param[in] slots the indexes of the new trapezoids and nodes, updated with the ones used
  * @param[in] dag The DAG search structure
  * @param[in] trapezoidalMap The trapezoidal Map data structure
- * @param[in] trapezoidalMapData the trapezoidal map dataset structure
  * Compute the trapezoidal map after the insertion of a segment that intersect more than one trapezoid.
  * The insertion can create several new trapezoids. The algorithm steps are divided in 3 macro steps: First trapezoid intersected, internal trapezoids intersected and last trapezoid intersected.
  */
-void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t> intersectedTraps, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData){
+void moreIntersectedTrapezoids(const cg3::Segment2d &segment, const std::vector<size_t> &intersectedTraps, const SegmentIndexes &indexes, InsertionSlots &slots, Dag &dag, TrapezoidalMap &trapezoidalMap){
     // Utility - use the max value of size_t as arbitrary index for a null index
     size_t nullIdx = std::numeric_limits<size_t>::max();
 
     // Index and copy of the current analyzed trapezoid
     size_t intersectedTrapIdx = intersectedTraps.front(); // Take the first element
     Trapezoid intersectedTrapCopy = trapezoidalMap.getTrapezoid(intersectedTrapIdx);
+    // Index of the inserted segment in the dataset (stored in the y-nodes and in the new trapezoids)
+    size_t segmentIdx = indexes.segmentIdx;
+    // Ends of the inserted part: an open end (null point index) lies beyond the part inserted in a slab, on the edge of the first (last) trapezoid
+    const cg3::Point2d leftEnd = indexes.leftPointIdx == nullIdx ? intersectedTrapCopy.getLeftPoint() : segment.p1();
+    const cg3::Point2d rightEnd = indexes.rightPointIdx == nullIdx ? trapezoidalMap.getTrapezoid(intersectedTraps.back()).getRightPoint() : segment.p2();
     // Checking if left and right trapezoid exist
-    bool leftTrapezoidExists = segment.p1() != intersectedTrapCopy.getLeftPoint();   // If the leftPoint of the trapezoid is equal to the left endpoint of the segment the left trapezoid not exist
-    bool rightTrapezoidExists = segment.p2() != trapezoidalMap.getTrapezoid(intersectedTraps.back()).getRightPoint();
+    bool leftTrapezoidExists = leftEnd != intersectedTrapCopy.getLeftPoint();   // If the leftPoint of the trapezoid is equal to the left endpoint of the segment the left trapezoid not exist
+    bool rightTrapezoidExists = rightEnd != trapezoidalMap.getTrapezoid(intersectedTraps.back()).getRightPoint();
 
     // ------------------------------- Leftmost Trapezoid intersected ---------------------------------------------
     // Creation, if exist, of the leftmost trapezoid and initialization of a top and bottom trapezoid that can extend in the next intersected trapezoids
 
     // - Setting Indexes of new trapezoids
-    size_t newIdx = trapezoidalMap.numTrapezoids();
+    size_t newIdx = slots.nextTrapezoid;
     size_t topTrapezoidIdx = intersectedTrapIdx;  // Taking the idx of the intersected trapezoid
     // left Trapezoid may not exist so the index is given after checking if they exist
     size_t leftTrapezoidIdx = leftTrapezoidExists ? newIdx++ : nullIdx;
@@ -408,12 +785,12 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
 
     if(leftTrapezoidExists){// x-node and left trap leaf only if left trapezoid exist
         xNodeLeft = newIdx;
-        newIdx = dag.numNodes();
+        newIdx = slots.nextNode;
         leafTrapLeft = newIdx++;
     }
     size_t yNode = leftTrapezoidExists ? newIdx++ : newIdx;
     // If left trap not exist need to take the index next to the last node in the vector
-    if( !leftTrapezoidExists ) newIdx = dag.numNodes();
+    if( !leftTrapezoidExists ) newIdx = slots.nextNode;
     // Top and Bottom Trap leaf
     size_t topTrapLeaf = newIdx++;
     size_t bottomTrapLeaf = newIdx;
@@ -432,17 +809,19 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
     // LEFT trapezoid if exists
     if(leftTrapezoidExists){
         Trapezoid leftTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), intersectedTrapCopy.getBottomSegment(),
-                                            intersectedTrapCopy.getLeftPoint(), segment.p1());
+                                            intersectedTrapCopy.getLeftPoint(), leftEnd);
         leftTrapezoid.setUpperLeftNeighbor(intersectedTrapCopy.getUpperLeftNeighbor());
         leftTrapezoid.setUpperRightNeigbor(topTrapezoidIdx);
         leftTrapezoid.setLowerLeftNeighbor(intersectedTrapCopy.getLowerLeftNeighbor());
         leftTrapezoid.setLowerRightNeighbor(bottomTrapezoidIdx);
+        leftTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+        leftTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
         // Dag leaf idx
         leftTrapezoid.setNodeIdx(leafTrapLeft);
-        trapezoidalMap.addTrapezoid(leftTrapezoid);
+        placeTrapezoid(leftTrapezoid, leftTrapezoidIdx, trapezoidalMap, slots);
     }
     // TOP TRAPEZOID (it will be inserted while checking the next trapezoids)
-    Trapezoid topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, segment.p1(), cg3::Point2d(0,0)); // Unknown right point update later
+    Trapezoid topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, leftEnd, cg3::Point2d(0,0)); // Unknown right point update later
     // Setting its neighbors
     if(leftTrapezoidExists) topTrapezoid.setUpperLeftNeighbor(leftTrapezoidIdx);
     else if (!ProjectUtils::leftPointEqualTopLeftEndpoint(intersectedTrapCopy)) topTrapezoid.setUpperLeftNeighbor(intersectedTrapCopy.getUpperLeftNeighbor());
@@ -450,10 +829,12 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
     topTrapezoid.setUpperRightNeigbor(nullIdx);
     topTrapezoid.setLowerLeftNeighbor(nullIdx);
     topTrapezoid.setLowerRightNeighbor(nullIdx);
+    topTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+    topTrapezoid.setBottomSegmentIdx(segmentIdx);
     topTrapezoid.setNodeIdx(topTrapLeaf);
 
     // BOTTOM TRAPEZOID
-    Trapezoid bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), segment.p1(), cg3::Point2d(0,0)); // Unknown right point update later
+    Trapezoid bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), leftEnd, cg3::Point2d(0,0)); // Unknown right point update later
     // Setting its neighbors (they will be updated in the future iterations)
     bottomTrapezoid.setUpperLeftNeighbor(nullIdx);
     bottomTrapezoid.setUpperRightNeigbor(nullIdx);
@@ -461,35 +842,30 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
     if(leftTrapezoidExists) bottomTrapezoid.setLowerLeftNeighbor(leftTrapezoidIdx);
     else if(!ProjectUtils::leftPointEqualBottomLeftEndpoint(intersectedTrapCopy)) bottomTrapezoid.setLowerLeftNeighbor(intersectedTrapCopy.getLowerLeftNeighbor());
     else bottomTrapezoid.setLowerLeftNeighbor(nullIdx);
+    bottomTrapezoid.setTopSegmentIdx(segmentIdx);
+    bottomTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
     bottomTrapezoid.setNodeIdx(bottomTrapLeaf);    // Dag leaf idx
 
     // -------------------- UPDATE THE DAG ---------------------------
 
     // Create the substree of the dag
     if(leftTrapezoidExists){
-        bool found = false;
-        size_t pointIdx = trapezoidalMapData.findPoint(segment.p1(), found);
-        assert(found == true);
         // x-node
-        Node newNode = Node(Node::NodeType::X, pointIdx, leafTrapLeft, yNode);
+        Node newNode = Node(Node::NodeType::X, indexes.leftPointIdx, leafTrapLeft, yNode);
         dag.replaceNode(newNode, xNodeLeft);
         // trap leaf
         newNode = Node(Node::NodeType::LEAF, leftTrapezoidIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, leafTrapLeft, dag, slots);
     }
-    bool found = false;
-    size_t segmentIdx = trapezoidalMapData.findSegment(segment, found);
-    assert(found == true);
     // Y node
     Node newNode = Node(Node::NodeType::Y, segmentIdx, topTrapLeaf, bottomTrapLeaf);
-    if(leftTrapezoidExists) dag.addNode(newNode);
-    else dag.replaceNode(newNode, yNode);
+    placeNode(newNode, yNode, dag, slots);
     // Top trapezoid leaf
     newNode = Node(Node::NodeType::LEAF, topTrapezoidIdx, nullIdx, nullIdx);
-    dag.addNode(newNode);
+    placeNode(newNode, topTrapLeaf, dag, slots);
     // Bottom trapezoid leaf
     newNode = Node(Node::NodeType::LEAF, bottomTrapezoidIdx, nullIdx, nullIdx);
-    dag.addNode(newNode);
+    placeNode(newNode, bottomTrapLeaf, dag, slots);
 
 
     // ------------------------------- Internal Trapezoid intersected ---------------------------------------------
@@ -519,7 +895,7 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
         intersectedTrapCopy = trapezoidalMap.getTrapezoid(intersectedTrapIdx);
 
         // Right point above segment (if true the top trapezoid found its end, if false the bottom trapezoid found its end)
-        bool topTrapEnds = cg3::isPointAtLeft(segment, prevIntersectedTrapezoid.getRightPoint());
+        bool topTrapEnds = ProjectUtils::isPointAbove(segment, prevIntersectedTrapezoid.getRightPoint());
 
         // Index for the DAG nodes (one y-node and top and bottom trapezoid leaves)
         yNode = intersectedTrapCopy.getNodeIdx();
@@ -538,14 +914,14 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
 
         if(topTrapEnds){ // Previous top trapezoid will be updated and added to the trapezoidal map, a new top trapezoid will be created.
             topTrapezoidIdx = intersectedTrapIdx;
-            topTrapLeaf = dag.numNodes(); // Idx of the new top trapezoid
+            topTrapLeaf = slots.nextNode; // Idx of the new top trapezoid
 
             // Previously created top trapezoid update and added to the trapezoidal map
             topTrapezoid.setLowerRightNeighbor(intersectedTrapIdx);    // The new top trap became the lower right neighbor of the previous
             topTrapezoid.setUpperRightNeigbor(prevIntersectedTrapezoid.getUpperRightNeighbor());
             topTrapezoid.setRightPoint(intersectedTrapCopy.getLeftPoint());
             // If is not possible to replace (its index is greater than the dimension of the trapezoidalmap) than add to the end of the trapezoidal map
-            if(!trapezoidalMap.replaceTrapezoid(topTrapezoid, previousTopTrapIdx)) trapezoidalMap.addTrapezoid(topTrapezoid);
+            placeTrapezoid(topTrapezoid, previousTopTrapIdx, trapezoidalMap, slots);
 
             // New top trapezoid initialize
             topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, intersectedTrapCopy.getLeftPoint(), intersectedTrapCopy.getRightPoint());
@@ -554,6 +930,8 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
             // Right neighbors will be computed in the future iterations
             topTrapezoid.setUpperRightNeigbor(nullIdx);
             topTrapezoid.setLowerRightNeighbor(nullIdx);
+            topTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+            topTrapezoid.setBottomSegmentIdx(segmentIdx);
             topTrapezoid.setNodeIdx(topTrapLeaf);
 
             previousTopTrapIdx = intersectedTrapIdx; // Updating the previous top trapezoid index with the newly created
@@ -561,13 +939,13 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
 
         }else{  // Previous bottom trapezoid will be updated and added to the trapezidal map, a new botom trapezoid will be created.
             bottomTrapezoidIdx = intersectedTrapIdx;
-            bottomTrapLeaf = dag.numNodes();// Dag index for the new bottom trapezoid
+            bottomTrapLeaf = slots.nextNode;// Dag index for the new bottom trapezoid
 
             // Previously created bottom trapezoid update and added to the trapezoidal map
             bottomTrapezoid.setLowerRightNeighbor(prevIntersectedTrapezoid.getLowerRightNeighbor());
             bottomTrapezoid.setUpperRightNeigbor(intersectedTrapIdx);
             bottomTrapezoid.setRightPoint(intersectedTrapCopy.getLeftPoint());
-            if(!trapezoidalMap.replaceTrapezoid(bottomTrapezoid, previousBottomTrapIdx)) trapezoidalMap.addTrapezoid(bottomTrapezoid);
+            placeTrapezoid(bottomTrapezoid, previousBottomTrapIdx, trapezoidalMap, slots);
 
             // New bottom trapezoid initialize
             bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), intersectedTrapCopy.getLeftPoint(), intersectedTrapCopy.getRightPoint());
@@ -576,6 +954,8 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
             // Right neighbors will be computed in the future iterations
             bottomTrapezoid.setUpperRightNeigbor(nullIdx);
             bottomTrapezoid.setLowerRightNeighbor(nullIdx);
+            bottomTrapezoid.setTopSegmentIdx(segmentIdx);
+            bottomTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
             bottomTrapezoid.setNodeIdx(bottomTrapLeaf);
 
             previousBottomTrapIdx = intersectedTrapIdx; // Updating the previous bottom trapezoid index
@@ -587,7 +967,7 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
             dag.replaceNode(newNode, yNode);
             // Ended trapezoid added (it can be top or bottom trap)
             newNode = Node(Node::NodeType::LEAF, intersectedTrapIdx, nullIdx, nullIdx);
-            dag.addNode(newNode);
+            placeNode(newNode, topTrapEnds ? topTrapLeaf : bottomTrapLeaf, dag, slots);
 
             // Updating the previous intersected trapezoid with the one just analyzed
             prevIntersectedTrapezoid = intersectedTrapCopy;
@@ -598,7 +978,7 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
     intersectedTrapCopy = trapezoidalMap.getTrapezoid(intersectedTrapIdx);
 
     // Right point above segment (if true the top trapezoid found its end, if false the bottom trapezoid found its end)
-    bool topTrapEnds = cg3::isPointAtLeft(segment, prevIntersectedTrapezoid.getRightPoint());
+    bool topTrapEnds = ProjectUtils::isPointAbove(segment, prevIntersectedTrapezoid.getRightPoint());
     size_t rightTrapezoidIdx = nullIdx; // will be updated when added in the trapezoidal map if the right trapezoid exists
     // Dag indexes
     newIdx = intersectedTrapCopy.getNodeIdx();
@@ -607,12 +987,12 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
 
     if(rightTrapezoidExists){   // If right trapezoid exists setting the index of its leaf and of the right x node
         xNodeRight = newIdx;
-        newIdx = dag.numNodes();
+        newIdx = slots.nextNode;
         leafTrapRight = newIdx++;
     }
     // Y node index
     yNode = rightTrapezoidExists ? newIdx++ : newIdx;
-    if(!rightTrapezoidExists) newIdx = dag.numNodes();
+    if(!rightTrapezoidExists) newIdx = slots.nextNode;
 
     // Update the neighbors of the right neighbor trapezoids
     if(prevIntersectedTrapezoid.getUpperRightNeighbor() != nullIdx){
@@ -633,19 +1013,19 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
         topTrapezoid.setRightPoint(intersectedTrapCopy.getLeftPoint());
         topTrapezoid.setUpperRightNeigbor(prevIntersectedTrapezoid.getUpperRightNeighbor());
         topTrapezoid.setLowerRightNeighbor(topTrapezoidIdx);
-        if(!trapezoidalMap.replaceTrapezoid(topTrapezoid, previousTopTrapIdx)) trapezoidalMap.addTrapezoid(topTrapezoid);
+        placeTrapezoid(topTrapezoid, previousTopTrapIdx, trapezoidalMap, slots);
 
         // Updating and adding the bottom trapezoid previously initializated to the trapezoidal map
-        bottomTrapezoid.setRightPoint(segment.p2());
+        bottomTrapezoid.setRightPoint(rightEnd);
         bottomTrapezoid.setUpperRightNeigbor(nullIdx);
         if(!rightTrapezoidExists){// if right trapezoid exists it will be updated after we add it to the trapezoidal map
             if(!ProjectUtils::rightPointEqualBottomRightEndpoint(intersectedTrapCopy)) bottomTrapezoid.setLowerRightNeighbor(intersectedTrapCopy.getLowerRightNeighbor());
             else bottomTrapezoid.setLowerRightNeighbor(nullIdx);
         }
-        if(!trapezoidalMap.replaceTrapezoid(bottomTrapezoid, previousBottomTrapIdx)) trapezoidalMap.addTrapezoid(bottomTrapezoid);
+        placeTrapezoid(bottomTrapezoid, previousBottomTrapIdx, trapezoidalMap, slots);
 
         // New top trapezoid
-        topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, intersectedTrapCopy.getLeftPoint(), segment.p2());
+        topTrapezoid = Trapezoid(intersectedTrapCopy.getTopSegment(), segment, intersectedTrapCopy.getLeftPoint(), rightEnd);
         topTrapezoid.setUpperLeftNeighbor(intersectedTrapCopy.getUpperLeftNeighbor());
         if(!rightTrapezoidExists){// if right trapezoid exists it will be updated after we add it to the trapezoidal map
             if (!ProjectUtils::rightPointEqualTopRightEndpoint(intersectedTrapCopy)) topTrapezoid.setUpperRightNeigbor(intersectedTrapCopy.getUpperRightNeighbor());
@@ -653,6 +1033,8 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
         }
         topTrapezoid.setLowerLeftNeighbor(previousTopTrapIdx);
         topTrapezoid.setLowerRightNeighbor(nullIdx);
+        topTrapezoid.setTopSegmentIdx(intersectedTrapCopy.getTopSegmentIdx());
+        topTrapezoid.setBottomSegmentIdx(segmentIdx);
         topTrapezoid.setNodeIdx(topTrapLeaf);
         trapezoidalMap.replaceTrapezoid(topTrapezoid, topTrapezoidIdx);
 
@@ -669,19 +1051,19 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
         bottomTrapezoid.setRightPoint(intersectedTrapCopy.getLeftPoint());
         bottomTrapezoid.setUpperRightNeigbor(bottomTrapezoidIdx);
         bottomTrapezoid.setLowerRightNeighbor(prevIntersectedTrapezoid.getLowerRightNeighbor());
-        if(!trapezoidalMap.replaceTrapezoid(bottomTrapezoid, previousBottomTrapIdx))trapezoidalMap.addTrapezoid(bottomTrapezoid);
+        placeTrapezoid(bottomTrapezoid, previousBottomTrapIdx, trapezoidalMap, slots);
 
         // Updating and adding the top trapezoid previously initializated to the trapezoidal map
-        topTrapezoid.setRightPoint(segment.p2());
+        topTrapezoid.setRightPoint(rightEnd);
         topTrapezoid.setLowerRightNeighbor(nullIdx);
         if(!rightTrapezoidExists){// if right trapezoid exists it will be updated after we add it to the trapezoidal map
             if (!ProjectUtils::rightPointEqualTopRightEndpoint(intersectedTrapCopy)) topTrapezoid.setUpperRightNeigbor(intersectedTrapCopy.getUpperRightNeighbor());
             else topTrapezoid.setUpperRightNeigbor(nullIdx);
         }
-        if(!trapezoidalMap.replaceTrapezoid(topTrapezoid, previousTopTrapIdx)) trapezoidalMap.addTrapezoid(topTrapezoid);
+        placeTrapezoid(topTrapezoid, previousTopTrapIdx, trapezoidalMap, slots);
 
         // New top trapezoid
-        bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), intersectedTrapCopy.getLeftPoint(), segment.p2());
+        bottomTrapezoid = Trapezoid(segment, intersectedTrapCopy.getBottomSegment(), intersectedTrapCopy.getLeftPoint(), rightEnd);
         bottomTrapezoid.setUpperLeftNeighbor(previousBottomTrapIdx);
         bottomTrapezoid.setUpperRightNeigbor(nullIdx);
         bottomTrapezoid.setLowerLeftNeighbor(intersectedTrapCopy.getLowerLeftNeighbor());
@@ -689,6 +1071,8 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
             if(!ProjectUtils::rightPointEqualBottomRightEndpoint(intersectedTrapCopy)) bottomTrapezoid.setLowerRightNeighbor(intersectedTrapCopy.getLowerRightNeighbor());
             else bottomTrapezoid.setLowerRightNeighbor(nullIdx);
         }
+        bottomTrapezoid.setTopSegmentIdx(segmentIdx);
+        bottomTrapezoid.setBottomSegmentIdx(intersectedTrapCopy.getBottomSegmentIdx());
         bottomTrapezoid.setNodeIdx(bottomTrapLeaf);
         trapezoidalMap.replaceTrapezoid(bottomTrapezoid, bottomTrapezoidIdx);
 
@@ -696,14 +1080,14 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
     }
     // If right trapezoid exists we create it, add it to the trapezoidal map and update the upper right neighors of the previous top and bottom trapezoid
     if(rightTrapezoidExists){
-        rightTrapezoidIdx = trapezoidalMap.numTrapezoids(); // right trapezoid take the index next to the last trapezoid in the trapezoidal map
+        rightTrapezoidIdx = slots.nextTrapezoid; // right trapezoid take the index next to the last trapezoid in the trapezoidal map
         // Right trapezoid
         Trapezoid rightTrapezoid = intersectedTrapCopy;
-        rightTrapezoid.setLeftPoint(segment.p2());
+        rightTrapezoid.setLeftPoint(rightEnd);
         rightTrapezoid.setUpperLeftNeighbor(previousTopTrapIdx);
         rightTrapezoid.setLowerLeftNeighbor(previousBottomTrapIdx);
         rightTrapezoid.setNodeIdx(leafTrapRight);
-        trapezoidalMap.addTrapezoid(rightTrapezoid);
+        placeTrapezoid(rightTrapezoid, rightTrapezoidIdx, trapezoidalMap, slots);
         // Update the right neighbors of the top and bottom trapezoid
         trapezoidalMap.getTrapezoid(previousTopTrapIdx).setUpperRightNeigbor(rightTrapezoidIdx);
         trapezoidalMap.getTrapezoid(previousBottomTrapIdx).setLowerRightNeighbor(rightTrapezoidIdx);
@@ -720,27 +1104,25 @@ void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t
 
     // DAG UPDATE
     if(rightTrapezoidExists){
-        size_t pointIdx = trapezoidalMapData.findPoint(segment.p2(), found);
-        assert(found == true);
         // X node
-        newNode = Node(Node::NodeType::X, pointIdx, yNode, leafTrapRight);
+        newNode = Node(Node::NodeType::X, indexes.rightPointIdx, yNode, leafTrapRight);
         dag.replaceNode(newNode, xNodeRight);
         // right trap leaf
         newNode = Node(Node::NodeType::LEAF, rightTrapezoidIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, leafTrapRight, dag, slots);
     }
     // Y node
     newNode = Node(Node::NodeType::Y, segmentIdx, topTrapLeaf, bottomTrapLeaf);
-    rightTrapezoidExists ? dag.addNode(newNode) : dag.replaceNode(newNode, yNode);
+    placeNode(newNode, yNode, dag, slots);
     // New Top or Bottom trapezoid leaf
     if(topTrapEnds){
         // new Top trapezoid leaf added to the dag
         newNode = Node(Node::NodeType::LEAF, previousTopTrapIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, topTrapLeaf, dag, slots);
     }else{
         // new bottom trapezoid leaf added to the dag
         newNode = Node(Node::NodeType::LEAF, previousBottomTrapIdx, nullIdx, nullIdx);
-        dag.addNode(newNode);
+        placeNode(newNode, bottomTrapLeaf, dag, slots);
     }
 }
 }
@@ -2,28 +2,93 @@
 #define ALGORITHMS_H
 
 #include <cg3/geometry/segment2.h>
+#include <utility>
+#include <vector>
 #include "data_structures/trapezoidalmap_dataset.h"
 #include "data_structures/trapezoidalmap.h"
 #include "data_structures/dag.h"
-#include "drawables/drawable_trapezoidalmap.h"
+#include "data_structures/insertion_journal.h"
+#include "data_structures/query_profile.h"
+#include "data_structures/map_snapshot.h"
+#include "utils/projectUtils.h"
 
 /**
  * @brief Algorithms to build the trapezoidal map and the associated Dag, and to query these structures
  */
 namespace algorithms{
-    void initializeStructures(Dag &dag, DrawableTrapezoidalMap &trapezoidalMap);
+    // Next free indexes of the trapezoidal map and of the Dag for the trapezoids and the nodes created by an insertion
+    struct InsertionSlots{
+        size_t nextTrapezoid;
+        size_t nextNode;
+    };
+
+    // Dataset indexes of an inserted segment and of its endpoints (null for an end open beyond the part inserted in a slab, see parallel_build.cpp)
+    struct SegmentIndexes{
+        size_t segmentIdx;
+        size_t leftPointIdx;
+        size_t rightPointIdx;
+    };
+
+    // Scratch buffers of the insertions, reused by the next insertions so they do not allocate
+    struct BuildContext{
+        std::vector<size_t> intersectedTrapezoids;
+        InsertionJournal *journal;  // If not null, the insertions are recorded in the journal, so they can be undone
+
+        BuildContext() : journal(nullptr){}
+    };
+
+    void initializeStructures(Dag &dag, TrapezoidalMap &trapezoidalMap);
+
+    void reserveStructures(size_t expectedSegments, Dag &dag, TrapezoidalMap &trapezoidalMap);
 
     size_t queryPoint(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData);
 
+    size_t queryPoint(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData, QueryProfile &profile);
+
+    size_t queryPoint(const cg3::Point2d &q, const MapSnapshot &snapshot);
+
+    std::pair<size_t, size_t> queryAboveBelow(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+
+    std::vector<std::pair<size_t, size_t>> queryAboveBelow(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+
     size_t querySegment(const cg3::Segment2d &segment, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData);
 
     std::vector<size_t> followSegment(const cg3::Segment2d &segment, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
 
-    void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData);
+    void followSegment(const cg3::Segment2d &segment, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                       std::vector<size_t> &intersectedTrapezoids);
+
+    size_t locateAcrossSegment(const cg3::Point2d &crossingPoint, size_t crossedSegmentIdx, bool above, const cg3::Point2d &direction, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData);
+
+    void querySegmentCrossing(const cg3::Segment2d &querySeg, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                              std::vector<size_t> &crossedTrapezoids, std::vector<size_t> &crossedSegments);
+
+    void queryVerticalCrossing(const cg3::Segment2d &querySeg, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                               std::vector<size_t> &crossedTrapezoids, std::vector<size_t> &crossedSegments);
+
+    std::vector<size_t> stabVertical(double x, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+
+    bool trapezoidWindowRange(const Trapezoid &trapezoid, const cg3::BoundingBox2 &window, double &xMin, double &xMax);
+
+    void queryWindow(const cg3::BoundingBox2 &window, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData,
+                     std::vector<size_t> &windowTrapezoids, std::vector<size_t> &windowSegments);
+
+    void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData);
+
+    void buildTrapezoidalMap(const cg3::Segment2d &segment, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, BuildContext &context);
+
+    void insertSegment(const cg3::Segment2d &segment, const SegmentIndexes &indexes, const std::vector<size_t> &intersectedTrapezoids, InsertionSlots &slots,
+                       Dag &dag, TrapezoidalMap &trapezoidalMap);
+
+    void recordInsertion(size_t segmentIdx, const std::vector<size_t> &intersectedTrapezoids, const Dag &dag, const TrapezoidalMap &trapezoidalMap, InsertionJournal &journal);
+
+    void placeTrapezoid(Trapezoid &trapezoid, size_t idx, TrapezoidalMap &trapezoidalMap, InsertionSlots &slots);
+
+    void placeNode(Node &node, size_t idx, Dag &dag, InsertionSlots &slots);
 
-    void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTrapIdx, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData);
+    void oneIntersectedTrapezoid(const cg3::Segment2d &segment, size_t intersectedTrapIdx, const SegmentIndexes &indexes, InsertionSlots &slots, Dag &dag, TrapezoidalMap &trapezoidalMap);
 
-    void moreIntersectedTrapezoids(const cg3::Segment2d &segment, std::vector<size_t> intersectedTraps, Dag &dag, DrawableTrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData);
+    void moreIntersectedTrapezoids(const cg3::Segment2d &segment, const std::vector<size_t> &intersectedTraps, const SegmentIndexes &indexes, InsertionSlots &slots, Dag &dag, TrapezoidalMap &trapezoidalMap);
 }
 
 #endif // ALGORITHMS_H
@@ -0,0 +1,225 @@
+#include "balanced_dag.h"
+#include "utils/projectUtils.h"
+#include "utils/predicates.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace algorithms{
+
+/**
+ * @brief Shared state of the recursive construction of the balanced Dag
+ */
+struct BalancedDagBuilder{
+    const TrapezoidalMap &trapezoidalMap;
+    // Dataset index of the point with a given x coordinate (the x coordinates of the dataset are distinct)
+    std::unordered_map<double, size_t> pointIdxByX;
+    // Leaf of every trapezoid (created when first reached, so shared by all the regions containing the trapezoid)
+    std::vector<size_t> leafIdx;
+    Dag &dag;
+
+    BalancedDagBuilder(const TrapezoidalMap &trapezoidalMap, Dag &dag) : trapezoidalMap(trapezoidalMap), dag(dag){}
+
+    size_t build(const std::vector<size_t> &region, double xLeft, double xRight);
+    size_t leaf(size_t trapezoidIdx);
+};
+
+/**
+ * @brief Get the leaf of a trapezoid, creating it the first time
+ * @param[in] trapezoidIdx the index of the trapezoid
+ * @return the index of the leaf in the Dag
+ */
+size_t BalancedDagBuilder::leaf(size_t trapezoidIdx){
+    if(leafIdx[trapezoidIdx] == std::numeric_limits<size_t>::max()){
+        Node node = Node(Node::NodeType::LEAF, trapezoidIdx, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
+        leafIdx[trapezoidIdx] = dag.numNodes();
+        dag.addNode(node);
+    }
+    return leafIdx[trapezoidIdx];
+}
+
+/**
+ * @brief Build the search structure of a region of the map
+ * @param[in] region the trapezoids intersecting the region
+ * @param[in] xLeft the left limit of the region
+ * @param[in] xRight the right limit of the region
+ * @return the index of the root of the structure of the region
+ * The region is the part of the map between two vertical lines and, after the y-splits, between two segments spanning it.
+ * If a segment spans the whole region and splits its trapezoids evenly enough, the region is split with a y-node on that
+ * segment (every trapezoid lies on one side). Otherwise it is split with an x-node on the median endpoint inside the region,
+ * and the trapezoids crossing the vertical line go on both sides (their leaf is shared). Both kinds of split shrink the
+ * regions geometrically, so the depth is O(log n) whatever the insertion order of the segments.
+ */
+size_t BalancedDagBuilder::build(const std::vector<size_t> &region, double xLeft, double xRight){
+    if(region.size() == 1) return leaf(region[0]);
+
+    // The node is added before its children, so the root of the whole structure is the first node
+    size_t nodeIdx = dag.numNodes();
+    Node placeholder = Node(Node::NodeType::LEAF, 0, 0, 0);
+    dag.addNode(placeholder);
+
+    // Segments spanning the region: the top edges of a trapezoid that are also the bottom edge of another one
+    std::vector<size_t> topOf, bottomOf;
+    for(size_t trapezoidIdx : region){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        topOf.push_back(trapezoid.getTopSegmentIdx());
+        bottomOf.push_back(trapezoid.getBottomSegmentIdx());
+    }
+    std::sort(bottomOf.begin(), bottomOf.end());
+    std::vector<std::pair<size_t, cg3::Segment2d>> spanning;
+    for(size_t i = 0; i < region.size(); i++){
+        const cg3::Segment2d &top = trapezoidalMap.getTrapezoid(region[i]).getTopSegment();
+        if(topOf[i] != std::numeric_limits<size_t>::max() && top.p1().x() <= xLeft && top.p2().x() >= xRight &&
+                std::binary_search(bottomOf.begin(), bottomOf.end(), topOf[i])){
+            spanning.push_back(std::make_pair(topOf[i], top));
+        }
+    }
+
+    size_t bestSplit = std::numeric_limits<size_t>::max(), bestBelow = 0;
+    std::vector<size_t> position(region.size(), 0);
+    if(!spanning.empty()){
+        // The spanning segments do not cross inside the region, so they are ordered by their height at any x of the region
+        double xMid = (xLeft + xRight) / 2;
+        std::sort(spanning.begin(), spanning.end(), [xMid](const std::pair<size_t, cg3::Segment2d> &a, const std::pair<size_t, cg3::Segment2d> &b){
+            return ProjectUtils::segmentYAt(a.second, xMid) < ProjectUtils::segmentYAt(b.second, xMid);
+        });
+        spanning.erase(std::unique(spanning.begin(), spanning.end(), [](const std::pair<size_t, cg3::Segment2d> &a, const std::pair<size_t, cg3::Segment2d> &b){
+            return a.first == b.first;
+        }), spanning.end());
+
+        // Position of every trapezoid: the number of spanning segments below its center
+        std::vector<size_t> below(spanning.size() + 1, 0);
+        for(size_t i = 0; i < region.size(); i++){
+            const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(region[i]);
+            double x = (std::max(trapezoid.getLeftPoint().x(), xLeft) + std::min(trapezoid.getRightPoint().x(), xRight)) / 2;
+            cg3::Point2d center(x, (ProjectUtils::segmentYAt(trapezoid.getTopSegment(), x) + ProjectUtils::segmentYAt(trapezoid.getBottomSegment(), x)) / 2);
+            size_t low = 0, high = spanning.size();
+            while(low < high){
+                size_t mid = (low + high) / 2;
+                if(ProjectUtils::isPointAbove(spanning[mid].second, center)) low = mid + 1;
+                else high = mid;
+            }
+            position[i] = low;
+            below[low]++;
+        }
+
+        // The segment that balances best the two sides
+        size_t countBelow = 0;
+        for(size_t k = 0; k < spanning.size(); k++){
+            countBelow += below[k];
+            if(bestSplit == std::numeric_limits<size_t>::max() ||
+                    std::max(countBelow, region.size() - countBelow) < std::max(bestBelow, region.size() - bestBelow)){
+                bestSplit = k;
+                bestBelow = countBelow;
+            }
+        }
+    }
+
+    // Endpoints strictly inside the region, for the x-split
+    std::vector<double> xs;
+    for(size_t trapezoidIdx : region){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        if(trapezoid.getLeftPoint().x() > xLeft && trapezoid.getLeftPoint().x() < xRight) xs.push_back(trapezoid.getLeftPoint().x());
+        if(trapezoid.getRightPoint().x() > xLeft && trapezoid.getRightPoint().x() < xRight) xs.push_back(trapezoid.getRightPoint().x());
+    }
+
+    bool ySplit = bestSplit != std::numeric_limits<size_t>::max() &&
+            (xs.empty() || 4 * std::max(bestBelow, region.size() - bestBelow) <= 3 * region.size());
+
+    Node node = placeholder;
+    if(ySplit){
+        std::vector<size_t> above, below;
+        for(size_t i = 0; i < region.size(); i++){
+            if(position[i] > bestSplit) above.push_back(region[i]);
+            else below.push_back(region[i]);
+        }
+        size_t aboveIdx = build(above, xLeft, xRight);
+        size_t belowIdx = build(below, xLeft, xRight);
+        node = Node(Node::NodeType::Y, spanning[bestSplit].first, aboveIdx, belowIdx);
+    }else{
+        std::nth_element(xs.begin(), xs.begin() + xs.size() / 2, xs.end());
+        double xSplit = xs[xs.size() / 2];
+        // The queries with x equal to the split go to the right
+        std::vector<size_t> left, right;
+        for(size_t trapezoidIdx : region){
+            const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+            if(trapezoid.getLeftPoint().x() < xSplit) left.push_back(trapezoidIdx);
+            if(trapezoid.getRightPoint().x() > xSplit) right.push_back(trapezoidIdx);
+        }
+        size_t leftIdx = build(left, xLeft, xSplit);
+        size_t rightIdx = build(right, xSplit, xRight);
+        node = Node(Node::NodeType::X, pointIdxByX.at(xSplit), leftIdx, rightIdx);
+    }
+    dag.replaceNode(node, nodeIdx);
+
+    return nodeIdx;
+}
+
+/**
+ * @brief Replace the Dag of a finished trapezoidal map with a balanced one, built from the trapezoids without reinserting the segments
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * The new Dag answers the queries as the incremental one (same node predicates) and keeps the node index of every trapezoid
+ * up to date, so segments can still be inserted incrementally afterward.
+ */
+void buildBalancedDag(Dag &dag, TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
+    dag.clear();
+    if(trapezoidalMap.numTrapezoids() == 0) return;
+
+    BalancedDagBuilder builder(trapezoidalMap, dag);
+    const std::vector<cg3::Point2d> &points = trapezoidalMapData.getPoints();
+    for(size_t pointIdx = 0; pointIdx < points.size(); pointIdx++){
+        builder.pointIdxByX[points[pointIdx].x()] = pointIdx;
+    }
+    builder.leafIdx.assign(trapezoidalMap.numTrapezoids(), std::numeric_limits<size_t>::max());
+
+    std::vector<size_t> region(trapezoidalMap.numTrapezoids());
+    double xLeft = std::numeric_limits<double>::max(), xRight = std::numeric_limits<double>::lowest();
+    for(size_t trapezoidIdx = 0; trapezoidIdx < region.size(); trapezoidIdx++){
+        region[trapezoidIdx] = trapezoidIdx;
+        xLeft = std::min(xLeft, trapezoidalMap.getTrapezoid(trapezoidIdx).getLeftPoint().x());
+        xRight = std::max(xRight, trapezoidalMap.getTrapezoid(trapezoidIdx).getRightPoint().x());
+    }
+    builder.build(region, xLeft, xRight);
+
+    for(size_t trapezoidIdx = 0; trapezoidIdx < region.size(); trapezoidIdx++){
+        trapezoidalMap.getTrapezoid(trapezoidIdx).setNodeIdx(builder.leaf(trapezoidIdx));
+    }
+}
+
+/**
+ * @brief Compute the depth of the Dag
+ * @param[in] dag The DAG search structure
+ * @return the number of internal nodes on the longest path from the root to a leaf (the worst case cost of a query)
+ */
+size_t dagDepth(const Dag &dag){
+    if(dag.numNodes() == 0) return 0;
+
+    // Longest path below every node, computed with an iterative post-order visit (every shared node is computed once)
+    const size_t unknown = std::numeric_limits<size_t>::max();
+    std::vector<size_t> depth(dag.numNodes(), unknown);
+    std::vector<size_t> stack(1, 0);
+    while(!stack.empty()){
+        size_t nodeIdx = stack.back();
+        const Node &node = dag.getNode(nodeIdx);
+        if(node.getType() == Node::NodeType::LEAF){
+            depth[nodeIdx] = 0;
+            stack.pop_back();
+            continue;
+        }
+        size_t left = node.getLeftIdx(), right = node.getRightIdx();
+        if(depth[left] == unknown){
+            stack.push_back(left);
+        }else if(depth[right] == unknown){
+            stack.push_back(right);
+        }else{
+            depth[nodeIdx] = std::max(depth[left], depth[right]) + 1;
+            stack.pop_back();
+        }
+    }
+
+    return depth[0];
+}
+
+}
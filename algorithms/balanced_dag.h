@@ -0,0 +1,17 @@
+#ifndef BALANCED_DAG_H
+#define BALANCED_DAG_H
+
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief Construction of a balanced search structure from a finished trapezoidal map, independent of the insertion order
+ */
+namespace algorithms{
+    void buildBalancedDag(Dag &dag, TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+
+    size_t dagDepth(const Dag &dag);
+}
+
+#endif // BALANCED_DAG_H
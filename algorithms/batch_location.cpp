@@ -0,0 +1,303 @@
+#include "batch_location.h"
+#include "algorithms.h"
+#include "utils/predicates.h"
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+// Minimum number of query points per trapezoid for which the offline sweep is faster than the Dag descents (the break-even measured
+// by benchmarks/bench_batch_location.cpp, on maps from 3k to 900k trapezoids)
+#define SWEEP_MIN_QUERIES_PER_TRAPEZOID 2
+
+// Number of queries advanced in lockstep by the interleaved Dag traversal
+#define INTERLEAVED_GROUP_SIZE 16
+
+// Bits per coordinate of the grid used to compute the Hilbert keys (the keys use 2 * HILBERT_ORDER bits)
+#define HILBERT_ORDER 16
+
+// Prefetch hint (no-op on compilers without the builtin)
+#if defined(__GNUC__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address)
+#endif
+
+namespace algorithms{
+
+/**
+ * @brief Point location of a batch of points with an interleaved (software-pipelined) traversal of the Dag
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return the index of the trapezoid containing each query point, in the order of the query points (the same answers of queryPoint)
+ * A group of queries is advanced in lockstep, one Dag level per round. Each round is split in stages and every stage issues the
+ * prefetches needed by the next one (the node record, then the point or the segment referenced by the node, then the endpoints
+ * of the segment), so the cache misses of the different queries overlap instead of forming one long chain of dependent loads.
+ * When a query reaches a leaf its slot is refilled with the next query (starting from the root, which is always in cache).
+*/
+std::vector<size_t> queryPointsInterleaved(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData){
+    std::vector<size_t> located(queryPoints.size());
+    const ChunkedVector<Node> &nodes = dag.getNodes();
+    const std::vector<cg3::Point2d> &points = trapezoidalMapData.getPoints();
+    const std::vector<TrapezoidalMapDataset::IndexedSegment2d> &segments = trapezoidalMapData.getIndexedSegments();
+
+    // Query and current node of each slot of the group
+    size_t slotQuery[INTERLEAVED_GROUP_SIZE];
+    size_t slotNode[INTERLEAVED_GROUP_SIZE];
+    size_t activeSlots = 0;
+    size_t nextQuery = 0;
+    while(activeSlots < INTERLEAVED_GROUP_SIZE && nextQuery < queryPoints.size()){
+        slotQuery[activeSlots] = nextQuery++;
+        slotNode[activeSlots++] = 0;
+    }
+
+    while(activeSlots > 0){
+        // Stage 1: read the nodes (prefetched in the previous round), retire the queries that reached a leaf and prefetch the geometry
+        for(size_t slot = 0; slot < activeSlots; slot++){
+            const Node *node = &nodes[slotNode[slot]];
+            while(node->getType() == Node::NodeType::LEAF){
+                located[slotQuery[slot]] = node->getIdx();
+                if(nextQuery < queryPoints.size()){ // Refill the slot with the next query
+                    slotQuery[slot] = nextQuery++;
+                    slotNode[slot] = 0;
+                    node = &nodes[0];
+                }else{ // No more queries, the last slot takes its place
+                    activeSlots--;
+                    if(slot == activeSlots) break;
+                    slotQuery[slot] = slotQuery[activeSlots];
+                    slotNode[slot] = slotNode[activeSlots];
+                    node = &nodes[slotNode[slot]];
+                }
+            }
+            if(slot >= activeSlots) break;
+            if(node->getType() == Node::NodeType::X) PREFETCH(&points[node->getIdx()]);
+            else PREFETCH(&segments[node->getIdx()]);
+        }
+
+        // Stage 2: prefetch the endpoints of the segments of the y-nodes
+        for(size_t slot = 0; slot < activeSlots; slot++){
+            const Node &node = nodes[slotNode[slot]];
+            if(node.getType() == Node::NodeType::Y){
+                const TrapezoidalMapDataset::IndexedSegment2d &segment = segments[node.getIdx()];
+                PREFETCH(&points[segment.first]);
+                PREFETCH(&points[segment.second]);
+            }
+        }
+
+        // Stage 3: evaluate the node predicates (as in queryPoint), move to the child and prefetch it
+        for(size_t slot = 0; slot < activeSlots; slot++){
+            const Node &node = nodes[slotNode[slot]];
+            const cg3::Point2d &q = queryPoints[slotQuery[slot]];
+            bool goLeft;
+            if(node.getType() == Node::NodeType::X){
+                goLeft = q.x() < points[node.getIdx()].x();
+            }else{
+                const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment = segments[node.getIdx()];
+                cg3::Segment2d segment(points[indexedSegment.first], points[indexedSegment.second]);
+                ProjectUtils::orderSegment(segment);
+                goLeft = ProjectUtils::isPointAbove(segment, q);
+            }
+            slotNode[slot] = goLeft ? node.getLeftIdx() : node.getRightIdx();
+            PREFETCH(&nodes[slotNode[slot]]);
+        }
+    }
+
+    return located;
+}
+
+/**
+ * @brief Order of the trapezoids crossed by the sweep line (from the bottom to the top)
+ * The trapezoids in the active chain are pairwise disjoint and all of them cross the current slab,
+ * so two trapezoids are compared in the middle of their common x-range.
+ * The null index represents the query point, that is compared with the edges of the trapezoids with the same rules of the Dag y-nodes.
+ */
+class ActiveChainComparator{
+public:
+    ActiveChainComparator(const TrapezoidalMap &trapezoidalMap, const cg3::Point2d *const &queryPoint) :
+        trapezoidalMap(trapezoidalMap), queryPoint(queryPoint)
+    {
+
+    }
+
+    bool operator()(size_t a, size_t b) const{
+        size_t nullIdx = std::numeric_limits<size_t>::max();
+        if(a == nullIdx){ // The query point is below the trapezoid b if it lies on or below its bottom edge
+            cg3::Segment2d bottomSegment = trapezoidalMap.getTrapezoid(b).getBottomSegment();
+            ProjectUtils::orderSegment(bottomSegment);
+            return !ProjectUtils::isPointAbove(bottomSegment, *queryPoint);
+        }
+        if(b == nullIdx){ // The trapezoid a is below the query point if the point lies above its top edge
+            cg3::Segment2d topSegment = trapezoidalMap.getTrapezoid(a).getTopSegment();
+            ProjectUtils::orderSegment(topSegment);
+            return ProjectUtils::isPointAbove(topSegment, *queryPoint);
+        }
+        const Trapezoid &trapA = trapezoidalMap.getTrapezoid(a);
+        const Trapezoid &trapB = trapezoidalMap.getTrapezoid(b);
+        double x = (std::max(trapA.getLeftPoint().x(), trapB.getLeftPoint().x()) + std::min(trapA.getRightPoint().x(), trapB.getRightPoint().x())) / 2;
+        double middleA = ProjectUtils::segmentYAt(trapA.getTopSegment(), x) + ProjectUtils::segmentYAt(trapA.getBottomSegment(), x);
+        double middleB = ProjectUtils::segmentYAt(trapB.getTopSegment(), x) + ProjectUtils::segmentYAt(trapB.getBottomSegment(), x);
+        return middleA < middleB;
+    }
+
+private:
+    const TrapezoidalMap &trapezoidalMap;
+    const cg3::Point2d *const &queryPoint;
+};
+
+/**
+ * @brief Offline point location of a batch of points with a sweep of the trapezoidal map
+ * @param[in] queryPoints the query points
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @return the index of the trapezoid containing each query point, in the order of the query points
+ * The query points are sorted by x and the trapezoids are swept from left to right, keeping the chain of the trapezoids
+ * crossed by the sweep line ordered from the bottom to the top. Each point is located in the chain with a binary search.
+ * Points lying on a vertical side or on an edge are assigned as in queryPoint (to the right and below).
+ * The Dag is not used: the map is read sequentially, which is faster than a Dag descent per point for very large batches.
+*/
+std::vector<size_t> locateAllSorted(const std::vector<cg3::Point2d> &queryPoints, const TrapezoidalMap &trapezoidalMap){
+    size_t nullIdx = std::numeric_limits<size_t>::max();
+    std::vector<size_t> located(queryPoints.size(), nullIdx);
+
+    // Queries sorted by x
+    std::vector<size_t> queryOrder(queryPoints.size());
+    std::iota(queryOrder.begin(), queryOrder.end(), 0);
+    std::sort(queryOrder.begin(), queryOrder.end(), [&queryPoints](size_t a, size_t b){
+        return queryPoints[a].x() < queryPoints[b].x();
+    });
+
+    // Trapezoids sorted by the x of their left side (insertion in the chain) and of their right side (removal from the chain)
+    size_t numTrapezoids = trapezoidalMap.numTrapezoids();
+    std::vector<size_t> insertions(numTrapezoids), removals(numTrapezoids);
+    std::iota(insertions.begin(), insertions.end(), 0);
+    std::iota(removals.begin(), removals.end(), 0);
+    std::sort(insertions.begin(), insertions.end(), [&trapezoidalMap](size_t a, size_t b){
+        return trapezoidalMap.getTrapezoid(a).getLeftPoint().x() < trapezoidalMap.getTrapezoid(b).getLeftPoint().x();
+    });
+    std::sort(removals.begin(), removals.end(), [&trapezoidalMap](size_t a, size_t b){
+        return trapezoidalMap.getTrapezoid(a).getRightPoint().x() < trapezoidalMap.getTrapezoid(b).getRightPoint().x();
+    });
+
+    const cg3::Point2d *currentQuery = nullptr;
+    typedef std::set<size_t, ActiveChainComparator> ActiveChain;
+    ActiveChain activeChain(ActiveChainComparator(trapezoidalMap, currentQuery));
+    std::vector<ActiveChain::iterator> chainPositions(numTrapezoids, activeChain.end());
+
+    size_t nextInsertion = 0, nextRemoval = 0;
+    for(size_t queryIdx : queryOrder){
+        const cg3::Point2d &q = queryPoints[queryIdx];
+
+        // Advance the sweep line up to q: at each event the trapezoids ending there leave the chain before the new ones enter
+        while(nextInsertion < numTrapezoids || nextRemoval < numTrapezoids){
+            double insertionX = nextInsertion < numTrapezoids ? trapezoidalMap.getTrapezoid(insertions[nextInsertion]).getLeftPoint().x() : std::numeric_limits<double>::infinity();
+            double removalX = nextRemoval < numTrapezoids ? trapezoidalMap.getTrapezoid(removals[nextRemoval]).getRightPoint().x() : std::numeric_limits<double>::infinity();
+            double eventX = std::min(insertionX, removalX);
+            if(eventX > q.x()) break;
+            while(nextRemoval < numTrapezoids && trapezoidalMap.getTrapezoid(removals[nextRemoval]).getRightPoint().x() == eventX){
+                size_t removed = removals[nextRemoval++];
+                if(chainPositions[removed] != activeChain.end()) activeChain.erase(chainPositions[removed]);
+                chainPositions[removed] = activeChain.end();
+            }
+            while(nextInsertion < numTrapezoids && trapezoidalMap.getTrapezoid(insertions[nextInsertion]).getLeftPoint().x() == eventX){
+                size_t inserted = insertions[nextInsertion++];
+                // A trapezoid already passed by the sweep line (removed before being inserted) is skipped
+                if(trapezoidalMap.getTrapezoid(inserted).getRightPoint().x() > eventX){
+                    chainPositions[inserted] = activeChain.insert(inserted).first;
+                }
+            }
+        }
+
+        // The first trapezoid of the chain whose top edge is not below q
+        currentQuery = &q;
+        ActiveChain::iterator it = activeChain.lower_bound(nullIdx);
+        if(it != activeChain.end()) located[queryIdx] = *it;
+    }
+
+    return located;
+}
+
+/**
+ * @brief Compute the position of a point along the Hilbert curve that fills a bounding box
+ * @param[in] point the point
+ * @param[in] boundingBox the box covered by the curve (points outside are clamped to its border)
+ * @return the Hilbert key of the cell of a 2^HILBERT_ORDER x 2^HILBERT_ORDER grid containing the point
+ * Points with close keys are close in the plane, so queries sorted by key follow similar paths in the Dag.
+*/
+uint64_t hilbertKey(const cg3::Point2d &point, const cg3::BoundingBox2 &boundingBox){
+    const uint64_t side = uint64_t(1) << HILBERT_ORDER;
+    double minX = std::min(boundingBox.min().x(), boundingBox.max().x()), maxX = std::max(boundingBox.min().x(), boundingBox.max().x());
+    double minY = std::min(boundingBox.min().y(), boundingBox.max().y()), maxY = std::max(boundingBox.min().y(), boundingBox.max().y());
+
+    // Grid cell of the point
+    double fx = maxX > minX ? (point.x() - minX) / (maxX - minX) : 0;
+    double fy = maxY > minY ? (point.y() - minY) / (maxY - minY) : 0;
+    uint64_t x = static_cast<uint64_t>(std::min(std::max(fx, 0.0), 1.0) * double(side - 1));
+    uint64_t y = static_cast<uint64_t>(std::min(std::max(fy, 0.0), 1.0) * double(side - 1));
+
+    // Walk down the quadrants, rotating the frame as the curve does
+    uint64_t key = 0;
+    for(uint64_t s = side / 2; s > 0; s /= 2){
+        uint64_t rx = (x & s) > 0;
+        uint64_t ry = (y & s) > 0;
+        key += s * s * ((3 * rx) ^ ry);
+        if(ry == 0){
+            if(rx == 1){
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return key;
+}
+
+/**
+ * @brief Sort a batch of points along the Hilbert curve
+ * @param[in] queryPoints the query points
+ * @param[in] boundingBox the box covered by the curve (the bounding box of the trapezoidal map)
+ * @return the indexes of the query points in Hilbert order
+*/
+std::vector<size_t> hilbertOrder(const std::vector<cg3::Point2d> &queryPoints, const cg3::BoundingBox2 &boundingBox){
+    std::vector<std::pair<uint64_t, size_t>> keys(queryPoints.size());
+    for(size_t i = 0; i < queryPoints.size(); i++){
+        keys[i] = std::make_pair(hilbertKey(queryPoints[i], boundingBox), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<size_t> order(queryPoints.size());
+    for(size_t i = 0; i < keys.size(); i++) order[i] = keys[i].second;
+
+    return order;
+}
+
+/**
+ * @brief Point location of a batch of points, choosing the fastest engine for the size of the batch
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[in] hilbertSort if true the queries answered with the Dag are reordered along the Hilbert curve of the map's bounding box
+ * @return the index of the trapezoid containing each query point, in the order of the query points
+ * Small batches are answered with the interleaved Dag traversal, batches with many points per trapezoid with the offline sweep.
+ * The Hilbert order makes consecutive queries share the upper paths of the Dag and the trapezoid records in cache, so the sorted
+ * queries are answered one at a time (the interleaving is not needed once the paths are in cache). The sort pays for itself on
+ * large batches over large maps, where a random order misses the cache at almost every level.
+*/
+std::vector<size_t> locateAll(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData, bool hilbertSort){
+    if(queryPoints.size() >= SWEEP_MIN_QUERIES_PER_TRAPEZOID * trapezoidalMap.numTrapezoids()){
+        return locateAllSorted(queryPoints, trapezoidalMap);
+    }
+
+    if(!hilbertSort) return queryPointsInterleaved(queryPoints, dag, trapezoidalMapData);
+
+    // Run the queries in Hilbert order and scatter the answers back to the original order
+    std::vector<size_t> order = hilbertOrder(queryPoints, trapezoidalMap.getBoundingBox());
+    std::vector<size_t> located(queryPoints.size());
+    for(size_t i = 0; i < order.size(); i++){
+        located[order[i]] = queryPoint(queryPoints[order[i]], dag, trapezoidalMapData);
+    }
+
+    return located;
+}
+
+}
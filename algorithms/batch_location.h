@@ -0,0 +1,27 @@
+#ifndef BATCH_LOCATION_H
+#define BATCH_LOCATION_H
+
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/bounding_box2.h>
+#include <cstdint>
+#include <vector>
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief Batch point location engines, to locate many query points at once
+ */
+namespace algorithms{
+    std::vector<size_t> queryPointsInterleaved(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData);
+
+    std::vector<size_t> locateAllSorted(const std::vector<cg3::Point2d> &queryPoints, const TrapezoidalMap &trapezoidalMap);
+
+    std::vector<size_t> locateAll(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData, bool hilbertSort = false);
+
+    uint64_t hilbertKey(const cg3::Point2d &point, const cg3::BoundingBox2 &boundingBox);
+
+    std::vector<size_t> hilbertOrder(const std::vector<cg3::Point2d> &queryPoints, const cg3::BoundingBox2 &boundingBox);
+}
+
+#endif // BATCH_LOCATION_H
@@ -0,0 +1,205 @@
+#include "dag_layout.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace algorithms{
+
+/**
+ * @brief Compute the spanning tree of the Dag given by the first discovery of every node in a breadth-first visit from the root
+ * @param[in] dag The DAG search structure
+ * @param[out] parent the parent of every node in the spanning tree (nullIdx for the root and the unreachable nodes)
+ * @param[out] height the number of levels of the spanning subtree rooted at every node (1 for the leaves)
+ * A node reached by several paths (the leaves are shared by many internal nodes) belongs to the tree only once.
+*/
+void spanningTree(const Dag &dag, std::vector<size_t> &parent, std::vector<size_t> &height){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    parent.assign(dag.numNodes(), nullIdx);
+    height.assign(dag.numNodes(), 1);
+    if(dag.numNodes() == 0) return;
+
+    std::vector<bool> visited(dag.numNodes(), false);
+    std::vector<size_t> bfsOrder;
+    bfsOrder.reserve(dag.numNodes());
+    visited[0] = true;
+    bfsOrder.push_back(0);
+    for(size_t i = 0; i < bfsOrder.size(); i++){
+        const Node &node = dag.getNode(bfsOrder[i]);
+        if(node.getType() == Node::NodeType::LEAF) continue;
+        for(size_t child : {node.getLeftIdx(), node.getRightIdx()}){
+            if(!visited[child]){
+                visited[child] = true;
+                parent[child] = bfsOrder[i];
+                bfsOrder.push_back(child);
+            }
+        }
+    }
+
+    // The children follow their parent in the breadth-first order, so the heights are computed backward
+    for(size_t i = bfsOrder.size(); i-- > 1;){
+        size_t nodeIdx = bfsOrder[i];
+        height[parent[nodeIdx]] = std::max(height[parent[nodeIdx]], height[nodeIdx] + 1);
+    }
+}
+
+/**
+ * @brief Append to the order the nodes of a spanning subtree in van Emde Boas order
+ * @param[in] dag The DAG search structure
+ * @param[in] parent the parents in the spanning tree
+ * @param[in] height the heights of the spanning subtrees
+ * @param[in] rootIdx the root of the subtree
+ * @param[in] levels the number of levels of the subtree to lay out
+ * @param[out] order the order of the nodes
+ * The top half of the levels is laid out first (recursively), then every subtree hanging below it (recursively), so every
+ * subtree of about B nodes ends up in a contiguous block, whatever the size B of the cache lines.
+*/
+void vanEmdeBoasLayout(const Dag &dag, const std::vector<size_t> &parent, const std::vector<size_t> &height, size_t rootIdx, size_t levels, std::vector<size_t> &order){
+    if(levels == 1){
+        order.push_back(rootIdx);
+        return;
+    }
+
+    size_t topLevels = levels / 2;
+    vanEmdeBoasLayout(dag, parent, height, rootIdx, topLevels, order);
+
+    // Roots of the bottom subtrees: the nodes of the spanning tree topLevels levels below the root
+    std::vector<std::pair<size_t, size_t>> stack(1, std::make_pair(rootIdx, size_t(0)));
+    std::vector<size_t> bottomRoots;
+    while(!stack.empty()){
+        size_t nodeIdx = stack.back().first, depth = stack.back().second;
+        stack.pop_back();
+        if(depth == topLevels){
+            bottomRoots.push_back(nodeIdx);
+            continue;
+        }
+        const Node &node = dag.getNode(nodeIdx);
+        if(node.getType() == Node::NodeType::LEAF) continue;
+        // Right pushed first, so the left subtree comes first in the layout
+        if(parent[node.getRightIdx()] == nodeIdx) stack.push_back(std::make_pair(node.getRightIdx(), depth + 1));
+        if(parent[node.getLeftIdx()] == nodeIdx && node.getLeftIdx() != node.getRightIdx()) stack.push_back(std::make_pair(node.getLeftIdx(), depth + 1));
+    }
+
+    for(size_t bottomRoot : bottomRoots){
+        vanEmdeBoasLayout(dag, parent, height, bottomRoot, std::min(levels - topLevels, height[bottomRoot]), order);
+    }
+}
+
+/**
+ * @brief Compute the van Emde Boas order of the nodes of the Dag
+ * @param[in] dag The DAG search structure
+ * @return the old indexes of the nodes, in their new order (the root stays first)
+ * The layout is computed on the breadth-first spanning tree of the Dag, so the shared nodes are counted once (near their
+ * shallowest parent). The unreachable nodes, if any, are moved at the end.
+*/
+std::vector<size_t> vanEmdeBoasOrder(const Dag &dag){
+    std::vector<size_t> order;
+    if(dag.numNodes() == 0) return order;
+
+    std::vector<size_t> parent, height;
+    spanningTree(dag, parent, height);
+
+    order.reserve(dag.numNodes());
+    vanEmdeBoasLayout(dag, parent, height, 0, height[0], order);
+
+    if(order.size() < dag.numNodes()){
+        std::vector<bool> placed(dag.numNodes(), false);
+        for(size_t nodeIdx : order) placed[nodeIdx] = true;
+        for(size_t nodeIdx = 0; nodeIdx < dag.numNodes(); nodeIdx++){
+            if(!placed[nodeIdx]) order.push_back(nodeIdx);
+        }
+    }
+
+    return order;
+}
+
+/**
+ * @brief Renumber the nodes of the Dag
+ * @param[in] order the old indexes of the nodes, in their new order (a permutation keeping the root first)
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * The nodes are stored again in the given order, rewriting the child indexes and the node index of every trapezoid,
+ * so the map can still be updated incrementally after the relayout.
+*/
+void applyDagLayout(const std::vector<size_t> &order, Dag &dag, TrapezoidalMap &trapezoidalMap){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    std::vector<size_t> newIdx(order.size());
+    for(size_t i = 0; i < order.size(); i++) newIdx[order[i]] = i;
+
+    ChunkedVector<Node> nodes = dag.getNodes(); // Shares the chunks, no copy
+    dag.clear();
+    for(size_t oldIdx : order){
+        const Node &node = nodes[oldIdx];
+        Node newNode = node.getType() == Node::NodeType::LEAF ? node : Node(node.getType(), node.getIdx(),
+                                                                            node.getLeftIdx() == nullIdx ? nullIdx : newIdx[node.getLeftIdx()],
+                                                                            node.getRightIdx() == nullIdx ? nullIdx : newIdx[node.getRightIdx()]);
+        dag.addNode(newNode);
+    }
+
+    for(size_t trapezoidIdx = 0; trapezoidIdx < trapezoidalMap.numTrapezoids(); trapezoidIdx++){
+        Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        if(trapezoid.getNodeIdx() != nullIdx) trapezoid.setNodeIdx(newIdx[trapezoid.getNodeIdx()]);
+    }
+}
+
+/**
+ * @brief Relayout the Dag in van Emde Boas order, after the map is built
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * The nodes are stored in creation order by the construction, so a root-to-leaf path jumps all over the node array.
+ * In van Emde Boas order a path touches O(log_B n) cache lines instead of O(log n).
+*/
+void relayoutDag(Dag &dag, TrapezoidalMap &trapezoidalMap){
+    applyDagLayout(vanEmdeBoasOrder(dag), dag, trapezoidalMap);
+}
+
+/**
+ * @brief Compute the order of the nodes of the Dag that keeps the hot paths of a query profile contiguous
+ * @param[in] dag The DAG search structure
+ * @param[in] profile the visit counts recorded on the Dag
+ * @return the old indexes of the nodes, in their new order (the root stays first)
+ * The visited nodes are laid out with a depth-first visit that takes the more likely child first, so the hot child of a node
+ * is stored right after it and the hottest path is a single block. The nodes never visited follow in van Emde Boas order.
+*/
+std::vector<size_t> hotPathOrder(const Dag &dag, const QueryProfile &profile){
+    std::vector<size_t> order;
+    if(dag.numNodes() == 0) return order;
+
+    order.reserve(dag.numNodes());
+    std::vector<bool> placed(dag.numNodes(), false);
+    std::vector<size_t> stack(1, 0);
+    while(!stack.empty()){
+        size_t nodeIdx = stack.back();
+        stack.pop_back();
+        if(placed[nodeIdx]) continue;
+        placed[nodeIdx] = true;
+        order.push_back(nodeIdx);
+
+        const Node &node = dag.getNode(nodeIdx);
+        if(node.getType() == Node::NodeType::LEAF) continue;
+        size_t hotChild = profile.isLeftHot(nodeIdx) ? node.getLeftIdx() : node.getRightIdx();
+        size_t coldChild = profile.isLeftHot(nodeIdx) ? node.getRightIdx() : node.getLeftIdx();
+        // The hot child is pushed last, so it is placed next
+        if(profile.getVisits(coldChild) > 0 && !placed[coldChild]) stack.push_back(coldChild);
+        if(profile.getVisits(hotChild) > 0 && !placed[hotChild]) stack.push_back(hotChild);
+    }
+
+    for(size_t nodeIdx : vanEmdeBoasOrder(dag)){
+        if(!placed[nodeIdx]) order.push_back(nodeIdx);
+    }
+
+    return order;
+}
+
+/**
+ * @brief Relayout the Dag following the hot paths of a query profile
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] profile the visit counts recorded on the Dag during a sampling period
+ * With a skewed query distribution the few hot paths end up in few cache lines. The node indexes change, so the profile must
+ * be cleared before sampling again.
+*/
+void relayoutDag(Dag &dag, TrapezoidalMap &trapezoidalMap, const QueryProfile &profile){
+    applyDagLayout(hotPathOrder(dag, profile), dag, trapezoidalMap);
+}
+
+}
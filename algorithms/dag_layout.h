@@ -0,0 +1,24 @@
+#ifndef DAG_LAYOUT_H
+#define DAG_LAYOUT_H
+
+#include <vector>
+#include "data_structures/dag.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/query_profile.h"
+
+/**
+ * @brief Relayout passes of the Dag node array, to make the query paths cache friendly
+ */
+namespace algorithms{
+    std::vector<size_t> vanEmdeBoasOrder(const Dag &dag);
+
+    void applyDagLayout(const std::vector<size_t> &order, Dag &dag, TrapezoidalMap &trapezoidalMap);
+
+    void relayoutDag(Dag &dag, TrapezoidalMap &trapezoidalMap);
+
+    std::vector<size_t> hotPathOrder(const Dag &dag, const QueryProfile &profile);
+
+    void relayoutDag(Dag &dag, TrapezoidalMap &trapezoidalMap, const QueryProfile &profile);
+}
+
+#endif // DAG_LAYOUT_H
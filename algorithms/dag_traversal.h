@@ -0,0 +1,189 @@
+#ifndef DAG_TRAVERSAL_H
+#define DAG_TRAVERSAL_H
+
+#include "utils/predicates.h"
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/dag.h"
+#include "data_structures/query_profile.h"
+#include "utils/projectUtils.h"
+
+/**
+ * @brief Generic descent of the Dag, shared by all the query kinds.
+ * The descent is parameterized at compile time by the source of the nodes (the Dag, or a view of it, such as the Dag of a past version
+ * of a persistent map), by the geometry the node indexes refer to (the dataset, or a quantized copy of it),
+ * by a predicate policy, which decides the child to take at the x-nodes and y-nodes, and by a visitor, which is notified of every
+ * visited node. All are inlined in every specialization, so a query kind costs the same as a hand-written loop. A policy provides:
+ *     bool goLeftX(size_t pointIdx, const Geometry &geometry) const;   // true to go left of the point of an x-node
+ *     bool goLeftY(size_t segmentIdx, const Geometry &geometry) const; // true to go above the segment of a y-node
+ * a visitor provides:
+ *     void visit(size_t nodeIdx, bool goLeft);  // an internal node and the child taken
+ *     void visitLeaf(size_t nodeIdx);           // the leaf where the descent ends
+ * and a node source provides (as the Dag does):
+ *     const Node &getNode(size_t nodeIdx) const; // the node of an index, valid until the next call
+ */
+namespace algorithms{
+
+    // Visitor that records nothing (the calls are optimized away)
+    struct NoVisitor{
+        void visit(size_t, bool){}
+        void visitLeaf(size_t){}
+    };
+
+    // Visitor that records the visits in a query profile
+    struct ProfileVisitor{
+        QueryProfile &profile;
+        ProfileVisitor(QueryProfile &profile) : profile(profile){}
+        void visit(size_t nodeIdx, bool goLeft){ profile.recordVisit(nodeIdx, goLeft); }
+        void visitLeaf(size_t nodeIdx){ profile.recordVisit(nodeIdx, false); profile.recordQuery(); }
+    };
+
+    // Visitor that records the path of the descent
+    struct PathVisitor{
+        std::vector<size_t> &path;
+        PathVisitor(std::vector<size_t> &path) : path(path){}
+        void visit(size_t nodeIdx, bool){ path.push_back(nodeIdx); }
+        void visitLeaf(size_t nodeIdx){ path.push_back(nodeIdx); }
+    };
+
+    // Point location: x ties go right, a point on a segment goes below it (on the dataset or on a snapshot of the map)
+    struct PointPolicy{
+        const cg3::Point2d &q;
+        PointPolicy(const cg3::Point2d &q) : q(q){}
+        template<class Geometry>
+        bool goLeftX(size_t pointIdx, const Geometry &geometry) const{ return q.x() < geometry.getPoint(pointIdx).x(); }
+        template<class Geometry>
+        bool goLeftY(size_t segmentIdx, const Geometry &geometry) const{
+            cg3::Segment2d segment = geometry.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            return ProjectUtils::isPointAbove(segment, q);
+        }
+    };
+
+    // Location of the left endpoint of a segment (as in the insertion): if the endpoint is on a segment, the right endpoint decides (on the dataset or on a copy of the map)
+    struct SegmentPolicy{
+        const cg3::Segment2d &querySegment;
+        SegmentPolicy(const cg3::Segment2d &querySegment) : querySegment(querySegment){}
+        template<class Geometry>
+        bool goLeftX(size_t pointIdx, const Geometry &geometry) const{ return querySegment.p1().x() < geometry.getPoint(pointIdx).x(); }
+        template<class Geometry>
+        bool goLeftY(size_t segmentIdx, const Geometry &geometry) const{
+            cg3::Segment2d segment = geometry.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            if(ProjectUtils::isPointAbove(segment, querySegment.p1())) return true;
+            if(ProjectUtils::isPointBelow(segment, querySegment.p1())) return false;
+            return ProjectUtils::isPointAbove(segment, querySegment.p2());
+        }
+    };
+
+    // Location on a given side of a crossed segment: the y-nodes of the crossed segment are forced, the ties follow the direction of the walk
+    struct CrossingPolicy{
+        const cg3::Point2d &crossingPoint;
+        size_t crossedSegmentIdx;
+        bool above;
+        const cg3::Point2d &direction;
+        CrossingPolicy(const cg3::Point2d &crossingPoint, size_t crossedSegmentIdx, bool above, const cg3::Point2d &direction) :
+            crossingPoint(crossingPoint), crossedSegmentIdx(crossedSegmentIdx), above(above), direction(direction){}
+        bool goLeftX(size_t pointIdx, const TrapezoidalMapDataset &trapezoidalMapData) const{ return crossingPoint.x() < trapezoidalMapData.getPoint(pointIdx).x(); }
+        bool goLeftY(size_t segmentIdx, const TrapezoidalMapDataset &trapezoidalMapData) const{
+            if(segmentIdx == crossedSegmentIdx) return above;
+            cg3::Segment2d segment = trapezoidalMapData.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            if(ProjectUtils::isPointAbove(segment, crossingPoint)) return true;
+            if(ProjectUtils::isPointBelow(segment, crossingPoint)) return false;
+            return ProjectUtils::isPointAbove(segment, direction);
+        }
+    };
+
+    // Location of a point of a vertical line, which lies just to the right of its x: a point on a segment takes the side of the segment there
+    struct VerticalPointPolicy{
+        const cg3::Point2d &q;
+        VerticalPointPolicy(const cg3::Point2d &q) : q(q){}
+        template<class Geometry>
+        bool goLeftX(size_t pointIdx, const Geometry &geometry) const{ return q.x() < geometry.getPoint(pointIdx).x(); }
+        template<class Geometry>
+        bool goLeftY(size_t segmentIdx, const Geometry &geometry) const{
+            cg3::Segment2d segment = geometry.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            return ProjectUtils::isPointAboveRight(segment, q);
+        }
+    };
+
+    // Location just above a crossed segment, on a vertical line just to the right of x: the y-nodes are decided by the order of the segments,
+    // exactly, without computing the crossing point
+    struct AboveSegmentPolicy{
+        double x;
+        size_t crossedSegmentIdx;
+        const cg3::Segment2d &crossedSegment;
+        AboveSegmentPolicy(double x, size_t crossedSegmentIdx, const cg3::Segment2d &crossedSegment) :
+            x(x), crossedSegmentIdx(crossedSegmentIdx), crossedSegment(crossedSegment){}
+        template<class Geometry>
+        bool goLeftX(size_t pointIdx, const Geometry &geometry) const{ return x < geometry.getPoint(pointIdx).x(); }
+        template<class Geometry>
+        bool goLeftY(size_t segmentIdx, const Geometry &geometry) const{
+            if(segmentIdx == crossedSegmentIdx) return true;
+            cg3::Segment2d segment = geometry.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            return ProjectUtils::isSegmentAbove(crossedSegment, segment);
+        }
+    };
+
+    /**
+     * @brief Descend the Dag from a given node to a leaf
+     * @param[in] nodes The DAG search structure, or a node source viewing it
+     * @param[in] geometry the points and segments referred by the nodes (the trapezoidal map dataset, or a quantized copy of it)
+     * @param[in] policy the predicate policy
+     * @param[in] visitor the visitor notified of the visited nodes
+     * @param[in] startIdx the index of the node where the descent starts (the policy must take the same path as a descent from the root)
+     * @return the index of the trapezoid of the leaf reached
+     */
+    template<class Nodes, class Geometry, class Policy, class Visitor>
+    inline size_t traverseDag(const Nodes &nodes, const Geometry &geometry, const Policy &policy, Visitor &visitor, size_t startIdx){
+        size_t nodeIdx = startIdx;
+        const Node *node = &nodes.getNode(startIdx);
+        // A specialized path per node type: the x-nodes, which are most of the visited nodes, are followed in an inner loop
+        // that only compares the x coordinates, and the loop leaves it for the (less frequent) y-nodes and for the leaf
+        while(true){
+            while(node->getType() == Node::NodeType::X){
+                bool goLeft = policy.goLeftX(node->getIdx(), geometry);
+                visitor.visit(nodeIdx, goLeft);
+                nodeIdx = goLeft ? node->getLeftIdx() : node->getRightIdx();
+                node = &nodes.getNode(nodeIdx);
+            }
+            if(node->getType() == Node::NodeType::LEAF) break;
+            bool goLeft = policy.goLeftY(node->getIdx(), geometry);
+            visitor.visit(nodeIdx, goLeft);
+            nodeIdx = goLeft ? node->getLeftIdx() : node->getRightIdx();
+            node = &nodes.getNode(nodeIdx);
+        }
+        visitor.visitLeaf(nodeIdx);
+        return node->getIdx();
+    }
+
+    /**
+     * @brief Descend the Dag from the root to a leaf
+     * @param[in] nodes The DAG search structure, or a node source viewing it
+     * @param[in] geometry the points and segments referred by the nodes (the trapezoidal map dataset, or a quantized copy of it)
+     * @param[in] policy the predicate policy
+     * @param[in] visitor the visitor notified of the visited nodes
+     * @return the index of the trapezoid of the leaf reached
+     */
+    template<class Nodes, class Geometry, class Policy, class Visitor>
+    inline size_t traverseDag(const Nodes &nodes, const Geometry &geometry, const Policy &policy, Visitor &visitor){
+        return traverseDag(nodes, geometry, policy, visitor, 0);
+    }
+
+    /**
+     * @brief Descend the Dag from the root to a leaf, without a visitor
+     * @param[in] nodes The DAG search structure, or a node source viewing it
+     * @param[in] geometry the points and segments referred by the nodes
+     * @param[in] policy the predicate policy
+     * @return the index of the trapezoid of the leaf reached
+     */
+    template<class Nodes, class Geometry, class Policy>
+    inline size_t traverseDag(const Nodes &nodes, const Geometry &geometry, const Policy &policy){
+        NoVisitor visitor;
+        return traverseDag(nodes, geometry, policy, visitor);
+    }
+}
+
+#endif // DAG_TRAVERSAL_H
@@ -0,0 +1,193 @@
+#include "durable_map.h"
+#include <fstream>
+#include "utils/fileutils.h"
+
+#define BOUNDINGBOX 1e+6
+
+/**
+ * @brief Constructor, recovers the map saved in a directory and opens its log
+ * @param[in] directory the directory of the snapshot and of the log (it must exist)
+ * @param[in] snapshotInterval the number of insertions between two snapshots (0 to save the snapshots only with saveSnapshot)
+ */
+DurableTrapezoidalMap::DurableTrapezoidalMap(const std::string &directory, size_t snapshotInterval) :
+    snapshotFilename(directory + "/map.snapshot"), logFilename(directory + "/insertions.log"),
+    snapshotInterval(snapshotInterval), numReplayed(0), insertionsSinceSnapshot(0), sequence(0),
+    trapezoidalMap(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX)){
+    buildContext.journal = &journal;
+    recover();
+}
+
+/**
+ * @brief Check if the log is open
+ * @return false if the log could not be opened, the insertions are refused
+ */
+bool DurableTrapezoidalMap::isOpen() const{
+    return log.isOpen();
+}
+
+/**
+ * @brief Insert a segment in the map
+ * @param[in] segment the segment
+ * @return false if the segment was not inserted (it is a duplicate, it intersects the other segments, or it could not be appended to the log)
+ * The segment is appended to the log before the insertion, it is durable after the next sync of the log. A segment that cannot be
+ * appended (the log is closed, or its full batch cannot be synced) is removed from the dataset and the map does not change.
+ */
+bool DurableTrapezoidalMap::insertSegment(const cg3::Segment2d &segment){
+    bool inserted;
+    size_t segmentIdx = trapezoidalMapData.addSegment(segment, inserted);
+    if(!inserted) return false;
+    InsertionLog::Record record = {InsertionLog::RecordType::INSERTION, sequence, segmentIdx, trapezoidalMapData.getSegment(segmentIdx)};
+    if(!log.append(record)){
+        trapezoidalMapData.removeLastSegment();
+        return false;
+    }
+
+    algorithms::buildTrapezoidalMap(segment, dag, trapezoidalMap, trapezoidalMapData, buildContext);
+    sequence++;
+    insertionsSinceSnapshot++;
+    if(snapshotInterval > 0 && insertionsSinceSnapshot >= snapshotInterval) saveSnapshot();
+    return true;
+}
+
+/**
+ * @brief Undo the last insertion, removing its segment from the map
+ * @return false if there is no insertion to undo (the journal keeps the last INSERTION_JOURNAL_MAX_INSERTIONS ones) or the removal
+ * could not be appended to the log
+ * The removal is appended to the log before the structures are restored, it is durable after the next sync of the log.
+ */
+bool DurableTrapezoidalMap::undoLastInsertion(){
+    if(journal.numInsertions() == 0) return false;
+    size_t segmentIdx = trapezoidalMapData.getIndexedSegments().size() - 1;
+    InsertionLog::Record record = {InsertionLog::RecordType::REMOVAL, sequence, segmentIdx, trapezoidalMapData.getSegment(segmentIdx)};
+    if(!log.append(record)) return false;
+
+    journal.undoLastInsertion(dag, trapezoidalMap, trapezoidalMapData);
+    sequence++;
+    insertionsSinceSnapshot++;
+    if(snapshotInterval > 0 && insertionsSinceSnapshot >= snapshotInterval) saveSnapshot();
+    return true;
+}
+
+/**
+ * @brief Write the buffered records of the log and wait for them to be on the disk
+ * @return false if the records could not be written
+ */
+bool DurableTrapezoidalMap::sync(){
+    return log.sync();
+}
+
+/**
+ * @brief Save a snapshot of the structures and empty the log
+ * @return false if the log could not be synced or the snapshot could not be saved (the log is kept)
+ * The log is synced first: if the process crashes before the log is emptied, the recovery skips the records in the snapshot (the
+ * snapshot saves the sequence number of the next record).
+ */
+bool DurableTrapezoidalMap::saveSnapshot(){
+    if(!log.sync()) return false;
+    if(!FileUtils::saveMapSnapshot(snapshotFilename, dag, trapezoidalMap, trapezoidalMapData, sequence)) return false;
+    insertionsSinceSnapshot = 0;
+    return log.truncate();
+}
+
+/**
+ * @brief Find the segments above and below a point
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> DurableTrapezoidalMap::locate(const cg3::Point2d &q) const{
+    return algorithms::queryAboveBelow(q, dag, trapezoidalMap, trapezoidalMapData);
+}
+
+/**
+ * @brief Get the number of operations applied again from the log by the recovery
+ * @return the number of replayed insertions and removals
+ */
+size_t DurableTrapezoidalMap::getNumReplayed() const{
+    return numReplayed;
+}
+
+/**
+ * @brief Get the dataset
+ * @return the dataset
+ */
+const TrapezoidalMapDataset &DurableTrapezoidalMap::getDataset() const{
+    return trapezoidalMapData;
+}
+
+/**
+ * @brief Get the Dag
+ * @return the Dag
+ */
+const Dag &DurableTrapezoidalMap::getDag() const{
+    return dag;
+}
+
+/**
+ * @brief Get the trapezoidal map
+ * @return the trapezoidal map
+ */
+const TrapezoidalMap &DurableTrapezoidalMap::getTrapezoidalMap() const{
+    return trapezoidalMap;
+}
+
+/**
+ * @brief Load the last snapshot and apply again the operations of the log that are not in it
+ * The records of the log are in the order of the operations: the ones with a sequence number before the one of the snapshot are
+ * skipped. If a record does not follow the structures (a log not matching the snapshot) the replay stops there, and a new snapshot
+ * replaces the log. If the snapshot exists but it is not valid, the log is not opened and the files are not modified.
+ */
+void DurableTrapezoidalMap::recover(){
+    bool snapshotExists = std::ifstream(snapshotFilename).good();
+    if(!snapshotExists || !FileUtils::loadMapSnapshot(snapshotFilename, dag, trapezoidalMap, trapezoidalMapData, sequence)){
+        algorithms::initializeStructures(dag, trapezoidalMap);
+        if(snapshotExists) return;
+    }
+
+    std::vector<InsertionLog::Record> records = InsertionLog::readRecords(logFilename);
+    size_t numRead = 0;
+    for(const InsertionLog::Record &record : records){
+        if(record.sequence > sequence || (record.sequence == sequence && !replay(record))) break;
+        numRead++;
+    }
+    insertionsSinceSnapshot = numReplayed;
+    if(log.open(logFilename) && numRead < records.size()) saveSnapshot();
+}
+
+/**
+ * @brief Apply again an operation of the log
+ * @param[in] record the record of the operation, the next one of the structures
+ * @return false if the record does not follow the structures (the insertion of a segment that is not the next one or that cannot be
+ * inserted, or the removal of a segment that is not the last one)
+ * A removal undoes the insertion with the journal if the insertion was replayed, otherwise (the segment comes from the snapshot) the
+ * structures are built again without the segment.
+ */
+bool DurableTrapezoidalMap::replay(const InsertionLog::Record &record){
+    size_t numSegments = trapezoidalMapData.getIndexedSegments().size();
+    if(record.type == InsertionLog::RecordType::INSERTION){
+        if(record.segmentIdx != numSegments) return false;
+        bool inserted;
+        trapezoidalMapData.addSegment(record.segment, inserted);
+        if(!inserted) return false;
+        algorithms::buildTrapezoidalMap(record.segment, dag, trapezoidalMap, trapezoidalMapData, buildContext);
+    }else{
+        if(record.segmentIdx + 1 != numSegments || trapezoidalMapData.getSegment(record.segmentIdx) != record.segment) return false;
+        if(!journal.undoLastInsertion(dag, trapezoidalMap, trapezoidalMapData)) rebuildWithoutLastSegment();
+    }
+    sequence++;
+    numReplayed++;
+    return true;
+}
+
+/**
+ * @brief Remove the last segment from the dataset and build the structures again with the other segments, in the order of the dataset
+ */
+void DurableTrapezoidalMap::rebuildWithoutLastSegment(){
+    trapezoidalMapData.removeLastSegment();
+    journal.clear();
+    dag.clear();
+    trapezoidalMap.clear();
+    algorithms::initializeStructures(dag, trapezoidalMap);
+    for(size_t segmentIdx = 0; segmentIdx < trapezoidalMapData.getIndexedSegments().size(); segmentIdx++){
+        algorithms::buildTrapezoidalMap(trapezoidalMapData.getSegment(segmentIdx), dag, trapezoidalMap, trapezoidalMapData, buildContext);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef DURABLE_MAP_H
+#define DURABLE_MAP_H
+
+#include <cg3/geometry/segment2.h>
+#include <string>
+#include <utility>
+#include "algorithms/algorithms.h"
+#include "algorithms/point_locator.h"
+#include "data_structures/insertion_journal.h"
+#include "data_structures/insertion_log.h"
+
+// Number of insertions after which a snapshot is written and the log is emptied
+#define DURABLE_MAP_SNAPSHOT_INTERVAL 100000
+
+/**
+ * @brief Trapezoidal map that survives the crashes of the process, with a log of the insertions and periodic snapshots.
+ * Every inserted segment, and every undone insertion, is appended to the log (synced in batches, see InsertionLog). Every
+ * DURABLE_MAP_SNAPSHOT_INTERVAL insertions the structures are saved in a snapshot and the log is emptied, so the recovery loads the
+ * snapshot and applies again only the operations of the log, at most the snapshot interval, whatever the size of the map.
+ */
+class DurableTrapezoidalMap : public PointLocator{
+
+public:
+    // Constructor (recovers the map from the snapshot and the log in the directory, if they exist)
+    DurableTrapezoidalMap(const std::string &directory, size_t snapshotInterval = DURABLE_MAP_SNAPSHOT_INTERVAL);
+    // Check if the log is open (the insertions are refused if it is not)
+    bool isOpen() const;
+    // Insert a segment and append it to the log (refused if it cannot be logged)
+    bool insertSegment(const cg3::Segment2d &segment);
+    // Undo the last insertion and append the removal to the log (refused if it cannot be logged)
+    bool undoLastInsertion();
+    // Wait for the logged insertions to be on the disk
+    bool sync();
+    // Save a snapshot of the structures and empty the log
+    bool saveSnapshot();
+    // Find the segment above (first) and below (second) a point
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+    // Get the number of operations applied again from the log by the recovery
+    size_t getNumReplayed() const;
+    // Get the structures
+    const TrapezoidalMapDataset &getDataset() const;
+    const Dag &getDag() const;
+    const TrapezoidalMap &getTrapezoidalMap() const;
+
+private:
+    DurableTrapezoidalMap(const DurableTrapezoidalMap &);
+    DurableTrapezoidalMap &operator=(const DurableTrapezoidalMap &);
+
+    void recover();
+    bool replay(const InsertionLog::Record &record);
+    void rebuildWithoutLastSegment();
+
+    std::string snapshotFilename;
+    std::string logFilename;
+    size_t snapshotInterval;
+    size_t numReplayed;
+    size_t insertionsSinceSnapshot;
+    uint64_t sequence;              // Number of the logged operations applied to the structures
+
+    TrapezoidalMapDataset trapezoidalMapData;
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    algorithms::BuildContext buildContext;
+    InsertionJournal journal;
+    InsertionLog log;
+};
+
+#endif // DURABLE_MAP_H
@@ -0,0 +1,68 @@
+#include "live_map.h"
+#include "algorithms.h"
+
+#define BOUNDINGBOX 1e+6
+
+/**
+ * @brief Constructor, initializes the structures with the bounding box and publishes them
+ */
+LiveTrapezoidalMap::LiveTrapezoidalMap() :
+    trapezoidalMap(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX)), version(0){
+    algorithms::initializeStructures(dag, trapezoidalMap);
+    publish();
+}
+
+/**
+ * @brief Insert a segment in the map of the writer
+ * @param[in] segment the segment
+ * @return false if the segment was not inserted (it is a duplicate or it intersects the other segments)
+ * The points and the segment added to the dataset are appended to the geometry shared with the snapshots
+ */
+bool LiveTrapezoidalMap::insertSegment(const cg3::Segment2d &segment){
+    bool inserted;
+    trapezoidalMapData.addSegment(segment, inserted);
+    if(!inserted) return false;
+
+    for(size_t pointIdx = points.size(); pointIdx < trapezoidalMapData.getPoints().size(); pointIdx++){
+        points.push_back(trapezoidalMapData.getPoint(pointIdx));
+    }
+    indexedSegments.push_back(trapezoidalMapData.getIndexedSegments().back());
+    algorithms::buildTrapezoidalMap(segment, dag, trapezoidalMap, trapezoidalMapData, buildContext);
+    return true;
+}
+
+/**
+ * @brief Publish a snapshot of the writer structures
+ * The snapshot shares the chunks of the structures, the next insertions copy the chunks they modify
+ */
+void LiveTrapezoidalMap::publish(){
+    publisher.publish(new MapSnapshot(dag, trapezoidalMap, points, indexedSegments, version++));
+}
+
+/**
+ * @brief Find the segments above and below a point on the last published snapshot
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> LiveTrapezoidalMap::locate(const cg3::Point2d &q) const{
+    SnapshotPublisher::ReadGuard guard(publisher);
+    const MapSnapshot &snapshot = *guard.getSnapshot();
+    const Trapezoid &trapezoid = snapshot.getTrapezoidalMap().getTrapezoid(algorithms::queryPoint(q, snapshot));
+    return std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx());
+}
+
+/**
+ * @brief Get the publisher of the snapshots
+ * @return the publisher
+ */
+const SnapshotPublisher &LiveTrapezoidalMap::getPublisher() const{
+    return publisher;
+}
+
+/**
+ * @brief Get the dataset of the writer
+ * @return the dataset
+ */
+const TrapezoidalMapDataset &LiveTrapezoidalMap::getDataset() const{
+    return trapezoidalMapData;
+}
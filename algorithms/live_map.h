@@ -0,0 +1,47 @@
+#ifndef LIVE_MAP_H
+#define LIVE_MAP_H
+
+#include <cg3/geometry/segment2.h>
+#include <utility>
+#include "algorithms/algorithms.h"
+#include "algorithms/point_locator.h"
+#include "data_structures/chunked_vector.h"
+#include "data_structures/snapshot_publisher.h"
+
+/**
+ * @brief Trapezoidal map that serves queries from many threads while a writer inserts segments.
+ * The writer builds the map incrementally on its own structures and publishes a snapshot of them, the queries run on the last
+ * published snapshot without locks. The segments inserted become visible to the queries when they are published.
+ * The insertions and the publications must be done by a single thread.
+ */
+class LiveTrapezoidalMap : public PointLocator{
+
+public:
+    // Constructor (publishes the empty map)
+    LiveTrapezoidalMap();
+    // Insert a segment in the writer structures
+    bool insertSegment(const cg3::Segment2d &segment);
+    // Publish the segments inserted since the last publication
+    void publish();
+    // Find the segment above (first) and below (second) a point on the last published version
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+    // Get the publisher, to take a snapshot for several queries on the same version
+    const SnapshotPublisher &getPublisher() const;
+    // Get the dataset of the writer
+    const TrapezoidalMapDataset &getDataset() const;
+
+private:
+    // Writer structures
+    TrapezoidalMapDataset trapezoidalMapData;
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    ChunkedVector<cg3::Point2d> points;
+    ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> indexedSegments;
+    algorithms::BuildContext buildContext;
+    size_t version;
+
+    SnapshotPublisher publisher;
+};
+
+#endif // LIVE_MAP_H
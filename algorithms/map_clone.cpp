@@ -0,0 +1,210 @@
+#include "map_clone.h"
+#include "algorithms.h"
+#include "dag_traversal.h"
+#include <cmath>
+#include <limits>
+#include "data_structures/segment_intersection_checker.h"
+
+#define BOUNDINGBOX 1e+6
+
+/**
+ * @brief Constructor, copies the structures of a built map
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * The Dag and the trapezoidal map share their chunks with the given ones. The points, the segments and the lookup tables of the
+ * dataset are copied once, and shared by the clones of this map.
+ */
+MapClone::MapClone(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData) :
+    dag(dag), trapezoidalMap(trapezoidalMap){
+    std::shared_ptr<LookupTables> tables = std::make_shared<LookupTables>();
+    const std::vector<cg3::Point2d> &datasetPoints = trapezoidalMapData.getPoints();
+    const std::vector<TrapezoidalMapDataset::IndexedSegment2d> &datasetSegments = trapezoidalMapData.getIndexedSegments();
+    points.reserve(datasetPoints.size());
+    indexedSegments.reserve(datasetSegments.size());
+    for(size_t pointIdx = 0; pointIdx < datasetPoints.size(); pointIdx++){
+        points.push_back(datasetPoints[pointIdx]);
+        tables->pointMap[datasetPoints[pointIdx]] = pointIdx;
+        tables->xCoordSet.insert(datasetPoints[pointIdx].x());
+    }
+    for(size_t segmentIdx = 0; segmentIdx < datasetSegments.size(); segmentIdx++){
+        indexedSegments.push_back(datasetSegments[segmentIdx]);
+        tables->segmentMap[datasetSegments[segmentIdx]] = segmentIdx;
+    }
+    datasetTables = tables;
+}
+
+/**
+ * @brief Get a clone of this map
+ * @return the clone, sharing all the chunks of the structures with this map
+ * The clone costs the chunk tables and the tables of the segments inserted in this map: the insertions in one of the two maps copy
+ * the chunks they write, so they are not seen by the other one.
+ */
+MapClone MapClone::clone() const{
+    return *this;
+}
+
+/**
+ * @brief Insert a segment in this map, the maps it was cloned from and its clones do not change
+ * @param[in] segment the segment
+ * @return false if the segment was not inserted: it is degenerate or a duplicate, its endpoints are not in general position
+ * (a new point with the x coordinate of another point) or outside the bounding box, or it intersects a segment of the map
+ */
+bool MapClone::insertSegment(const cg3::Segment2d &segment){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    cg3::Segment2d orderedSegment = segment;
+    if(segment.p2() < segment.p1()){
+        orderedSegment.setP1(segment.p2());
+        orderedSegment.setP2(segment.p1());
+    }
+    const cg3::Point2d &p1 = orderedSegment.p1();
+    const cg3::Point2d &p2 = orderedSegment.p2();
+    if(p1.x() == p2.x()) return false;
+    if(std::abs(p1.x()) >= BOUNDINGBOX || std::abs(p1.y()) >= BOUNDINGBOX || std::abs(p2.x()) >= BOUNDINGBOX || std::abs(p2.y()) >= BOUNDINGBOX) return false;
+
+    size_t pointIdx1 = findPoint(p1);
+    size_t pointIdx2 = findPoint(p2);
+    if(pointIdx1 != nullIdx && pointIdx2 != nullIdx && findSegment(pointIdx1, pointIdx2)) return false;
+    if(pointIdx1 == nullIdx && findXCoord(p1.x())) return false;
+    if(pointIdx2 == nullIdx && findXCoord(p2.x())) return false;
+    if(intersectsMap(orderedSegment)) return false;
+
+    algorithms::SegmentIndexes indexes;
+    indexes.segmentIdx = indexedSegments.size();
+    indexes.leftPointIdx = pointIdx1 != nullIdx ? pointIdx1 : addPoint(p1);
+    indexes.rightPointIdx = pointIdx2 != nullIdx ? pointIdx2 : addPoint(p2);
+    TrapezoidalMapDataset::IndexedSegment2d indexedSegment(indexes.leftPointIdx, indexes.rightPointIdx);
+    if(indexedSegment.second < indexedSegment.first) std::swap(indexedSegment.first, indexedSegment.second);
+    indexedSegments.push_back(indexedSegment);
+    addedTables.segmentMap[indexedSegment] = indexes.segmentIdx;
+
+    algorithms::InsertionSlots slots = {trapezoidalMap.numTrapezoids(), dag.numNodes()};
+    algorithms::insertSegment(orderedSegment, indexes, intersectedTrapezoids, slots, dag, trapezoidalMap);
+    return true;
+}
+
+/**
+ * @brief Find the segments above and below a point
+ * @param[in] q the query point
+ * @return the index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> MapClone::locate(const cg3::Point2d &q) const{
+    const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(algorithms::traverseDag(dag, *this, algorithms::PointPolicy(q)));
+    return std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx());
+}
+
+/**
+ * @brief Get the Dag
+ * @return the Dag
+ */
+const Dag &MapClone::getDag() const{
+    return dag;
+}
+
+/**
+ * @brief Get the trapezoidal map
+ * @return the trapezoidal map
+ */
+const TrapezoidalMap &MapClone::getTrapezoidalMap() const{
+    return trapezoidalMap;
+}
+
+/**
+ * @brief Get a point given its index
+ * @param[in] idx the index of the point
+ * @return the point
+ */
+const cg3::Point2d &MapClone::getPoint(size_t idx) const{
+    return points[idx];
+}
+
+/**
+ * @brief Get a segment given its index
+ * @param[in] idx the index of the segment
+ * @return the segment
+ */
+cg3::Segment2d MapClone::getSegment(size_t idx) const{
+    const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment = indexedSegments[idx];
+    return cg3::Segment2d(points[indexedSegment.first], points[indexedSegment.second]);
+}
+
+/**
+ * @brief Get the number of segments
+ * @return the number of segments of the dataset and of the ones inserted in the clone
+ */
+size_t MapClone::numSegments() const{
+    return indexedSegments.size();
+}
+
+/**
+ * @brief Find a point in the dataset and in the inserted points
+ * @param[in] point the point
+ * @return the index of the point, the null index if it does not exist
+ */
+size_t MapClone::findPoint(const cg3::Point2d &point) const{
+    std::unordered_map<cg3::Point2d, size_t>::const_iterator it = datasetTables->pointMap.find(point);
+    if(it != datasetTables->pointMap.end()) return it->second;
+    it = addedTables.pointMap.find(point);
+    if(it != addedTables.pointMap.end()) return it->second;
+    return std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief Check if a segment exists, given the indexes of its endpoints
+ * @param[in] pointIdx1 the index of an endpoint
+ * @param[in] pointIdx2 the index of the other endpoint
+ * @return true if the segment exists
+ */
+bool MapClone::findSegment(size_t pointIdx1, size_t pointIdx2) const{
+    TrapezoidalMapDataset::IndexedSegment2d indexedSegment(pointIdx1, pointIdx2);
+    if(indexedSegment.second < indexedSegment.first) std::swap(indexedSegment.first, indexedSegment.second);
+    return datasetTables->segmentMap.count(indexedSegment) != 0 || addedTables.segmentMap.count(indexedSegment) != 0;
+}
+
+/**
+ * @brief Check if a point has a given x coordinate
+ * @param[in] x the x coordinate
+ * @return true if a point has the x coordinate
+ */
+bool MapClone::findXCoord(double x) const{
+    return datasetTables->xCoordSet.count(x) != 0 || addedTables.xCoordSet.count(x) != 0;
+}
+
+/**
+ * @brief Add a point inserted in the clone
+ * @param[in] point the point
+ * @return the index of the point
+ */
+size_t MapClone::addPoint(const cg3::Point2d &point){
+    size_t pointIdx = points.size();
+    points.push_back(point);
+    addedTables.pointMap[point] = pointIdx;
+    addedTables.xCoordSet.insert(point.x());
+    return pointIdx;
+}
+
+/**
+ * @brief Find the trapezoids intersected by a segment, checking that it does not intersect the segments of the map
+ * @param[in] segment the segment, with p1 as left endpoint
+ * @return true if the segment intersects a segment of the map
+ * The walk of followSegment visits the trapezoids crossed by the segment up to the first intersection: the intersected segment is
+ * the top or the bottom of the last trapezoid reached, so checking the top and the bottom of the trapezoids of the walk finds it
+ * without an intersection checker. If there is no intersection, the walk leaves the intersected trapezoids in the scratch buffer.
+ */
+bool MapClone::intersectsMap(const cg3::Segment2d &segment){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    // The walk only reads the map: the non-const getTrapezoid would copy the chunks shared with the other clones
+    const TrapezoidalMap &sharedMap = trapezoidalMap;
+    intersectedTrapezoids.clear();
+    size_t trapezoidIdx = algorithms::traverseDag(dag, *this, algorithms::SegmentPolicy(segment));
+    while(true){
+        const Trapezoid &trapezoid = sharedMap.getTrapezoid(trapezoidIdx);
+        if(trapezoid.getTopSegmentIdx() != nullIdx && SegmentIntersectionChecker::checkSegmentIntersection(segment, trapezoid.getTopSegment())) return true;
+        if(trapezoid.getBottomSegmentIdx() != nullIdx && SegmentIntersectionChecker::checkSegmentIntersection(segment, trapezoid.getBottomSegment())) return true;
+        intersectedTrapezoids.push_back(trapezoidIdx);
+
+        cg3::Point2d rightPoint = trapezoid.getRightPoint();
+        if(segment.p2().x() <= rightPoint.x()) return false;
+        trapezoidIdx = ProjectUtils::isPointAbove(segment, rightPoint) ? trapezoid.getLowerRightNeighbor() : trapezoid.getUpperRightNeighbor();
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef MAP_CLONE_H
+#define MAP_CLONE_H
+
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/segment2.h>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "algorithms/point_locator.h"
+#include "data_structures/chunked_vector.h"
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief This class defines a copy of a built trapezoidal map in which segments can be inserted without changing the original map.
+ * The Dag, the trapezoidal map and the geometry of the dataset are chunked vectors: a clone shares all their chunks with the map it was
+ * cloned from and copies a chunk only the first time an insertion writes it, so a clone costs the chunk tables plus the chunks written
+ * by its own insertions. The lookup tables of the original dataset are built once and shared by all the clones, a clone has its own
+ * tables only for the segments inserted in it.
+ * The insertions check the segments as the dataset does, with the map itself instead of the intersection checker of the dataset.
+ */
+class MapClone : public PointLocator{
+
+public:
+    // Constructor (copies the structures sharing their chunks, the geometry of the dataset is copied once for all the clones)
+    MapClone(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+    // Get a clone of this map (it shares all the chunks with this one)
+    MapClone clone() const;
+    // Insert a segment in this map only
+    bool insertSegment(const cg3::Segment2d &segment);
+    // Find the segment above (first) and below (second) a point
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+    // Get the Dag
+    const Dag &getDag() const;
+    // Get the trapezoidal map
+    const TrapezoidalMap &getTrapezoidalMap() const;
+    // Get a point given its index (the points of the dataset, then the ones added to the clone)
+    const cg3::Point2d &getPoint(size_t idx) const;
+    // Get a segment given its index (the segments of the dataset, then the ones added to the clone)
+    cg3::Segment2d getSegment(size_t idx) const;
+    // Get the number of segments
+    size_t numSegments() const;
+
+private:
+    /**
+     * @brief Lookup tables of the points and of the segments, as in the dataset
+     */
+    struct LookupTables{
+        std::unordered_map<cg3::Point2d, size_t> pointMap;
+        std::unordered_map<TrapezoidalMapDataset::IndexedSegment2d, size_t> segmentMap;
+        std::unordered_set<double> xCoordSet;
+    };
+
+    size_t findPoint(const cg3::Point2d &point) const;
+    bool findSegment(size_t pointIdx1, size_t pointIdx2) const;
+    bool findXCoord(double x) const;
+    size_t addPoint(const cg3::Point2d &point);
+    bool intersectsMap(const cg3::Segment2d &segment);
+
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    ChunkedVector<cg3::Point2d> points;
+    ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> indexedSegments;
+    std::shared_ptr<const LookupTables> datasetTables;  // Tables of the original dataset, shared by all the clones
+    LookupTables addedTables;                           // Tables of the segments inserted in the clones
+    std::vector<size_t> intersectedTrapezoids;          // Scratch buffer of the insertions
+};
+
+#endif // MAP_CLONE_H
@@ -0,0 +1,395 @@
+#include "parallel_build.h"
+#include "algorithms.h"
+#include "dag_traversal.h"
+#include "utils/projectUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <thread>
+
+#define BOUNDINGBOX 1e+6
+
+namespace algorithms{
+
+/**
+ * @brief Map and Dag of a slab, built on the segments crossing the slab
+ */
+struct SlabBuild{
+    double xLeft, xRight;           // The slab is [xLeft, xRight)
+    std::vector<size_t> segments;   // Dataset indexes of the segments crossing the slab
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    std::vector<size_t> globalIdx;  // Index in the joined map of every trapezoid of the slab (null index if it lies outside the slab)
+
+    SlabBuild() : xLeft(-BOUNDINGBOX), xRight(BOUNDINGBOX), trapezoidalMap(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX)){}
+};
+
+/**
+ * @brief Edge of a trapezoid on the vertical line between two slabs
+ */
+struct BoundaryEdge{
+    double bottomY, topY;
+    size_t trapezoidIdx;
+    bool operator<(const BoundaryEdge &other) const{ return bottomY < other.bottomY || (bottomY == other.bottomY && topY < other.topY); }
+};
+
+/**
+ * @brief Insert in the map of a slab the part of a segment crossing the slab
+ * @param[in] segmentIdx the dataset index of the segment
+ * @param[in] slab the slab
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure (only read)
+ * @param[in] context the scratch buffers of the insertions
+ * An end of the segment beyond the slab is open: the part starts on the left boundary, in the trapezoid located just to the right of
+ * the boundary with the order of the segments (exact, no point is computed on the boundary), and the walk stops at the trapezoid
+ * reaching the right boundary. An open end has no x-node, so the points of the slab are the endpoints inside it or on its boundaries,
+ * and the segments keep their dataset geometry and indexes.
+ */
+void insertSegmentPart(size_t segmentIdx, SlabBuild &slab, TrapezoidalMapDataset &trapezoidalMapData, BuildContext &context){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    cg3::Segment2d segment = trapezoidalMapData.getSegment(segmentIdx);
+    ProjectUtils::orderSegment(segment);
+    bool openLeft = segment.p1().x() < slab.xLeft, openRight = segment.p2().x() > slab.xRight;
+    SegmentIndexes indexes = {segmentIdx, nullIdx, nullIdx};
+    bool found = false;
+    if(!openLeft) indexes.leftPointIdx = trapezoidalMapData.findPoint(segment.p1(), found);
+    if(!openRight) indexes.rightPointIdx = trapezoidalMapData.findPoint(segment.p2(), found);
+
+    // Walk from the first trapezoid through the right neighbors, as followSegment, up to the right end of the part
+    std::vector<size_t> &intersectedTrapezoids = context.intersectedTrapezoids;
+    intersectedTrapezoids.clear();
+    size_t trapezoidIdx = openLeft ? traverseDag(slab.dag, trapezoidalMapData, AboveSegmentPolicy(slab.xLeft, nullIdx, segment)) :
+                                     querySegment(segment, slab.dag, trapezoidalMapData);
+    intersectedTrapezoids.push_back(trapezoidIdx);
+    double xEnd = openRight ? slab.xRight : segment.p2().x();
+    cg3::Point2d rightPoint = slab.trapezoidalMap.getTrapezoid(trapezoidIdx).getRightPoint();
+    while(xEnd > rightPoint.x()){
+        const Trapezoid &trapezoid = slab.trapezoidalMap.getTrapezoid(trapezoidIdx);
+        trapezoidIdx = ProjectUtils::isPointAbove(segment, rightPoint) ? trapezoid.getLowerRightNeighbor() : trapezoid.getUpperRightNeighbor();
+        intersectedTrapezoids.push_back(trapezoidIdx);
+        rightPoint = slab.trapezoidalMap.getTrapezoid(trapezoidIdx).getRightPoint();
+    }
+
+    InsertionSlots slots = {slab.trapezoidalMap.numTrapezoids(), slab.dag.numNodes()};
+    insertSegment(segment, indexes, intersectedTrapezoids, slots, slab.dag, slab.trapezoidalMap);
+}
+
+/**
+ * @brief Build the map and the Dag of a slab with the randomized incremental algorithm
+ * @param[in] slab the slab, with the segments crossing it
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure (only read, so it is shared by the slabs)
+ * @param[in] seed the seed of the random insertion order
+ * The parts of the segments inside the slab are inserted (see insertSegmentPart). Inside the slab the map is the same as the map of
+ * all the segments: the segments not crossing the slab do not reach it, and the parts outside it do not change the trapezoids inside.
+ */
+void buildSlab(SlabBuild &slab, TrapezoidalMapDataset &trapezoidalMapData, unsigned int seed){
+    initializeStructures(slab.dag, slab.trapezoidalMap);
+    std::mt19937 randomGenerator(seed);
+    std::shuffle(slab.segments.begin(), slab.segments.end(), randomGenerator);
+    BuildContext context;
+    for(size_t segmentIdx : slab.segments) insertSegmentPart(segmentIdx, slab, trapezoidalMapData, context);
+}
+
+/**
+ * @brief Add the x-nodes choosing the slab of a point, as a balanced tree on the boundaries of the slabs
+ * @param[in] firstSlab @param[in] lastSlab the range of slabs [firstSlab, lastSlab)
+ * @param[in] boundaryPoints the dataset index of the point on the left boundary of every slab
+ * @param[in] slabRoots the index in the joined Dag of the root of every slab
+ * @param[in] dag The DAG search structure
+ * @return the index of the root of the tree
+ */
+size_t addBoundaryTree(size_t firstSlab, size_t lastSlab, const std::vector<size_t> &boundaryPoints, const std::vector<size_t> &slabRoots, Dag &dag){
+    if(lastSlab - firstSlab == 1) return slabRoots[firstSlab];
+
+    // The node is added before its children, so the root of the tree is the first node
+    size_t nodeIdx = dag.numNodes();
+    Node placeholder = Node(Node::NodeType::LEAF, 0, 0, 0);
+    dag.addNode(placeholder);
+    size_t middleSlab = (firstSlab + lastSlab) / 2;
+    size_t leftIdx = addBoundaryTree(firstSlab, middleSlab, boundaryPoints, slabRoots, dag);
+    size_t rightIdx = addBoundaryTree(middleSlab, lastSlab, boundaryPoints, slabRoots, dag);
+    Node xNode = Node(Node::NodeType::X, boundaryPoints[middleSlab], leftIdx, rightIdx);
+    dag.replaceNode(xNode, nodeIdx);
+    return nodeIdx;
+}
+
+/**
+ * @brief Set the right neighbors of a trapezoid ending on a slab boundary
+ * @param[in] trapezoid the trapezoid
+ * @param[in] neighbors the trapezoids of the next slab sharing a part of its right edge, from the bottom to the top
+ * A single neighbor takes both the slots, except the slot of a top or bottom segment ending at the right point (null, as in the
+ * incremental construction), so the walk of followSegment can continue across the boundary.
+ */
+void setRightNeighbors(Trapezoid &trapezoid, const std::vector<size_t> &neighbors){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    assert(neighbors.size() <= 2);
+    if(neighbors.size() == 2){
+        trapezoid.setLowerRightNeighbor(neighbors[0]);
+        trapezoid.setUpperRightNeigbor(neighbors[1]);
+    }else if(neighbors.size() == 1){
+        trapezoid.setLowerRightNeighbor(ProjectUtils::rightPointEqualBottomRightEndpoint(trapezoid) ? nullIdx : neighbors[0]);
+        trapezoid.setUpperRightNeigbor(ProjectUtils::rightPointEqualTopRightEndpoint(trapezoid) ? nullIdx : neighbors[0]);
+    }else{
+        trapezoid.setLowerRightNeighbor(nullIdx);
+        trapezoid.setUpperRightNeigbor(nullIdx);
+    }
+}
+
+/**
+ * @brief Set the left neighbors of a trapezoid starting on a slab boundary
+ * @param[in] trapezoid the trapezoid
+ * @param[in] neighbors the trapezoids of the previous slab sharing a part of its left edge, from the bottom to the top
+ */
+void setLeftNeighbors(Trapezoid &trapezoid, const std::vector<size_t> &neighbors){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    assert(neighbors.size() <= 2);
+    if(neighbors.size() == 2){
+        trapezoid.setLowerLeftNeighbor(neighbors[0]);
+        trapezoid.setUpperLeftNeighbor(neighbors[1]);
+    }else if(neighbors.size() == 1){
+        trapezoid.setLowerLeftNeighbor(ProjectUtils::leftPointEqualBottomLeftEndpoint(trapezoid) ? nullIdx : neighbors[0]);
+        trapezoid.setUpperLeftNeighbor(ProjectUtils::leftPointEqualTopLeftEndpoint(trapezoid) ? nullIdx : neighbors[0]);
+    }else{
+        trapezoid.setLowerLeftNeighbor(nullIdx);
+        trapezoid.setUpperLeftNeighbor(nullIdx);
+    }
+}
+
+/**
+ * @brief Link the trapezoids on the two sides of a slab boundary
+ * @param[in] leftEdges the right edges of the trapezoids of the left slab on the boundary
+ * @param[in] rightEdges the left edges of the trapezoids of the right slab on the boundary
+ * @param[in] pieces the trapezoids of all the slabs
+ * @param[out] merges the pairs (left, right) of trapezoids that are the two parts of a trapezoid cut by the boundary
+ * The segments crossing the boundary are in both the slabs, so they cut the boundary at the same heights on both sides: two edges
+ * overlapping by a positive length are neighbors. The edges of a single point (the triangles at a boundary point) have no neighbor.
+ * Two trapezoids that are the only neighbor of each other, between the same segments, are not separated by the wall of the boundary
+ * point: they are the parts of one trapezoid of the map.
+ */
+void stitchBoundary(std::vector<BoundaryEdge> &leftEdges, std::vector<BoundaryEdge> &rightEdges, std::vector<Trapezoid> &pieces,
+                    std::vector<std::pair<size_t, size_t>> &merges){
+    std::sort(leftEdges.begin(), leftEdges.end());
+    std::sort(rightEdges.begin(), rightEdges.end());
+    std::vector<std::vector<size_t>> leftNeighbors(rightEdges.size()), rightNeighbors(leftEdges.size());
+
+    size_t leftPos = 0, rightPos = 0;
+    while(leftPos < leftEdges.size() && rightPos < rightEdges.size()){
+        const BoundaryEdge &leftEdge = leftEdges[leftPos], &rightEdge = rightEdges[rightPos];
+        if(std::min(leftEdge.topY, rightEdge.topY) > std::max(leftEdge.bottomY, rightEdge.bottomY)){
+            rightNeighbors[leftPos].push_back(rightEdge.trapezoidIdx);
+            leftNeighbors[rightPos].push_back(leftEdge.trapezoidIdx);
+            if(leftEdge.bottomY == rightEdge.bottomY && leftEdge.topY == rightEdge.topY){
+                const Trapezoid &left = pieces[leftEdge.trapezoidIdx], &right = pieces[rightEdge.trapezoidIdx];
+                if(left.getTopSegmentIdx() == right.getTopSegmentIdx() && left.getBottomSegmentIdx() == right.getBottomSegmentIdx()){
+                    merges.push_back(std::make_pair(leftEdge.trapezoidIdx, rightEdge.trapezoidIdx));
+                }
+            }
+        }
+        // Move past the edge ending first
+        if(leftEdge.topY < rightEdge.topY) leftPos++;
+        else if(rightEdge.topY < leftEdge.topY) rightPos++;
+        else{
+            leftPos++;
+            rightPos++;
+        }
+    }
+
+    for(size_t i = 0; i < leftEdges.size(); i++) setRightNeighbors(pieces[leftEdges[i].trapezoidIdx], rightNeighbors[i]);
+    for(size_t i = 0; i < rightEdges.size(); i++) setLeftNeighbors(pieces[rightEdges[i].trapezoidIdx], leftNeighbors[i]);
+}
+
+/**
+ * @brief Build the Trapezoidal Map and the DAG of all the segments of the dataset in parallel
+ * @param[in] dag The DAG search structure (its content is replaced)
+ * @param[in] trapezoidalMap The trapezoidal Map data structure (its content is replaced)
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * @param[in] numSlabs the number of vertical slabs
+ * @param[in] numThreads the number of threads building the slabs (0 for the number of cores)
+ * @param[out] stats if not null, the number of segment parts inserted in the slabs and the time of the phases
+ * The x-range is split in slabs with the same number of endpoints, the boundaries are endpoints of the dataset. Every slab builds
+ * the map and the Dag of the parts of the segments crossing it, concurrently, then the slabs are joined: the trapezoids outside their
+ * slab are dropped, the trapezoids on the two sides of a boundary are linked as neighbors (or joined, if the boundary cuts a trapezoid
+ * of the map), and the Dags of the slabs are put under a balanced tree of x-nodes on the boundary points.
+ * A segment crossing k slabs is inserted in each of them, and only the part inside the slab is walked, so no segment is left to a
+ * sequential phase; every part still costs a location in the Dag of its slab and a few trapezoids and nodes, so the work (and the
+ * joined Dag) grows with the parts per segment (see benchmarks/bench_parallel_build.cpp).
+ * The joined map has the same trapezoids as the sequential construction (the trapezoidal map of a set of segments is unique),
+ * so it can be updated with buildTrapezoidalMap.
+ */
+void buildTrapezoidalMapParallel(Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, size_t numSlabs, size_t numThreads,
+                                 ParallelBuildStats *stats){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    dag.clear();
+    trapezoidalMap.clear();
+
+    // Boundaries: the endpoints splitting the points sorted by x in slabs of the same size
+    const std::vector<cg3::Point2d> &points = trapezoidalMapData.getPoints();
+    if(points.empty()) numSlabs = 1;
+    std::vector<size_t> pointsByX(points.size());
+    for(size_t i = 0; i < points.size(); i++) pointsByX[i] = i;
+    std::sort(pointsByX.begin(), pointsByX.end(), [&points](size_t a, size_t b){ return points[a].x() < points[b].x(); });
+    std::vector<size_t> boundaryPoints(1, nullIdx);
+    for(size_t slabIdx = 1; slabIdx < numSlabs; slabIdx++){
+        size_t pointIdx = pointsByX[slabIdx * pointsByX.size() / numSlabs];
+        if(boundaryPoints.back() != pointIdx) boundaryPoints.push_back(pointIdx);
+    }
+    numSlabs = boundaryPoints.size();
+    std::vector<double> boundaryX(numSlabs - 1);
+    std::vector<SlabBuild> slabs(numSlabs);
+    for(size_t slabIdx = 1; slabIdx < numSlabs; slabIdx++){
+        boundaryX[slabIdx - 1] = points[boundaryPoints[slabIdx]].x();
+        slabs[slabIdx].xLeft = boundaryX[slabIdx - 1];
+        slabs[slabIdx - 1].xRight = boundaryX[slabIdx - 1];
+    }
+
+    // A segment crosses the slabs from the one containing its left endpoint to the one with its right endpoint inside or on the right boundary
+    size_t numParts = 0;
+    for(size_t segmentIdx = 0; segmentIdx < trapezoidalMapData.getIndexedSegments().size(); segmentIdx++){
+        cg3::Segment2d segment = trapezoidalMapData.getSegment(segmentIdx);
+        ProjectUtils::orderSegment(segment);
+        size_t firstSlab = std::upper_bound(boundaryX.begin(), boundaryX.end(), segment.p1().x()) - boundaryX.begin();
+        size_t lastSlab = std::lower_bound(boundaryX.begin(), boundaryX.end(), segment.p2().x()) - boundaryX.begin();
+        for(size_t slabIdx = firstSlab; slabIdx <= lastSlab; slabIdx++) slabs[slabIdx].segments.push_back(segmentIdx);
+        numParts += lastSlab - firstSlab + 1;
+    }
+    double partitionTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+
+    // Build the slabs, each thread takes the next slab not yet built
+    if(numThreads == 0) numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numSlabs);
+    std::atomic<size_t> nextSlab(0);
+    std::vector<std::thread> threads;
+    for(size_t threadIdx = 0; threadIdx < numThreads; threadIdx++){
+        threads.emplace_back([&slabs, &trapezoidalMapData, &nextSlab](){
+            for(size_t slabIdx = nextSlab++; slabIdx < slabs.size(); slabIdx = nextSlab++){
+                buildSlab(slabs[slabIdx], trapezoidalMapData, static_cast<unsigned int>(slabIdx));
+            }
+        });
+    }
+    for(std::thread &thread : threads) thread.join();
+    double slabsTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+
+    // Trapezoids of the slabs inside their slab (pieces), and offset of the nodes of the slabs after the x-nodes of the boundaries
+    size_t numPieces = 0;
+    std::vector<size_t> nodeOffset(numSlabs);
+    size_t numNodes = numSlabs - 1;
+    for(size_t slabIdx = 0; slabIdx < numSlabs; slabIdx++){
+        SlabBuild &slab = slabs[slabIdx];
+        const TrapezoidalMap &slabMap = slab.trapezoidalMap;
+        slab.globalIdx.assign(slabMap.numTrapezoids(), nullIdx);
+        for(size_t trapezoidIdx = 0; trapezoidIdx < slabMap.numTrapezoids(); trapezoidIdx++){
+            const Trapezoid &trapezoid = slabMap.getTrapezoid(trapezoidIdx);
+            if(trapezoid.getLeftPoint().x() < slab.xRight && trapezoid.getRightPoint().x() > slab.xLeft) slab.globalIdx[trapezoidIdx] = numPieces++;
+        }
+        nodeOffset[slabIdx] = numNodes;
+        numNodes += slab.dag.numNodes();
+    }
+
+    // Pieces with the indexes of the joined structures, and their edges on the boundaries
+    std::vector<Trapezoid> pieces;
+    pieces.reserve(numPieces);
+    std::vector<std::vector<BoundaryEdge>> leftEdges(numSlabs), rightEdges(numSlabs);
+    for(size_t slabIdx = 0; slabIdx < numSlabs; slabIdx++){
+        const SlabBuild &slab = slabs[slabIdx];
+        for(size_t trapezoidIdx = 0; trapezoidIdx < slab.globalIdx.size(); trapezoidIdx++){
+            size_t pieceIdx = slab.globalIdx[trapezoidIdx];
+            if(pieceIdx == nullIdx) continue;
+            Trapezoid trapezoid = slab.trapezoidalMap.getTrapezoid(trapezoidIdx);
+            trapezoid.setUpperLeftNeighbor(trapezoid.getUpperLeftNeighbor() == nullIdx ? nullIdx : slab.globalIdx[trapezoid.getUpperLeftNeighbor()]);
+            trapezoid.setLowerLeftNeighbor(trapezoid.getLowerLeftNeighbor() == nullIdx ? nullIdx : slab.globalIdx[trapezoid.getLowerLeftNeighbor()]);
+            trapezoid.setUpperRightNeigbor(trapezoid.getUpperRightNeighbor() == nullIdx ? nullIdx : slab.globalIdx[trapezoid.getUpperRightNeighbor()]);
+            trapezoid.setLowerRightNeighbor(trapezoid.getLowerRightNeighbor() == nullIdx ? nullIdx : slab.globalIdx[trapezoid.getLowerRightNeighbor()]);
+            trapezoid.setNodeIdx(trapezoid.getNodeIdx() + nodeOffset[slabIdx]);
+
+            if(slabIdx > 0 && trapezoid.getLeftPoint().x() <= slab.xLeft){
+                BoundaryEdge edge = {ProjectUtils::segmentYAt(trapezoid.getBottomSegment(), slab.xLeft), ProjectUtils::segmentYAt(trapezoid.getTopSegment(), slab.xLeft), pieceIdx};
+                rightEdges[slabIdx].push_back(edge);
+                // If the part is not joined with the one on the other side, the boundary is the wall of the boundary point
+                trapezoid.setLeftPoint(points[boundaryPoints[slabIdx]]);
+            }
+            if(slabIdx + 1 < numSlabs && trapezoid.getRightPoint().x() >= slab.xRight){
+                BoundaryEdge edge = {ProjectUtils::segmentYAt(trapezoid.getBottomSegment(), slab.xRight), ProjectUtils::segmentYAt(trapezoid.getTopSegment(), slab.xRight), pieceIdx};
+                leftEdges[slabIdx + 1].push_back(edge);
+                trapezoid.setRightPoint(points[boundaryPoints[slabIdx + 1]]);
+            }
+            pieces.push_back(trapezoid);
+        }
+    }
+
+    // Stitch the boundaries, then join the parts of the trapezoids cut by the boundaries, from left to right: the first part takes
+    // the right side of the others
+    std::vector<std::pair<size_t, size_t>> merges;
+    for(size_t slabIdx = 1; slabIdx < numSlabs; slabIdx++) stitchBoundary(leftEdges[slabIdx], rightEdges[slabIdx], pieces, merges);
+    std::vector<size_t> firstPart(numPieces);
+    for(size_t pieceIdx = 0; pieceIdx < numPieces; pieceIdx++) firstPart[pieceIdx] = pieceIdx;
+    for(const std::pair<size_t, size_t> &merge : merges){
+        size_t first = firstPart[merge.first];
+        const Trapezoid &right = pieces[merge.second];
+        firstPart[merge.second] = first;
+        pieces[first].setRightPoint(right.getRightPoint());
+        pieces[first].setUpperRightNeigbor(right.getUpperRightNeighbor());
+        pieces[first].setLowerRightNeighbor(right.getLowerRightNeighbor());
+    }
+
+    // Joined map: the first parts, with the neighbors renumbered
+    std::vector<size_t> trapezoidIdx(numPieces, nullIdx);
+    size_t numTrapezoids = 0;
+    for(size_t pieceIdx = 0; pieceIdx < numPieces; pieceIdx++){
+        if(firstPart[pieceIdx] == pieceIdx) trapezoidIdx[pieceIdx] = numTrapezoids++;
+    }
+    trapezoidalMap.reserve(numTrapezoids);
+    for(size_t pieceIdx = 0; pieceIdx < numPieces; pieceIdx++){
+        if(firstPart[pieceIdx] != pieceIdx) continue;
+        Trapezoid &trapezoid = pieces[pieceIdx];
+        trapezoid.setUpperLeftNeighbor(trapezoid.getUpperLeftNeighbor() == nullIdx ? nullIdx : trapezoidIdx[firstPart[trapezoid.getUpperLeftNeighbor()]]);
+        trapezoid.setLowerLeftNeighbor(trapezoid.getLowerLeftNeighbor() == nullIdx ? nullIdx : trapezoidIdx[firstPart[trapezoid.getLowerLeftNeighbor()]]);
+        trapezoid.setUpperRightNeigbor(trapezoid.getUpperRightNeighbor() == nullIdx ? nullIdx : trapezoidIdx[firstPart[trapezoid.getUpperRightNeighbor()]]);
+        trapezoid.setLowerRightNeighbor(trapezoid.getLowerRightNeighbor() == nullIdx ? nullIdx : trapezoidIdx[firstPart[trapezoid.getLowerRightNeighbor()]]);
+        trapezoidalMap.addTrapezoid(trapezoid);
+    }
+
+    // Dag: the x-nodes of the boundaries, then the nodes of the slabs. The leaves of the later parts of a joined trapezoid are
+    // replaced by the leaf of its first part, so every trapezoid has one leaf; the leaves of the dropped trapezoids are never reached
+    dag.reserve(numNodes);
+    // A slab without segments has a leaf as root: the boundary tree takes the leaf of the joined trapezoid, the one that is replaced when
+    // the trapezoid is split by a later insertion
+    std::vector<size_t> slabRoots(nodeOffset);
+    for(size_t slabIdx = 0; slabIdx < numSlabs; slabIdx++){
+        const Node &root = slabs[slabIdx].dag.getRoot();
+        if(root.getType() == Node::NodeType::LEAF) slabRoots[slabIdx] = pieces[firstPart[slabs[slabIdx].globalIdx[root.getIdx()]]].getNodeIdx();
+    }
+    addBoundaryTree(0, numSlabs, boundaryPoints, slabRoots, dag);
+    for(size_t slabIdx = 0; slabIdx < numSlabs; slabIdx++){
+        const SlabBuild &slab = slabs[slabIdx];
+        const Dag &slabDag = slab.dag;
+        for(const Node &slabNode : slabDag.getNodes()){
+            if(slabNode.getType() == Node::NodeType::LEAF){
+                size_t pieceIdx = slab.globalIdx[slabNode.getIdx()];
+                Node leaf = Node(Node::NodeType::LEAF, pieceIdx == nullIdx ? nullIdx : trapezoidIdx[firstPart[pieceIdx]], nullIdx, nullIdx);
+                dag.addNode(leaf);
+                continue;
+            }
+            size_t children[2] = {slabNode.getLeftIdx(), slabNode.getRightIdx()};
+            for(size_t &child : children){
+                const Node &childNode = slabDag.getNode(child);
+                size_t pieceIdx = childNode.getType() == Node::NodeType::LEAF ? slab.globalIdx[childNode.getIdx()] : nullIdx;
+                child = pieceIdx == nullIdx ? child + nodeOffset[slabIdx] : pieces[firstPart[pieceIdx]].getNodeIdx();
+            }
+            Node node = Node(slabNode.getType(), slabNode.getIdx(), children[0], children[1]);
+            dag.addNode(node);
+        }
+    }
+
+    if(stats != nullptr){
+        stats->numParts = numParts;
+        stats->slabsMilliseconds = slabsTime;
+        stats->sequentialMilliseconds = partitionTime + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+}
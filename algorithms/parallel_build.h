@@ -0,0 +1,25 @@
+#ifndef PARALLEL_BUILD_H
+#define PARALLEL_BUILD_H
+
+#include <cstddef>
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief Parallel construction of the trapezoidal map and of the Dag, partitioning the plane in vertical slabs
+ */
+namespace algorithms{
+    // Work of a parallel construction: the parts of the segments inserted in the slabs (one per slab crossed), the time of the
+    // concurrent build of the slabs and the time of the sequential phases (the split in slabs and the join)
+    struct ParallelBuildStats{
+        size_t numParts;
+        double slabsMilliseconds;
+        double sequentialMilliseconds;
+    };
+
+    void buildTrapezoidalMapParallel(Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, size_t numSlabs, size_t numThreads = 0,
+                                     ParallelBuildStats *stats = nullptr);
+}
+
+#endif // PARALLEL_BUILD_H
@@ -0,0 +1,246 @@
+#include "parallel_insertion.h"
+#include "algorithms.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Number of consecutive tasks taken at once by a worker
+#define PARALLEL_INSERTION_GRAIN 16
+
+namespace algorithms{
+
+/**
+ * @brief Insertion of a segment in a round
+ */
+struct RoundInsertion{
+    cg3::Segment2d segment;                     // The segment, with p1 as left endpoint
+    SegmentIndexes indexes;                     // Dataset indexes of the segment and of its endpoints
+    std::vector<size_t> intersectedTrapezoids;  // Conflict region: the trapezoids intersected by the segment
+    std::vector<size_t> reservedTrapezoids;     // The conflict region and its neighbors (the trapezoids written by the insertion)
+    size_t newTrapezoids;                       // Number of trapezoids and of nodes added by the insertion
+    size_t newNodes;
+    InsertionSlots slots;                       // Indexes of its new trapezoids and nodes
+};
+
+/**
+ * @brief Threads running the phases of the rounds: every phase is a loop on the segments of the round, split among the threads
+ */
+class RoundWorkers{
+public:
+    explicit RoundWorkers(size_t numThreads) : task(nullptr), count(0), next(0), running(0), generation(0), stop(false){
+        for(size_t threadIdx = 1; threadIdx < numThreads; threadIdx++) threads.emplace_back(&RoundWorkers::work, this);
+    }
+
+    ~RoundWorkers(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for(std::thread &thread : threads) thread.join();
+    }
+
+    // Run the task for every index in [0, count) and wait the end of all of them (the calling thread works too)
+    void run(size_t count, const std::function<void(size_t)> &task){
+        if(threads.empty() || count <= PARALLEL_INSERTION_GRAIN){
+            for(size_t idx = 0; idx < count; idx++) task(idx);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->task = &task;
+            this->count = count;
+            next = 0;
+            running = threads.size();
+            generation++;
+        }
+        wake.notify_all();
+        runTasks();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this](){ return running == 0; });
+    }
+
+private:
+    void work(){
+        size_t seenGeneration = 0;
+        while(true){
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seenGeneration](){ return stop || generation != seenGeneration; });
+                if(stop) return;
+                seenGeneration = generation;
+            }
+            runTasks();
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--running == 0) done.notify_one();
+        }
+    }
+
+    void runTasks(){
+        for(size_t first = next.fetch_add(PARALLEL_INSERTION_GRAIN); first < count; first = next.fetch_add(PARALLEL_INSERTION_GRAIN)){
+            size_t last = std::min(first + PARALLEL_INSERTION_GRAIN, count);
+            for(size_t idx = first; idx < last; idx++) (*task)(idx);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    const std::function<void(size_t)> *task;
+    size_t count;
+    std::atomic<size_t> next;   // Next task not yet taken
+    size_t running;             // Threads still working on the current phase
+    size_t generation;          // Number of phases started
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+};
+
+/**
+ * @brief Find the conflict region of a segment and the trapezoids its insertion writes
+ * @param[in] insertion the insertion, with its segment
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * The insertion rewrites the intersected trapezoids and updates the neighbor indexes of their neighbors. It adds 1 trapezoid, plus
+ * the left and the right trapezoids if they exist, and 2 nodes for each of them plus one node for each intersected trapezoid and
+ * one for the last y-node (see oneIntersectedTrapezoid and moreIntersectedTrapezoids).
+ */
+void findConflicts(RoundInsertion &insertion, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    followSegment(insertion.segment, dag, trapezoidalMap, trapezoidalMapData, insertion.intersectedTrapezoids);
+
+    insertion.reservedTrapezoids.clear();
+    for(size_t trapezoidIdx : insertion.intersectedTrapezoids){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        insertion.reservedTrapezoids.push_back(trapezoidIdx);
+        if(trapezoid.getUpperLeftNeighbor() != nullIdx) insertion.reservedTrapezoids.push_back(trapezoid.getUpperLeftNeighbor());
+        if(trapezoid.getLowerLeftNeighbor() != nullIdx) insertion.reservedTrapezoids.push_back(trapezoid.getLowerLeftNeighbor());
+        if(trapezoid.getUpperRightNeighbor() != nullIdx) insertion.reservedTrapezoids.push_back(trapezoid.getUpperRightNeighbor());
+        if(trapezoid.getLowerRightNeighbor() != nullIdx) insertion.reservedTrapezoids.push_back(trapezoid.getLowerRightNeighbor());
+    }
+
+    size_t leftTrapezoidExists = insertion.segment.p1() != trapezoidalMap.getTrapezoid(insertion.intersectedTrapezoids.front()).getLeftPoint() ? 1 : 0;
+    size_t rightTrapezoidExists = insertion.segment.p2() != trapezoidalMap.getTrapezoid(insertion.intersectedTrapezoids.back()).getRightPoint() ? 1 : 0;
+    insertion.newTrapezoids = 1 + leftTrapezoidExists + rightTrapezoidExists;
+    insertion.newNodes = 2 * (leftTrapezoidExists + rightTrapezoidExists) + insertion.intersectedTrapezoids.size() + 1;
+}
+
+/**
+ * @brief Reserve a trapezoid for an insertion, unless it is reserved by an insertion with higher priority (lower position in the round)
+ * @param[in] reservation the reservation of the trapezoid
+ * @param[in] priority the position of the insertion in the round
+ */
+void reserveTrapezoid(std::atomic<size_t> &reservation, size_t priority){
+    size_t current = reservation.load();
+    while(priority < current && !reservation.compare_exchange_weak(current, priority)){}
+}
+
+/**
+ * @brief Insert segments of the dataset with the randomized incremental algorithm, inserting concurrently the independent segments
+ * @param[in] segmentOrder the dataset indexes of the segments, in insertion order (a random order for the expected complexity)
+ * @param[in] dag The DAG search structure (already initialized)
+ * @param[in] trapezoidalMap The trapezoidal Map data structure (already initialized)
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * @param[in] numThreads the number of threads (0 for the number of cores)
+ * The segments are inserted in rounds with deterministic reservations. Every round takes the next segments of the order and finds
+ * their conflict regions (the intersected trapezoids) concurrently, then every segment reserves its region and the neighbors of
+ * the region, keeping the reservation of the segment coming first in the order. The segments holding all their reservations,
+ * before the first one that does not, change disjoint parts of the structures: their new trapezoids and nodes get the indexes they
+ * would get inserting them one by one, and they are inserted concurrently. The other ones go to the next round.
+ * The structures are identical (same indexes) to the ones built calling buildTrapezoidalMap on the segments in the same order,
+ * whatever the number of threads. The round grows while all of its segments are inserted, and shrinks when they conflict.
+ * The structures must not share their storage with copies (snapshots) during the insertion.
+ */
+void insertSegmentsParallel(const std::vector<size_t> &segmentOrder, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, size_t numThreads){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    assert(trapezoidalMap.numTrapezoids() > 0);
+    if(numThreads == 0) numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    // Make the chunks of the structures private, so the concurrent writes never copy a shared chunk
+    for(size_t trapezoidIdx = 0; trapezoidIdx < trapezoidalMap.numTrapezoids(); trapezoidIdx += ChunkedVector<Trapezoid>::CHUNK_SIZE){
+        trapezoidalMap.getTrapezoid(trapezoidIdx);
+    }
+    for(size_t nodeIdx = 0; nodeIdx < dag.numNodes(); nodeIdx += ChunkedVector<Node>::CHUNK_SIZE){
+        Node node = dag.getNode(nodeIdx);
+        dag.replaceNode(node, nodeIdx);
+    }
+
+    // Reservation of every trapezoid (each segment adds at most 3 trapezoids)
+    size_t maxTrapezoids = trapezoidalMap.numTrapezoids() + 3 * segmentOrder.size();
+    std::unique_ptr<std::atomic<size_t>[]> reservations(new std::atomic<size_t>[maxTrapezoids]);
+    for(size_t trapezoidIdx = 0; trapezoidIdx < maxTrapezoids; trapezoidIdx++) reservations[trapezoidIdx].store(nullIdx);
+
+    std::vector<RoundInsertion> round(std::min<size_t>(PARALLEL_INSERTION_MAX_ROUND, segmentOrder.size()));
+    std::vector<char> reserved(round.size());
+    RoundWorkers workers(numThreads);
+    Trapezoid placeholderTrapezoid = trapezoidalMap.getTrapezoid(0);
+    Node placeholderNode = Node(Node::NodeType::LEAF, 0, nullIdx, nullIdx);
+
+    size_t numInserted = 0;
+    size_t roundSize = 1;
+    while(numInserted < segmentOrder.size()){
+        size_t count = std::min(roundSize, segmentOrder.size() - numInserted);
+
+        // Conflict regions of the next segments (on the structures at the start of the round) and their reservations
+        workers.run(count, [&](size_t position){
+            RoundInsertion &insertion = round[position];
+            size_t segmentIdx = segmentOrder[numInserted + position];
+            const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment = trapezoidalMapData.getIndexedSegment(segmentIdx);
+            insertion.segment = trapezoidalMapData.getSegment(segmentIdx);
+            insertion.indexes.segmentIdx = segmentIdx;
+            insertion.indexes.leftPointIdx = indexedSegment.first;
+            insertion.indexes.rightPointIdx = indexedSegment.second;
+            if(insertion.segment.p1().x() > insertion.segment.p2().x()){
+                cg3::Point2d leftEndpoint = insertion.segment.p2();
+                insertion.segment.setP2(insertion.segment.p1());
+                insertion.segment.setP1(leftEndpoint);
+                std::swap(insertion.indexes.leftPointIdx, insertion.indexes.rightPointIdx);
+            }
+            findConflicts(insertion, dag, trapezoidalMap, trapezoidalMapData);
+            for(size_t trapezoidIdx : insertion.reservedTrapezoids) reserveTrapezoid(reservations[trapezoidIdx], position);
+        });
+
+        // A segment holding all its reservations does not share trapezoids with the segments before it
+        workers.run(count, [&](size_t position){
+            reserved[position] = 1;
+            for(size_t trapezoidIdx : round[position].reservedTrapezoids){
+                if(reservations[trapezoidIdx].load() != position) reserved[position] = 0;
+            }
+        });
+        size_t numCommitted = 0;
+        while(numCommitted < count && reserved[numCommitted]) numCommitted++;
+        assert(numCommitted > 0);
+
+        // Indexes of the new trapezoids and nodes, in the insertion order, allocated before the concurrent insertions
+        InsertionSlots slots = {trapezoidalMap.numTrapezoids(), dag.numNodes()};
+        for(size_t position = 0; position < numCommitted; position++){
+            round[position].slots = slots;
+            slots.nextTrapezoid += round[position].newTrapezoids;
+            slots.nextNode += round[position].newNodes;
+        }
+        while(trapezoidalMap.numTrapezoids() < slots.nextTrapezoid) trapezoidalMap.addTrapezoid(placeholderTrapezoid);
+        while(dag.numNodes() < slots.nextNode) dag.addNode(placeholderNode);
+
+        // Insertion of the committed segments, and release of all the reservations
+        workers.run(count, [&](size_t position){
+            RoundInsertion &insertion = round[position];
+            if(position < numCommitted){
+                InsertionSlots insertionSlots = insertion.slots;
+                insertSegment(insertion.segment, insertion.indexes, insertion.intersectedTrapezoids, insertionSlots, dag, trapezoidalMap);
+                assert(insertionSlots.nextTrapezoid == insertion.slots.nextTrapezoid + insertion.newTrapezoids);
+                assert(insertionSlots.nextNode == insertion.slots.nextNode + insertion.newNodes);
+            }
+            for(size_t trapezoidIdx : insertion.reservedTrapezoids) reservations[trapezoidIdx].store(nullIdx);
+        });
+
+        numInserted += numCommitted;
+        if(numCommitted == count) roundSize = std::min<size_t>(2 * roundSize, round.size());
+        else roundSize = std::min<size_t>(2 * numCommitted, round.size());
+    }
+}
+}
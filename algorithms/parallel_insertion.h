@@ -0,0 +1,20 @@
+#ifndef PARALLEL_INSERTION_H
+#define PARALLEL_INSERTION_H
+
+#include <cstddef>
+#include <vector>
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+// Maximum number of segments of a round of the parallel insertion
+#define PARALLEL_INSERTION_MAX_ROUND 4096
+
+/**
+ * @brief Parallel randomized incremental construction: the segments of a round with independent conflict regions are inserted concurrently
+ */
+namespace algorithms{
+    void insertSegmentsParallel(const std::vector<size_t> &segmentOrder, Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData, size_t numThreads = 0);
+}
+
+#endif // PARALLEL_INSERTION_H
@@ -0,0 +1,64 @@
+#include "point_locator.h"
+#include "algorithms.h"
+
+/**
+ * @brief Destructor
+ */
+PointLocator::~PointLocator(){}
+
+/**
+ * @brief Locate a batch of points
+ * @param[in] queryPoints the query points
+ * @return for each query point, the dataset index of the segment above (first) and below (second) the point
+ */
+std::vector<std::pair<size_t, size_t>> PointLocator::locate(const std::vector<cg3::Point2d> &queryPoints) const{
+    std::vector<std::pair<size_t, size_t>> aboveBelow;
+    aboveBelow.reserve(queryPoints.size());
+    for(const cg3::Point2d &q : queryPoints){
+        aboveBelow.push_back(locate(q));
+    }
+    return aboveBelow;
+}
+
+/**
+ * @brief Constructor of the Dag engine
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ */
+DagPointLocator::DagPointLocator(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData) :
+    dag(dag), trapezoidalMap(trapezoidalMap), trapezoidalMapData(trapezoidalMapData){}
+
+/**
+ * @brief Find the segments above and below a point with the Dag
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> DagPointLocator::locate(const cg3::Point2d &q) const{
+    return algorithms::queryAboveBelow(q, dag, trapezoidalMap, trapezoidalMapData);
+}
+
+/**
+ * @brief Constructor of the slab engine
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ */
+SlabPointLocator::SlabPointLocator(const TrapezoidalMapDataset &trapezoidalMapData){
+    slabTree.build(trapezoidalMapData);
+}
+
+/**
+ * @brief Find the segments above and below a point with the slab tree
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> SlabPointLocator::locate(const cg3::Point2d &q) const{
+    return slabTree.query(q);
+}
+
+/**
+ * @brief Get the slab tree of the engine
+ * @return the slab tree
+ */
+const SlabTree &SlabPointLocator::getSlabTree() const{
+    return slabTree;
+}
@@ -0,0 +1,61 @@
+#ifndef POINT_LOCATOR_H
+#define POINT_LOCATOR_H
+
+#include <cg3/geometry/point2.h>
+#include <utility>
+#include <vector>
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+#include "data_structures/slab_tree.h"
+
+/**
+ * @brief Common interface of the point location engines, to choose the engine per dataset.
+ * An engine answers with the dataset indexes of the segments directly above and below the query point (null index for the bounding box),
+ * the answer that every engine can give without the trapezoidal map.
+ */
+class PointLocator{
+
+public:
+    virtual ~PointLocator();
+    // Find the segment above (first) and below (second) a point
+    virtual std::pair<size_t, size_t> locate(const cg3::Point2d &q) const = 0;
+    // Locate a batch of points
+    std::vector<std::pair<size_t, size_t>> locate(const std::vector<cg3::Point2d> &queryPoints) const;
+};
+
+/**
+ * @brief Point location with the Dag of the trapezoidal map (randomized incremental construction)
+ */
+class DagPointLocator : public PointLocator{
+
+public:
+    // Constructor (the structures are not copied, they must outlive the locator)
+    DagPointLocator(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const TrapezoidalMapDataset &trapezoidalMapData);
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+
+private:
+    const Dag &dag;
+    const TrapezoidalMap &trapezoidalMap;
+    const TrapezoidalMapDataset &trapezoidalMapData;
+};
+
+/**
+ * @brief Point location with the persistent slab tree, O(log n) in the worst case independently of the insertion order
+ */
+class SlabPointLocator : public PointLocator{
+
+public:
+    // Constructor (builds the slab tree of the dataset)
+    SlabPointLocator(const TrapezoidalMapDataset &trapezoidalMapData);
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+    // Get the slab tree
+    const SlabTree &getSlabTree() const;
+
+private:
+    SlabTree slabTree;
+};
+
+#endif // POINT_LOCATOR_H
@@ -0,0 +1,51 @@
+#ifndef QUANTIZED_LOCATION_H
+#define QUANTIZED_LOCATION_H
+
+#include <limits>
+#include "algorithms/dag_traversal.h"
+#include "data_structures/quantized_geometry.h"
+
+/**
+ * @brief Point location on the quantized (integer) copy of the geometry of the dataset, with exact integer predicates
+ * The Dag is the one built on the double dataset, only the predicates of the descent read the quantized copy
+ */
+namespace algorithms{
+
+    // Point location on a quantized geometry: the same conventions of PointPolicy (x ties go right, a point on a segment goes below it)
+    template<class T>
+    struct QuantizedPointPolicy{
+        T qx, qy;
+        QuantizedPointPolicy(T qx, T qy) : qx(qx), qy(qy){}
+        bool goLeftX(size_t pointIdx, const QuantizedGeometry<T> &geometry) const{ return qx < geometry.getPointX(pointIdx); }
+        bool goLeftY(size_t segmentIdx, const QuantizedGeometry<T> &geometry) const{ return geometry.orientation(segmentIdx, qx, qy) > 0; }
+    };
+
+    /**
+     * @brief Locate in which trapezoid lies a point with quantized coordinates
+     * @param[in] qx the quantized x coordinate of the query point
+     * @param[in] qy the quantized y coordinate of the query point
+     * @param[in] dag The DAG search structure
+     * @param[in] geometry the quantized geometry of the dataset
+     * @return The index of the trapezoid in which lies the query point
+     */
+    template<class T>
+    inline size_t queryPointQuantized(T qx, T qy, const Dag &dag, const QuantizedGeometry<T> &geometry){
+        return traverseDag(dag, geometry, QuantizedPointPolicy<T>(qx, qy));
+    }
+
+    /**
+     * @brief Locate in which trapezoid lies a point, quantizing its coordinates
+     * @param[in] q Query point
+     * @param[in] dag The DAG search structure
+     * @param[in] geometry the quantized geometry of the dataset
+     * @return The index of the trapezoid in which lies the query point, a null index if a coordinate of q is too large for the type
+     * (the same check of QuantizedGeometry::build, so the cross products cannot overflow)
+     */
+    template<class T>
+    inline size_t queryPointQuantized(const cg3::Point2d &q, const Dag &dag, const QuantizedGeometry<T> &geometry){
+        if(!geometry.representable(q.x()) || !geometry.representable(q.y())) return std::numeric_limits<size_t>::max();
+        return queryPointQuantized(geometry.quantize(q.x()), geometry.quantize(q.y()), dag, geometry);
+    }
+}
+
+#endif // QUANTIZED_LOCATION_H
@@ -0,0 +1,355 @@
+#include "simd_location.h"
+#include "algorithms.h"
+#include "utils/predicates.h"
+#include <limits>
+
+// The AVX2 kernel is compiled with a target attribute and selected at runtime, so the binary still runs on older cpus. It gathers
+// the 64 bit indexes of the nodes, so it needs a 64 bit size_t
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SIMD_LOCATION_AVX2
+#include <immintrin.h>
+#endif
+
+// Maps with at most this number of segments are located with the linear scan of their trapezoids instead of the Dag
+#define SMALL_MAP_MAX_SEGMENTS 64
+
+namespace algorithms{
+
+/**
+ * @brief Evaluate the predicate of a y-node on the packed geometry
+ * @param[in] q the query point
+ * @param[in] segmentIdx the index of the segment
+ * @param[in] packedGeometry the packed geometry of the dataset
+ * @return true if q lies above the segment (the same adaptive predicate of the Dag)
+ */
+inline bool isAboveSegment(const cg3::Point2d &q, size_t segmentIdx, const PackedGeometry &packedGeometry){
+    cg3::Point2d p1(packedGeometry.getSegmentsX1()[segmentIdx], packedGeometry.getSegmentsY1()[segmentIdx]);
+    cg3::Point2d p2(packedGeometry.getSegmentsX2()[segmentIdx], packedGeometry.getSegmentsY2()[segmentIdx]);
+    return ProjectUtils::orient2d(p1, p2, q) > 0;
+}
+
+/**
+ * @brief Point location of a batch of points on the packed geometry, one query at a time (fallback of the vectorized kernel)
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] packedGeometry the packed geometry of the dataset
+ * @return the index of the trapezoid containing each query point, in the order of the query points
+ */
+std::vector<size_t> queryPointsScalar(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const PackedGeometry &packedGeometry){
+    std::vector<size_t> located(queryPoints.size());
+    const std::vector<double> &pointsX = packedGeometry.getPointsX();
+    for(size_t i = 0; i < queryPoints.size(); i++){
+        const cg3::Point2d &q = queryPoints[i];
+        const Node *node = &dag.getRoot();
+        while(node->getType() != Node::NodeType::LEAF){
+            bool goLeft = node->getType() == Node::NodeType::X ? q.x() < pointsX[node->getIdx()] : isAboveSegment(q, node->getIdx(), packedGeometry);
+            node = &dag.getNode(goLeft ? node->getLeftIdx() : node->getRightIdx());
+        }
+        located[i] = node->getIdx();
+    }
+    return located;
+}
+
+#ifdef SIMD_LOCATION_AVX2
+
+/**
+ * @brief Floating point filter of the orientation of 4 points with respect to 4 lines, with AVX2
+ * @param[in] x1 @param[in] y1 @param[in] x2 @param[in] y2 the points of the lines
+ * @param[in] qx @param[in] qy the points to test
+ * @param[out] uncertain the lanes where the error bound does not prove the sign (to be decided by ProjectUtils::orient2dExact)
+ * @return the floating point orientations, computed as in ProjectUtils::orient2d (same value and same decisions of the filter)
+ */
+__attribute__((target("avx2")))
+static inline __m256d orient2dFilter(__m256d x1, __m256d y1, __m256d x2, __m256d y2, __m256d qx, __m256d qy, __m256d &uncertain){
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d detLeft = _mm256_mul_pd(_mm256_sub_pd(x1, qx), _mm256_sub_pd(y2, qy));
+    __m256d detRight = _mm256_mul_pd(_mm256_sub_pd(y1, qy), _mm256_sub_pd(x2, qx));
+    __m256d det = _mm256_sub_pd(detLeft, detRight);
+    __m256d errorBound = _mm256_mul_pd(_mm256_set1_pd(ORIENT2D_ERROR_BOUND), _mm256_add_pd(_mm256_and_pd(detLeft, absMask), _mm256_and_pd(detRight, absMask)));
+    uncertain = _mm256_cmp_pd(_mm256_and_pd(det, absMask), errorBound, _CMP_NGE_UQ);
+    return det;
+}
+
+// Log2 of the size of a node: the offset of a node in its chunk is computed with a 64 bit shift (AVX2 has no 64 bit multiply)
+static constexpr int nodeSizeBits(size_t size){
+    return size <= 1 ? 0 : 1 + nodeSizeBits(size / 2);
+}
+static const int NODE_SIZE_BITS = nodeSizeBits(sizeof(Node));
+static_assert(sizeof(Node) == size_t(1) << NODE_SIZE_BITS, "the vectorized Dag descent needs a power of two node size");
+static_assert(sizeof(size_t) == sizeof(long long), "the vectorized Dag descent gathers 64 bit node indexes");
+
+/**
+ * @brief Addresses of 4 nodes of the Dag, with AVX2
+ * @param[in] nodes the indexes of the nodes
+ * @param[in] nodeChunks the chunk table of the nodes
+ * @param[in] chunkMask the mask of the index in a chunk
+ * @return the address of each node: its chunk, then its position in the chunk (all in 64 bits, for any node index)
+ */
+__attribute__((target("avx2")))
+static inline __m256i nodeAddresses(__m256i nodes, const long long *nodeChunks, __m256i chunkMask){
+    __m256i chunks = _mm256_i64gather_epi64(nodeChunks, _mm256_srli_epi64(nodes, ChunkedVector<Node>::CHUNK_BITS), 8);
+    return _mm256_add_epi64(chunks, _mm256_slli_epi64(_mm256_and_si256(nodes, chunkMask), NODE_SIZE_BITS));
+}
+
+/**
+ * @brief Point location of a batch of points with AVX2, 4 queries for each vector
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] packedGeometry the packed geometry of the dataset
+ * @return the index of the trapezoid containing each query point, in the order of the query points
+ * Every lane holds a query and its current node. At each step the node records are gathered, the points (x-nodes) and the segments
+ * (y-nodes) are gathered with masked loads, both predicates are evaluated with vector compares and each lane moves to its child.
+ * The orientations use the filter of the adaptive predicates, the lanes it cannot decide are computed exactly in scalar code.
+ * The lanes that reached a leaf are retired and refilled in scalar code, the lanes left without a query keep moving but are ignored.
+ */
+__attribute__((target("avx2")))
+std::vector<size_t> queryPointsAvx2(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const PackedGeometry &packedGeometry){
+    std::vector<size_t> located(queryPoints.size());
+    const long long *nodeChunks = reinterpret_cast<const long long *>(dag.getNodes().getChunks());
+    const double *pointsX = packedGeometry.getPointsX().data();
+    const double *segmentsX1 = packedGeometry.getSegmentsX1().data();
+    const double *segmentsY1 = packedGeometry.getSegmentsY1().data();
+    const double *segmentsX2 = packedGeometry.getSegmentsX2().data();
+    const double *segmentsY2 = packedGeometry.getSegmentsY2().data();
+
+    // The nodes are gathered by absolute address (chunk of the node, then the node in the chunk), so the gathers have no base
+    const int *noIntBase = nullptr;
+    const long long *noLongBase = nullptr;
+    const __m256i chunkMask = _mm256_set1_epi64x(static_cast<long long>(ChunkedVector<Node>::CHUNK_MASK));
+    const __m256i typeOffset = _mm256_set1_epi64x(static_cast<long long>(Node::typeOffset()));
+    const __m256i idxOffset = _mm256_set1_epi64x(static_cast<long long>(Node::idxOffset()));
+    const __m256i leftOffset = _mm256_set1_epi64x(static_cast<long long>(Node::leftIdxOffset()));
+    const __m256i rightOffset = _mm256_set1_epi64x(static_cast<long long>(Node::rightIdxOffset()));
+    const __m128i xType = _mm_set1_epi32(Node::NodeType::X);
+    const __m128i yType = _mm_set1_epi32(Node::NodeType::Y);
+    const __m128i leafType = _mm_set1_epi32(Node::NodeType::LEAF);
+
+    // Lanes state: query, query coordinates, current node
+    alignas(32) long long laneNode[4] = {0, 0, 0, 0};
+    alignas(32) double laneX[4] = {0, 0, 0, 0};
+    alignas(32) double laneY[4] = {0, 0, 0, 0};
+    size_t laneQuery[4];
+    bool laneActive[4] = {false, false, false, false};
+    size_t nextQuery = 0;
+
+    while(true){
+        // Retire the lanes that reached a leaf and refill them with the next queries (the root is a leaf if the map is empty)
+        __m256i nodes = _mm256_load_si256(reinterpret_cast<const __m256i *>(laneNode));
+        __m256i addresses = nodeAddresses(nodes, nodeChunks, chunkMask);
+        __m128i types = _mm256_i64gather_epi32(noIntBase, _mm256_add_epi64(addresses, typeOffset), 1);
+        int leafMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(types, leafType)));
+        bool anyActive = false;
+        for(int lane = 0; lane < 4; lane++){
+            if(laneActive[lane] && (leafMask & (1 << lane))){
+                located[laneQuery[lane]] = dag.getNode(static_cast<size_t>(laneNode[lane])).getIdx();
+                laneActive[lane] = false;
+            }
+            while(!laneActive[lane] && nextQuery < queryPoints.size()){
+                laneQuery[lane] = nextQuery;
+                laneX[lane] = queryPoints[nextQuery].x();
+                laneY[lane] = queryPoints[nextQuery++].y();
+                laneNode[lane] = 0;
+                if(dag.getRoot().getType() == Node::NodeType::LEAF) located[laneQuery[lane]] = dag.getRoot().getIdx();
+                else laneActive[lane] = true;
+            }
+            anyActive |= laneActive[lane];
+        }
+        if(!anyActive) break;
+
+        nodes = _mm256_load_si256(reinterpret_cast<const __m256i *>(laneNode));
+        addresses = nodeAddresses(nodes, nodeChunks, chunkMask);
+        types = _mm256_i64gather_epi32(noIntBase, _mm256_add_epi64(addresses, typeOffset), 1);
+        __m256i xMask = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(types, xType));
+        __m256i yMask = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(types, yType));
+        __m256i idx = _mm256_i64gather_epi64(noLongBase, _mm256_add_epi64(addresses, idxOffset), 1);
+        __m256i left = _mm256_i64gather_epi64(noLongBase, _mm256_add_epi64(addresses, leftOffset), 1);
+        __m256i right = _mm256_i64gather_epi64(noLongBase, _mm256_add_epi64(addresses, rightOffset), 1);
+
+        __m256d qx = _mm256_load_pd(laneX);
+        __m256d qy = _mm256_load_pd(laneY);
+        __m256d zero = _mm256_setzero_pd();
+
+        // x-nodes: q.x < p.x
+        __m256d px = _mm256_mask_i64gather_pd(zero, pointsX, idx, _mm256_castsi256_pd(xMask), 8);
+        __m256d goLeftX = _mm256_cmp_pd(qx, px, _CMP_LT_OQ);
+
+        // y-nodes: orientation of q with respect to the segment, the lanes not decided by the filter are decided exactly
+        __m256d yMaskPd = _mm256_castsi256_pd(yMask);
+        __m256d x1 = _mm256_mask_i64gather_pd(zero, segmentsX1, idx, yMaskPd, 8);
+        __m256d y1 = _mm256_mask_i64gather_pd(zero, segmentsY1, idx, yMaskPd, 8);
+        __m256d x2 = _mm256_mask_i64gather_pd(zero, segmentsX2, idx, yMaskPd, 8);
+        __m256d y2 = _mm256_mask_i64gather_pd(zero, segmentsY2, idx, yMaskPd, 8);
+        __m256d uncertain;
+        __m256d det = orient2dFilter(x1, y1, x2, y2, qx, qy, uncertain);
+        int uncertainMask = _mm256_movemask_pd(_mm256_and_pd(uncertain, yMaskPd));
+        if(uncertainMask){
+            alignas(32) double laneDet[4], laneX1[4], laneY1[4], laneX2[4], laneY2[4];
+            _mm256_store_pd(laneDet, det);
+            _mm256_store_pd(laneX1, x1);
+            _mm256_store_pd(laneY1, y1);
+            _mm256_store_pd(laneX2, x2);
+            _mm256_store_pd(laneY2, y2);
+            for(int lane = 0; lane < 4; lane++){
+                if(uncertainMask & (1 << lane)){
+                    laneDet[lane] = ProjectUtils::orient2dExact(cg3::Point2d(laneX1[lane], laneY1[lane]), cg3::Point2d(laneX2[lane], laneY2[lane]),
+                                                                cg3::Point2d(laneX[lane], laneY[lane]));
+                }
+            }
+            det = _mm256_load_pd(laneDet);
+        }
+        __m256d goLeftY = _mm256_cmp_pd(det, zero, _CMP_GT_OQ);
+
+        __m256i goLeft = _mm256_or_si256(_mm256_and_si256(xMask, _mm256_castpd_si256(goLeftX)),
+                                         _mm256_and_si256(yMask, _mm256_castpd_si256(goLeftY)));
+        __m256i child = _mm256_blendv_epi8(right, left, goLeft);
+        // The lanes on a leaf (without a query) do not move
+        __m256i internal = _mm256_or_si256(xMask, yMask);
+        nodes = _mm256_blendv_epi8(nodes, child, internal);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(laneNode), nodes);
+    }
+
+    return located;
+}
+
+#endif
+
+/**
+ * @brief Find the trapezoid containing a point testing all the trapezoids of the map, one at a time (fallback of the vectorized scan)
+ * @param[in] q the query point
+ * @param[in] packedTrapezoids the packed trapezoids of the map
+ * @return the index of the trapezoid containing q, null index if no trapezoid contains it
+ * A trapezoid contains q if q.x is in [left, right), q is on or below the top edge and strictly above the bottom edge, the
+ * same conventions (and the same adaptive predicates) of the Dag.
+ */
+size_t scanTrapezoidsScalar(const cg3::Point2d &q, const PackedTrapezoids &packedTrapezoids){
+    const double *leftX = packedTrapezoids.getLeftX().data(), *rightX = packedTrapezoids.getRightX().data();
+    const double *topX1 = packedTrapezoids.getTopX1().data(), *topY1 = packedTrapezoids.getTopY1().data();
+    const double *topX2 = packedTrapezoids.getTopX2().data(), *topY2 = packedTrapezoids.getTopY2().data();
+    const double *bottomX1 = packedTrapezoids.getBottomX1().data(), *bottomY1 = packedTrapezoids.getBottomY1().data();
+    const double *bottomX2 = packedTrapezoids.getBottomX2().data(), *bottomY2 = packedTrapezoids.getBottomY2().data();
+
+    size_t located = std::numeric_limits<size_t>::max();
+    for(size_t i = 0; i < packedTrapezoids.numTrapezoids(); i++){
+        double top = ProjectUtils::orient2d(cg3::Point2d(topX1[i], topY1[i]), cg3::Point2d(topX2[i], topY2[i]), q);
+        double bottom = ProjectUtils::orient2d(cg3::Point2d(bottomX1[i], bottomY1[i]), cg3::Point2d(bottomX2[i], bottomY2[i]), q);
+        bool inside = (leftX[i] <= q.x()) & (q.x() < rightX[i]) & !(top > 0) & (bottom > 0);
+        located = inside ? i : located;
+    }
+    return located;
+}
+
+#ifdef SIMD_LOCATION_AVX2
+
+/**
+ * @brief Find the trapezoid containing a point testing all the trapezoids of the map with AVX2, 4 trapezoids for each vector
+ * @param[in] q the query point
+ * @param[in] packedTrapezoids the packed trapezoids of the map
+ * @return the index of the trapezoid containing q, null index if no trapezoid contains it
+ */
+__attribute__((target("avx2")))
+size_t scanTrapezoidsAvx2(const cg3::Point2d &q, const PackedTrapezoids &packedTrapezoids){
+    const double *leftX = packedTrapezoids.getLeftX().data(), *rightX = packedTrapezoids.getRightX().data();
+    const double *topX1 = packedTrapezoids.getTopX1().data(), *topY1 = packedTrapezoids.getTopY1().data();
+    const double *topX2 = packedTrapezoids.getTopX2().data(), *topY2 = packedTrapezoids.getTopY2().data();
+    const double *bottomX1 = packedTrapezoids.getBottomX1().data(), *bottomY1 = packedTrapezoids.getBottomY1().data();
+    const double *bottomX2 = packedTrapezoids.getBottomX2().data(), *bottomY2 = packedTrapezoids.getBottomY2().data();
+
+    const __m256d qx = _mm256_set1_pd(q.x()), qy = _mm256_set1_pd(q.y()), zero = _mm256_setzero_pd();
+    // Index of the containing trapezoid in each lane (-1 if none), the padding never matches
+    __m256i located = _mm256_set1_epi64x(-1);
+    __m256i indexes = _mm256_setr_epi64x(0, 1, 2, 3);
+    const __m256i step = _mm256_set1_epi64x(PACKED_TRAPEZOIDS_BLOCK);
+    size_t padded = packedTrapezoids.getLeftX().size();
+    for(size_t i = 0; i < padded; i += PACKED_TRAPEZOIDS_BLOCK){
+        __m256d topUncertain, bottomUncertain;
+        __m256d top = orient2dFilter(_mm256_loadu_pd(topX1 + i), _mm256_loadu_pd(topY1 + i), _mm256_loadu_pd(topX2 + i), _mm256_loadu_pd(topY2 + i), qx, qy, topUncertain);
+        __m256d bottom = orient2dFilter(_mm256_loadu_pd(bottomX1 + i), _mm256_loadu_pd(bottomY1 + i), _mm256_loadu_pd(bottomX2 + i), _mm256_loadu_pd(bottomY2 + i), qx, qy, bottomUncertain);
+
+        __m256d inside = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(leftX + i), qx, _CMP_LE_OQ), _mm256_cmp_pd(qx, _mm256_loadu_pd(rightX + i), _CMP_LT_OQ));
+        // The trapezoids in the x range whose edges are too close to q are tested again with the exact predicates (rare)
+        if(_mm256_movemask_pd(_mm256_and_pd(inside, _mm256_or_pd(topUncertain, bottomUncertain)))){
+            alignas(32) double laneTop[4], laneBottom[4];
+            _mm256_store_pd(laneTop, top);
+            _mm256_store_pd(laneBottom, bottom);
+            for(size_t lane = 0; lane < PACKED_TRAPEZOIDS_BLOCK; lane++){
+                size_t j = i + lane;
+                laneTop[lane] = ProjectUtils::orient2d(cg3::Point2d(topX1[j], topY1[j]), cg3::Point2d(topX2[j], topY2[j]), q);
+                laneBottom[lane] = ProjectUtils::orient2d(cg3::Point2d(bottomX1[j], bottomY1[j]), cg3::Point2d(bottomX2[j], bottomY2[j]), q);
+            }
+            top = _mm256_load_pd(laneTop);
+            bottom = _mm256_load_pd(laneBottom);
+        }
+        inside = _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(top, zero, _CMP_NGT_UQ), _mm256_cmp_pd(bottom, zero, _CMP_GT_OQ)));
+        located = _mm256_blendv_epi8(located, indexes, _mm256_castpd_si256(inside));
+        indexes = _mm256_add_epi64(indexes, step);
+    }
+
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), located);
+    long long found = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    return found < 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(found);
+}
+
+#endif
+
+/**
+ * @brief Find the trapezoid containing a point with a linear scan of the trapezoids of the map
+ * @param[in] q the query point
+ * @param[in] packedTrapezoids the packed trapezoids of the map
+ * @return the index of the trapezoid containing q, null index if no trapezoid contains it
+ */
+size_t scanTrapezoids(const cg3::Point2d &q, const PackedTrapezoids &packedTrapezoids){
+#ifdef SIMD_LOCATION_AVX2
+    if(simdQueriesSupported()) return scanTrapezoidsAvx2(q, packedTrapezoids);
+#endif
+    return scanTrapezoidsScalar(q, packedTrapezoids);
+}
+
+/**
+ * @brief Locate in which trapezoid lies the given point q, with the fast path for small maps
+ * @param[in] q Query point
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @param[in] packedTrapezoids the packed trapezoids of the map (packed after the last insertion)
+ * @return The index of the trapezoid in which lies the query point
+ * Maps with at most SMALL_MAP_MAX_SEGMENTS segments fit in a few cache lines: testing all their trapezoids without branches is
+ * faster than the dependent loads of the Dag descent. The larger maps, and the points on the border of the bounding box
+ * (contained in no trapezoid by the scan conventions), use queryPoint.
+ */
+size_t queryPointSmallMap(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData, const PackedTrapezoids &packedTrapezoids){
+    if(trapezoidalMapData.getIndexedSegments().size() <= SMALL_MAP_MAX_SEGMENTS){
+        size_t located = scanTrapezoids(q, packedTrapezoids);
+        if(located != std::numeric_limits<size_t>::max()) return located;
+    }
+    return queryPoint(q, dag, trapezoidalMapData);
+}
+
+/**
+ * @brief Check if the vectorized kernel can run on this cpu
+ * @return true if the AVX2 kernel is available, false if the scalar fallback is used
+ */
+bool simdQueriesSupported(){
+#ifdef SIMD_LOCATION_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Point location of a batch of points with the vectorized Dag descent
+ * @param[in] queryPoints the query points
+ * @param[in] dag The DAG search structure
+ * @param[in] packedGeometry the packed geometry of the dataset (built from the same dataset of the Dag)
+ * @return the index of the trapezoid containing each query point, in the order of the query points
+ * The kernel is chosen at runtime: AVX2 if the cpu supports it, the scalar fallback otherwise. Both evaluate the predicates
+ * with the same operations of queryPoint, so the answers are the same.
+ */
+std::vector<size_t> queryPointsSimd(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const PackedGeometry &packedGeometry){
+#ifdef SIMD_LOCATION_AVX2
+    if(simdQueriesSupported()) return queryPointsAvx2(queryPoints, dag, packedGeometry);
+#endif
+    return queryPointsScalar(queryPoints, dag, packedGeometry);
+}
+
+}
@@ -0,0 +1,28 @@
+#ifndef SIMD_LOCATION_H
+#define SIMD_LOCATION_H
+
+#include <cg3/geometry/point2.h>
+#include <vector>
+#include "data_structures/dag.h"
+#include "data_structures/packed_geometry.h"
+#include "data_structures/packed_trapezoids.h"
+#include "data_structures/trapezoidalmap_dataset.h"
+
+/**
+ * @brief Vectorized point location: Dag descent of several query points at once, and linear scan of the trapezoids of small maps
+ */
+namespace algorithms{
+    bool simdQueriesSupported();
+
+    std::vector<size_t> queryPointsSimd(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const PackedGeometry &packedGeometry);
+
+    std::vector<size_t> queryPointsScalar(const std::vector<cg3::Point2d> &queryPoints, const Dag &dag, const PackedGeometry &packedGeometry);
+
+    size_t scanTrapezoids(const cg3::Point2d &q, const PackedTrapezoids &packedTrapezoids);
+
+    size_t scanTrapezoidsScalar(const cg3::Point2d &q, const PackedTrapezoids &packedTrapezoids);
+
+    size_t queryPointSmallMap(const cg3::Point2d &q, const Dag &dag, const TrapezoidalMapDataset &trapezoidalMapData, const PackedTrapezoids &packedTrapezoids);
+}
+
+#endif // SIMD_LOCATION_H
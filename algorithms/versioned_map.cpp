@@ -0,0 +1,155 @@
+#include "versioned_map.h"
+#include "algorithms.h"
+#include "dag_traversal.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#define BOUNDINGBOX 1e+6
+
+/**
+ * @brief Constructor, initializes the structures with the bounding box (version 0)
+ */
+VersionedTrapezoidalMap::VersionedTrapezoidalMap() :
+    trapezoidalMap(cg3::Point2d(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2d(BOUNDINGBOX, BOUNDINGBOX)){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    algorithms::initializeStructures(dag, trapezoidalMap);
+    numTrapezoids.push_back(trapezoidalMap.numTrapezoids());
+    trapezoidHistory.resize(trapezoidalMap.numTrapezoids());
+    ReplacedLeaf noLeaf = {0, Node(Node::NodeType::LEAF, nullIdx, nullIdx, nullIdx)};
+    replacedLeaves.resize(dag.numNodes(), noLeaf);
+}
+
+/**
+ * @brief Insert a segment in the map, creating a new version
+ * @param[in] segment the segment
+ * @return false if the segment was not inserted (it is a duplicate or it intersects the other segments), no version is created
+ * Before the insertion the trapezoids and the leaves it overwrites are saved with the new version (see recordInsertion).
+ */
+bool VersionedTrapezoidalMap::insertSegment(const cg3::Segment2d &segment){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    bool inserted;
+    size_t segmentIdx = trapezoidalMapData.addSegment(segment, inserted);
+    if(!inserted) return false;
+    size_t version = numTrapezoids.size();
+
+    // The segment of the dataset has p1 as first point
+    cg3::Segment2d orderedSegment = trapezoidalMapData.getSegment(segmentIdx);
+    const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment = trapezoidalMapData.getIndexedSegment(segmentIdx);
+    algorithms::SegmentIndexes indexes = {segmentIdx, indexedSegment.first, indexedSegment.second};
+    if(orderedSegment.p1().x() > orderedSegment.p2().x()){
+        cg3::Point2d leftEndpoint = orderedSegment.p2();
+        orderedSegment.setP2(orderedSegment.p1());
+        orderedSegment.setP1(leftEndpoint);
+        std::swap(indexes.leftPointIdx, indexes.rightPointIdx);
+    }
+
+    algorithms::followSegment(orderedSegment, dag, trapezoidalMap, trapezoidalMapData, intersectedTrapezoids);
+    for(size_t trapezoidIdx : intersectedTrapezoids){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(trapezoidIdx);
+        ReplacedLeaf replacedLeaf = {version, Node(Node::NodeType::LEAF, trapezoidIdx, nullIdx, nullIdx)};
+        replacedLeaves[trapezoid.getNodeIdx()] = replacedLeaf;
+        saveTrapezoid(trapezoidIdx);
+        size_t neighbors[4] = {trapezoid.getUpperLeftNeighbor(), trapezoid.getLowerLeftNeighbor(), trapezoid.getUpperRightNeighbor(), trapezoid.getLowerRightNeighbor()};
+        for(size_t neighborIdx : neighbors){
+            if(neighborIdx != nullIdx) saveTrapezoid(neighborIdx);
+        }
+    }
+
+    algorithms::InsertionSlots slots = {trapezoidalMap.numTrapezoids(), dag.numNodes()};
+    algorithms::insertSegment(orderedSegment, indexes, intersectedTrapezoids, slots, dag, trapezoidalMap);
+
+    // The new inner nodes were never leaves
+    numTrapezoids.push_back(trapezoidalMap.numTrapezoids());
+    trapezoidHistory.resize(trapezoidalMap.numTrapezoids());
+    ReplacedLeaf noLeaf = {0, Node(Node::NodeType::LEAF, nullIdx, nullIdx, nullIdx)};
+    replacedLeaves.resize(dag.numNodes(), noLeaf);
+    return true;
+}
+
+/**
+ * @brief Get the last version
+ * @return the number of segments inserted
+ */
+size_t VersionedTrapezoidalMap::getVersion() const{
+    return numTrapezoids.size() - 1;
+}
+
+/**
+ * @brief Locate the trapezoid in which lies a point in a version of the map
+ * @param[in] q Query point
+ * @param[in] version the version
+ * @return The index of the trapezoid in which lies the query point (see getTrapezoid for its content in the version)
+ * The nodes reached from the root in a version are the nodes of that version: the inner nodes never change, and a node replaced
+ * after the version was a leaf, so the search stops there.
+ */
+size_t VersionedTrapezoidalMap::queryPoint(const cg3::Point2d &q, size_t version) const{
+    assert(version < numTrapezoids.size());
+    VersionNodes versionNodes = {dag, replacedLeaves, version};
+    return algorithms::traverseDag(versionNodes, trapezoidalMapData, algorithms::PointPolicy(q));
+}
+
+/**
+ * @brief Get a trapezoid as it was in a version of the map
+ * @param[in] idx the index of the trapezoid (it must exist in the version)
+ * @param[in] version the version
+ * @return the trapezoid: the first copy saved after the version, or the current trapezoid if it was not overwritten after it
+ */
+const Trapezoid &VersionedTrapezoidalMap::getTrapezoid(size_t idx, size_t version) const{
+    assert(version < numTrapezoids.size() && idx < numTrapezoids[version]);
+    const std::vector<TrapezoidVersion> &history = trapezoidHistory[idx];
+    std::vector<TrapezoidVersion>::const_iterator it = std::upper_bound(history.begin(), history.end(), version,
+        [](size_t version, const TrapezoidVersion &trapezoidVersion){ return version < trapezoidVersion.overwrittenVersion; });
+    return it != history.end() ? it->trapezoid : trapezoidalMap.getTrapezoid(idx);
+}
+
+/**
+ * @brief Find the segments above and below a point in a version of the map
+ * @param[in] q the query point
+ * @param[in] version the version
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> VersionedTrapezoidalMap::locate(const cg3::Point2d &q, size_t version) const{
+    const Trapezoid &trapezoid = getTrapezoid(queryPoint(q, version), version);
+    return std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx());
+}
+
+/**
+ * @brief Find the segments above and below a point in the last version of the map
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q
+ */
+std::pair<size_t, size_t> VersionedTrapezoidalMap::locate(const cg3::Point2d &q) const{
+    return locate(q, getVersion());
+}
+
+/**
+ * @brief Get the dataset
+ * @return the dataset
+ */
+const TrapezoidalMapDataset &VersionedTrapezoidalMap::getDataset() const{
+    return trapezoidalMapData;
+}
+
+/**
+ * @brief Save a trapezoid before the insertion of the new version overwrites it
+ * @param[in] idx the index of the trapezoid
+ * A trapezoid is saved once per version, the first copy is the one of the previous version.
+ */
+void VersionedTrapezoidalMap::saveTrapezoid(size_t idx){
+    size_t version = numTrapezoids.size();
+    std::vector<TrapezoidVersion> &history = trapezoidHistory[idx];
+    if(!history.empty() && history.back().overwrittenVersion == version) return;
+    TrapezoidVersion trapezoidVersion = {version, trapezoidalMap.getTrapezoid(idx)};
+    history.push_back(trapezoidVersion);
+}
+
+/**
+ * @brief Get a node of the Dag as it was in the version
+ * @param[in] nodeIdx the index of the node (it must be reachable from the root in the version)
+ * @return the node, or the leaf it replaced if it was replaced after the version
+ */
+const Node &VersionedTrapezoidalMap::VersionNodes::getNode(size_t nodeIdx) const{
+    const ReplacedLeaf &replacedLeaf = replacedLeaves[nodeIdx];
+    return replacedLeaf.replacedVersion > version ? replacedLeaf.leaf : dag.getNode(nodeIdx);
+}
@@ -0,0 +1,79 @@
+#ifndef VERSIONED_MAP_H
+#define VERSIONED_MAP_H
+
+#include <cg3/geometry/segment2.h>
+#include <utility>
+#include <vector>
+#include "algorithms/point_locator.h"
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief This class defines a persistent trapezoidal map: the point queries can be answered on the map of every past version.
+ * The version v is the map after the first v insertions. An insertion appends its new trapezoids and nodes, and overwrites only the
+ * intersected trapezoids, their neighbors and the leaves of the intersected trapezoids: the map keeps the old copy of every overwritten
+ * trapezoid with the version that overwrote it, and for every replaced leaf the version that replaced it. The memory is proportional
+ * to the total size of the insertions, and a query on a past version descends the current Dag, stopping at the nodes that were leaves
+ * in that version.
+ */
+class VersionedTrapezoidalMap : public PointLocator{
+
+public:
+    // Constructor (the version 0 is the empty map)
+    VersionedTrapezoidalMap();
+    // Insert a segment, creating a new version
+    bool insertSegment(const cg3::Segment2d &segment);
+    // Get the last version (the number of insertions)
+    size_t getVersion() const;
+    // Find the index of the trapezoid containing a point in a version
+    size_t queryPoint(const cg3::Point2d &q, size_t version) const;
+    // Get a trapezoid as it was in a version
+    const Trapezoid &getTrapezoid(size_t idx, size_t version) const;
+    // Find the segment above (first) and below (second) a point in a version
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q, size_t version) const;
+    // Find the segment above (first) and below (second) a point in the last version
+    std::pair<size_t, size_t> locate(const cg3::Point2d &q) const;
+    using PointLocator::locate;
+    // Get the dataset (the segments of a version are the first ones)
+    const TrapezoidalMapDataset &getDataset() const;
+
+private:
+    /**
+     * @brief Copy of a trapezoid, valid in the versions before the one that overwrote it
+     */
+    struct TrapezoidVersion{
+        size_t overwrittenVersion;
+        Trapezoid trapezoid;
+    };
+
+    /**
+     * @brief Leaf replaced by an inner node of the Dag
+     */
+    struct ReplacedLeaf{
+        size_t replacedVersion;
+        Node leaf;
+    };
+
+    /**
+     * @brief Node source of traverseDag for the Dag of a version: the nodes replaced after the version are the leaves they replaced
+     */
+    struct VersionNodes{
+        const Dag &dag;
+        const std::vector<ReplacedLeaf> &replacedLeaves;
+        size_t version;
+        const Node &getNode(size_t nodeIdx) const;
+    };
+
+    void saveTrapezoid(size_t idx);
+
+    TrapezoidalMapDataset trapezoidalMapData;
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    std::vector<size_t> numTrapezoids;                          // Number of trapezoids of every version
+    std::vector<std::vector<TrapezoidVersion>> trapezoidHistory; // Old copies of every trapezoid, in the order of the versions
+    std::vector<ReplacedLeaf> replacedLeaves;                   // For every inner node, the leaf it replaced (version 0 if it was created as inner node)
+    std::vector<size_t> intersectedTrapezoids;
+};
+
+#endif // VERSIONED_MAP_H
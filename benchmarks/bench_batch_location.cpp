@@ -0,0 +1,46 @@
+#include "benchmarks.h"
+#include <cstdio>
+#include "algorithms/algorithms.h"
+#include "algorithms/batch_location.h"
+#include "tests/test_utils.h"
+
+namespace benchmarks{
+
+/**
+ * @brief Dag descents (one queryPoint per point, and the interleaved engine) against the offline sweep, for batches of 1/4 to 8 queries
+ * per trapezoid
+ * The ratio where the sweep becomes faster than the interleaved engine sets SWEEP_MIN_QUERIES_PER_TRAPEZOID.
+ */
+void benchmarkBatchLocation(){
+    const size_t mapSegments[] = {1000, 10000, 100000, 300000};
+    const double queriesPerTrapezoid[] = {0.25, 0.5, 1, 2, 4, 8};
+
+    std::printf("%10s %10s %12s %14s %12s %12s\n", "trapezoids", "queries", "per trap.", "queryPoint ms", "Dag ms", "sweep ms");
+    for(size_t numSegments : mapSegments){
+        tests::TestMap map;
+        map.insert(tests::gridSegments(numSegments, 1));
+        size_t numTrapezoids = map.trapezoidalMap.numTrapezoids();
+
+        for(double ratio : queriesPerTrapezoid){
+            std::vector<cg3::Point2d> queryPoints = tests::randomPoints(static_cast<size_t>(ratio * numTrapezoids), 2);
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector<size_t> perPoint(queryPoints.size());
+            for(size_t i = 0; i < queryPoints.size(); i++) perPoint[i] = algorithms::queryPoint(queryPoints[i], map.dag, map.dataset);
+            double perPointTime = elapsedMilliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<size_t> located = algorithms::queryPointsInterleaved(queryPoints, map.dag, map.dataset);
+            double dagTime = elapsedMilliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<size_t> swept = algorithms::locateAllSorted(queryPoints, map.trapezoidalMap);
+            double sweepTime = elapsedMilliseconds(start);
+
+            bool sameAnswers = located == perPoint && swept == perPoint;
+            std::printf("%10zu %10zu %12.2f %14.1f %12.1f %12.1f%s\n", numTrapezoids, queryPoints.size(), ratio, perPointTime, dagTime, sweepTime, sameAnswers ? "" : " (answers differ)");
+        }
+    }
+}
+
+}
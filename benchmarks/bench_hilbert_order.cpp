@@ -0,0 +1,47 @@
+#include "benchmarks.h"
+#include <cstdio>
+#include "algorithms/algorithms.h"
+#include "algorithms/batch_location.h"
+#include "tests/test_utils.h"
+
+namespace benchmarks{
+
+/**
+ * @brief Dag queries in the input (random) order against the Hilbert order of locateAll, for batches from 10k to 1M points
+ * The random order runs the interleaved engine, the Hilbert order sorts the batch and then descends the Dag one query at a time,
+ * as locateAll does with hilbertSort. The sort pays for itself when sort + sorted is below the random order.
+ */
+void benchmarkHilbertOrder(){
+    const size_t mapSegments[] = {1000, 300000};
+    const size_t batchSizes[] = {10000, 100000, 1000000};
+
+    std::printf("%10s %10s %12s %12s %12s\n", "trapezoids", "queries", "random ms", "sort ms", "sorted ms");
+    for(size_t numSegments : mapSegments){
+        tests::TestMap map;
+        map.insert(tests::gridSegments(numSegments, 1));
+
+        for(size_t batchSize : batchSizes){
+            std::vector<cg3::Point2d> queryPoints = tests::randomPoints(batchSize, 2);
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector<size_t> located = algorithms::queryPointsInterleaved(queryPoints, map.dag, map.dataset);
+            double randomTime = elapsedMilliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<size_t> order = algorithms::hilbertOrder(queryPoints, map.trapezoidalMap.getBoundingBox());
+            double sortTime = elapsedMilliseconds(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<size_t> sorted(queryPoints.size());
+            for(size_t i = 0; i < order.size(); i++){
+                sorted[order[i]] = algorithms::queryPoint(queryPoints[order[i]], map.dag, map.dataset);
+            }
+            double sortedTime = elapsedMilliseconds(start);
+
+            std::printf("%10zu %10zu %12.1f %12.1f %12.1f%s\n", map.trapezoidalMap.numTrapezoids(), batchSize, randomTime, sortTime, sortedTime,
+                        located == sorted ? "" : " (answers differ)");
+        }
+    }
+}
+
+}
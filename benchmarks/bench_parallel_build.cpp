@@ -0,0 +1,51 @@
+#include "benchmarks.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include "algorithms/algorithms.h"
+#include "algorithms/parallel_build.h"
+#include "tests/test_utils.h"
+
+namespace benchmarks{
+
+/**
+ * @brief Sequential construction against the slab construction, with 1 to 64 slabs, on short segments (each one in one or two slabs)
+ * and on long segments (most of them crossing most of the slabs)
+ * The slabs are built with one thread and with all the cores, so the first column measures the work of the slabs and the second one
+ * the speedup of the threads. The parts per segment count the slabs crossed by the segments, the sequential fraction is the share of
+ * the time (with all the cores) spent out of the concurrent build of the slabs, in the split and in the join.
+ */
+void benchmarkParallelBuild(){
+    const size_t slabCounts[] = {1, 4, 16, 64};
+    size_t numCores = std::max<unsigned>(1, std::thread::hardware_concurrency());
+
+    std::printf("%-6s %9s %7s %10s %10s %10s %9s %6s\n", "input", "segments", "slabs", "1 thr ms", "all ms", "dag nodes", "parts/seg", "seq %");
+    for(int input = 0; input < 2; input++){
+        std::vector<cg3::Segment2d> segments = input == 0 ? tests::gridSegments(200000, 1) : tests::longSegments(100000, 1);
+        const char *name = input == 0 ? "short" : "long";
+
+        tests::TestMap sequential;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sequential.insert(segments);
+        std::printf("%-6s %9zu %7s %10.0f %10s %10zu %9s %6s\n", name, segments.size(), "-", elapsedMilliseconds(start), "-", sequential.dag.numNodes(), "-", "-");
+
+        for(size_t numSlabs : slabCounts){
+            tests::TestMap parallel;
+            start = std::chrono::steady_clock::now();
+            algorithms::buildTrapezoidalMapParallel(parallel.dag, parallel.trapezoidalMap, sequential.dataset, numSlabs, 1);
+            double oneThreadTime = elapsedMilliseconds(start);
+
+            algorithms::ParallelBuildStats stats;
+            start = std::chrono::steady_clock::now();
+            algorithms::buildTrapezoidalMapParallel(parallel.dag, parallel.trapezoidalMap, sequential.dataset, numSlabs, numCores, &stats);
+            double allThreadsTime = elapsedMilliseconds(start);
+
+            std::printf("%-6s %9zu %7zu %10.0f %10.0f %10zu %9.2f %6.1f%s\n", name, segments.size(), numSlabs, oneThreadTime, allThreadsTime, parallel.dag.numNodes(),
+                        static_cast<double>(stats.numParts) / segments.size(), 100 * stats.sequentialMilliseconds / (stats.slabsMilliseconds + stats.sequentialMilliseconds),
+                        parallel.trapezoidalMap.numTrapezoids() == sequential.trapezoidalMap.numTrapezoids() ? "" : " (maps differ)");
+        }
+    }
+    std::printf("%zu cores\n", numCores);
+}
+
+}
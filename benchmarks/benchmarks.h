@@ -0,0 +1,23 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <chrono>
+
+/**
+ * @brief Benchmarks of the query engines and of the construction, one function per file, run by main
+ * Every benchmark prints a table of timings; the numbers quoted in the sources come from these tables.
+ */
+namespace benchmarks{
+    // Milliseconds elapsed since a given time
+    inline double elapsedMilliseconds(std::chrono::steady_clock::time_point start){
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void benchmarkBatchLocation();
+
+    void benchmarkHilbertOrder();
+
+    void benchmarkParallelBuild();
+}
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,32 @@
+# Benchmarks of the query engines and of the construction (console application, without the viewer)
+TEMPLATE = app
+TARGET = benchmarks
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+# Optimized build, without the asserts
+CONFIG += release
+CONFIG -= debug
+DEFINES += NDEBUG
+
+# The benchmarks use only the core of cg3lib
+CONFIG += CG3_CORE
+include (../cg3lib/cg3.pri)
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    $$files(../algorithms/*.cpp) \
+    $$files(../data_structures/*.cpp) \
+    ../tests/test_utils.cpp \
+    ../utils/fileutils.cpp \
+    ../utils/predicates.cpp \
+    ../utils/projectUtils.cpp \
+    bench_batch_location.cpp \
+    bench_hilbert_order.cpp \
+    bench_parallel_build.cpp \
+    main.cpp
+
+HEADERS += \
+    ../tests/test_utils.h \
+    benchmarks.h
@@ -0,0 +1,25 @@
+#include "benchmarks.h"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Run the benchmarks (all of them, or the ones whose name contains the first argument)
+ */
+int main(int argc, char *argv[]){
+    struct Benchmark{
+        const char *name;
+        void (*run)();
+    };
+    const Benchmark allBenchmarks[] = {
+        {"batch_location", benchmarks::benchmarkBatchLocation},
+        {"hilbert_order", benchmarks::benchmarkHilbertOrder},
+        {"parallel_build", benchmarks::benchmarkParallelBuild},
+    };
+
+    for(const Benchmark &benchmark : allBenchmarks){
+        if(argc > 1 && std::strstr(benchmark.name, argv[1]) == nullptr) continue;
+        std::printf("== %s\n", benchmark.name);
+        benchmark.run();
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+#ifndef CHUNKED_VECTOR_H
+#define CHUNKED_VECTOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Number of items of a chunk of a chunked vector (log2)
+#define CHUNKED_VECTOR_CHUNK_BITS 8
+
+/**
+ * @brief This class defines a vector stored in fixed size chunks, with copy-on-write chunks.
+ * The items are indexed in O(1) (chunk table, then the item in the chunk) and never move when the vector grows, since a full
+ * chunk is never reallocated. The copy of a chunked vector shares the chunks of the original one and copies only the chunk table:
+ * a chunk is copied the first time one of the two vectors writes it while it is still shared, so the other one never sees the change.
+ * This makes the copy of the Dag and of the trapezoidal map cheap enough to take a snapshot of them after every insertion.
+ * The chunks allocated by reserve, and the private chunks of a cleared vector, are kept as spare chunks for the next items, so a
+ * vector growing within its reserved capacity never allocates.
+ */
+template<class T>
+class ChunkedVector{
+
+public:
+    static const size_t CHUNK_BITS = CHUNKED_VECTOR_CHUNK_BITS;
+    static const size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static const size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+    /**
+     * @brief Iterator on the items (read only)
+     */
+    class const_iterator{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        const_iterator(const ChunkedVector *vector, size_t idx) : vector(vector), idx(idx){}
+        const T &operator*() const{ return (*vector)[idx]; }
+        const T *operator->() const{ return &(*vector)[idx]; }
+        const_iterator &operator++(){ idx++; return *this; }
+        const_iterator operator++(int){ const_iterator old = *this; idx++; return old; }
+        bool operator==(const const_iterator &other) const{ return idx == other.idx; }
+        bool operator!=(const const_iterator &other) const{ return idx != other.idx; }
+    private:
+        const ChunkedVector *vector;
+        size_t idx;
+    };
+
+    // Constructor
+    ChunkedVector() : count(0){}
+
+    // Copy (the copy shares the chunks of the items, not the spare chunks)
+    ChunkedVector(const ChunkedVector &other) : chunks(other.chunks), chunkData(other.chunkData), count(other.count){}
+
+    ChunkedVector &operator=(const ChunkedVector &other){
+        chunks = other.chunks;
+        chunkData = other.chunkData;
+        count = other.count;
+        return *this;
+    }
+
+    // Move (the moved vector is left empty, with no chunks)
+    ChunkedVector(ChunkedVector &&other) :
+        chunks(std::move(other.chunks)), chunkData(std::move(other.chunkData)), spareChunks(std::move(other.spareChunks)), count(other.count){
+        other.count = 0;
+    }
+
+    ChunkedVector &operator=(ChunkedVector &&other){
+        if(this == &other) return *this;
+        chunks = std::move(other.chunks);
+        chunkData = std::move(other.chunkData);
+        spareChunks = std::move(other.spareChunks);
+        count = other.count;
+        other.chunks.clear();
+        other.chunkData.clear();
+        other.spareChunks.clear();
+        other.count = 0;
+        return *this;
+    }
+
+    // Add an item at the end
+    void push_back(const T &item){
+        if((count & CHUNK_MASK) == 0){
+            std::shared_ptr<Chunk> chunk;
+            if(!spareChunks.empty()){
+                chunk = spareChunks.back();
+                spareChunks.pop_back();
+            }else{
+                chunk = newChunk();
+            }
+            chunks.push_back(chunk);
+            chunkData.push_back(chunk->data());
+        }else{
+            detach(chunks.size() - 1);
+        }
+        chunks.back()->push_back(item);
+        count++;
+    }
+
+    // Get an item (read only, never copies a chunk)
+    const T &operator[](size_t idx) const{
+        return chunkData[idx >> CHUNK_BITS][idx & CHUNK_MASK];
+    }
+
+    // Get an item to modify it (its chunk is copied if it is shared with another vector)
+    T &getMutable(size_t idx){
+        detach(idx >> CHUNK_BITS);
+        return (*chunks[idx >> CHUNK_BITS])[idx & CHUNK_MASK];
+    }
+
+    // Reserve the storage for a number of items (chunk tables and spare chunks), so the vector does not allocate while it grows up to it
+    void reserve(size_t capacity){
+        size_t capacityChunks = (capacity + CHUNK_MASK) >> CHUNK_BITS;
+        chunks.reserve(capacityChunks);
+        chunkData.reserve(capacityChunks);
+        if(capacityChunks > chunks.size() + spareChunks.size()){
+            spareChunks.reserve(capacityChunks - chunks.size());
+            while(chunks.size() + spareChunks.size() < capacityChunks) spareChunks.push_back(newChunk());
+        }
+    }
+
+    // Get the number of items
+    size_t size() const{
+        return count;
+    }
+
+    bool empty() const{
+        return count == 0;
+    }
+
+    // Remove all the items (the chunks shared with other vectors are left to them, the other ones become spare chunks)
+    void clear(){
+        for(std::shared_ptr<Chunk> &chunk : chunks){
+            if(chunk.use_count() != 1) continue;
+            chunk->clear();
+            spareChunks.push_back(chunk);
+        }
+        chunks.clear();
+        chunkData.clear();
+        count = 0;
+    }
+
+    // Remove the items after the first numItems ones (the whole chunks removed become spare chunks, if they are private)
+    void truncate(size_t numItems){
+        if(numItems >= count) return;
+        size_t numItemChunks = (numItems + CHUNK_MASK) >> CHUNK_BITS;
+        while(chunks.size() > numItemChunks){
+            if(chunks.back().use_count() == 1){
+                chunks.back()->clear();
+                spareChunks.push_back(chunks.back());
+            }
+            chunks.pop_back();
+            chunkData.pop_back();
+        }
+        if((numItems & CHUNK_MASK) != 0){
+            detach(chunks.size() - 1);
+            chunks.back()->erase(chunks.back()->begin() + (numItems & CHUNK_MASK), chunks.back()->end());
+        }
+        count = numItems;
+    }
+
+    // Get the table of the chunks: the item idx is chunks[idx >> CHUNK_BITS][idx & CHUNK_MASK]
+    const T *const *getChunks() const{
+        return chunkData.data();
+    }
+
+    size_t numChunks() const{
+        return chunks.size();
+    }
+
+    // Get the number of vectors sharing a chunk (1 if the chunk is private to this vector)
+    long chunkUseCount(size_t chunkIdx) const{
+        return chunks[chunkIdx].use_count();
+    }
+
+    const_iterator begin() const{
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const{
+        return const_iterator(this, count);
+    }
+
+private:
+    typedef std::vector<T> Chunk;
+
+    // Allocate an empty chunk, reserved for CHUNK_SIZE items
+    static std::shared_ptr<Chunk> newChunk(){
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+        chunk->reserve(CHUNK_SIZE);
+        return chunk;
+    }
+
+    // Make a chunk private to this vector, copying it if it is shared
+    void detach(size_t chunkIdx){
+        if(chunks[chunkIdx].use_count() == 1) return;
+        std::shared_ptr<Chunk> chunk = newChunk();
+        chunk->assign(chunks[chunkIdx]->begin(), chunks[chunkIdx]->end());
+        chunks[chunkIdx] = chunk;
+        chunkData[chunkIdx] = chunk->data();
+    }
+
+    std::vector<std::shared_ptr<Chunk>> chunks; // Chunks, each one reserved for CHUNK_SIZE items so it is never reallocated
+    std::vector<const T *> chunkData;           // Items of the chunks, for the indexing without the reference counts
+    std::vector<std::shared_ptr<Chunk>> spareChunks; // Empty chunks, private to this vector, used before allocating new ones
+    size_t count;
+};
+
+template<class T> const size_t ChunkedVector<T>::CHUNK_BITS;
+template<class T> const size_t ChunkedVector<T>::CHUNK_SIZE;
+template<class T> const size_t ChunkedVector<T>::CHUNK_MASK;
+
+#endif // CHUNKED_VECTOR_H
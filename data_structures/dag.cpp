@@ -14,6 +14,15 @@ void Dag::addNode(Node &node){
     nodes.push_back(node);
 }
 
+/**
+ * @brief Reserve the storage of the nodes
+ * @param[in] numNodes the number of nodes expected
+ * The chunks of the nodes never move, they are allocated here with the chunk table
+ */
+void Dag::reserve(size_t numNodes){
+    nodes.reserve(numNodes);
+}
+
 /**
  * @brief Replace an old node with a new one
  * @param[in] node the node
@@ -21,15 +30,15 @@ void Dag::addNode(Node &node){
  * Insert the given node replacing a old one
  */
 void Dag::replaceNode(Node &node, size_t idx){
-    nodes[idx] = node;
+    nodes.getMutable(idx) = node;
 }
 
 /**
  * @brief Get the nodes of the Dag
- * @return the vector containing the nodes
+ * @return the chunked vector containing the nodes
  * Return the vector of the nodes
  */
-const std::vector<Node> &Dag::getNodes() const{
+const ChunkedVector<Node> &Dag::getNodes() const{
     return nodes;
 }
 
@@ -58,6 +67,14 @@ size_t Dag::numNodes() const{
     return nodes.size();
 }
 
+/**
+ * @brief Delete the last nodes of the Dag
+ * @param[in] numNodes the number of nodes to keep
+ */
+void Dag::truncate(size_t numNodes){
+    nodes.truncate(numNodes);
+}
+
 /**
  * @brief Delete all nodes stored in the Dag
  */
@@ -0,0 +1,95 @@
+#include "insertion_journal.h"
+#include <cassert>
+
+/**
+ * @brief Constructor of the journal
+ * @param[in] maxInsertions the number of insertions kept in the journal (0 for no limit)
+ */
+InsertionJournal::InsertionJournal(size_t maxInsertions) : maxInsertions(maxInsertions){}
+
+/**
+ * @brief Start the record of an insertion
+ * @param[in] segmentIdx the dataset index of the inserted segment (the last segment of the dataset)
+ * @param[in] dag The DAG search structure, before the insertion
+ * @param[in] trapezoidalMap The trapezoidal Map data structure, before the insertion
+ * If the journal is full the oldest insertion is forgotten. The storage of the forgotten and of the undone records is reused.
+ */
+void InsertionJournal::beginInsertion(size_t segmentIdx, const Dag &dag, const TrapezoidalMap &trapezoidalMap){
+    Record record;
+    if(maxInsertions > 0 && records.size() >= maxInsertions){
+        record = std::move(records.front());
+        records.pop_front();
+    }else if(!spareRecords.empty()){
+        record = std::move(spareRecords.back());
+        spareRecords.pop_back();
+    }
+    record.segmentIdx = segmentIdx;
+    record.numTrapezoids = trapezoidalMap.numTrapezoids();
+    record.numNodes = dag.numNodes();
+    record.trapezoids.clear();
+    record.nodes.clear();
+    records.push_back(std::move(record));
+}
+
+/**
+ * @brief Save a trapezoid overwritten by the current insertion
+ * @param[in] idx the index of the trapezoid
+ * @param[in] trapezoid the trapezoid, before the insertion
+ */
+void InsertionJournal::saveTrapezoid(size_t idx, const Trapezoid &trapezoid){
+    records.back().trapezoids.push_back(std::make_pair(idx, trapezoid));
+}
+
+/**
+ * @brief Save a node overwritten by the current insertion
+ * @param[in] idx the index of the node
+ * @param[in] node the node, before the insertion
+ */
+void InsertionJournal::saveNode(size_t idx, const Node &node){
+    records.back().nodes.push_back(std::make_pair(idx, node));
+}
+
+/**
+ * @brief Undo the last recorded insertion
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData The trapezoidal map dataset data structure
+ * @return false if there is no insertion to undo
+ * The saved trapezoids and nodes are written back and the trapezoids and the nodes appended by the insertion are removed.
+ * The segment is removed from the dataset with the endpoints added with it, so it can be inserted again.
+ */
+bool InsertionJournal::undoLastInsertion(Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData){
+    if(records.empty()) return false;
+    Record &record = records.back();
+    assert(record.segmentIdx + 1 == trapezoidalMapData.getIndexedSegments().size());
+    trapezoidalMapData.removeLastSegment();
+    for(std::pair<size_t, Trapezoid> &saved : record.trapezoids){
+        trapezoidalMap.replaceTrapezoid(saved.second, saved.first);
+    }
+    for(std::pair<size_t, Node> &saved : record.nodes){
+        dag.replaceNode(saved.second, saved.first);
+    }
+    trapezoidalMap.truncate(record.numTrapezoids);
+    dag.truncate(record.numNodes);
+    spareRecords.push_back(std::move(record));
+    records.pop_back();
+    return true;
+}
+
+/**
+ * @brief Get the number of insertions that can be undone
+ * @return the number of recorded insertions
+ */
+size_t InsertionJournal::numInsertions() const{
+    return records.size();
+}
+
+/**
+ * @brief Forget all the recorded insertions
+ */
+void InsertionJournal::clear(){
+    while(!records.empty()){
+        spareRecords.push_back(std::move(records.back()));
+        records.pop_back();
+    }
+}
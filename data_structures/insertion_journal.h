@@ -0,0 +1,58 @@
+#ifndef INSERTION_JOURNAL_H
+#define INSERTION_JOURNAL_H
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "dag.h"
+#include "trapezoidalmap.h"
+#include "trapezoidalmap_dataset.h"
+
+// Number of insertions kept in the journal by default (the oldest ones are forgotten beyond it)
+#define INSERTION_JOURNAL_MAX_INSERTIONS 64
+
+/**
+ * @brief This class defines a journal of the last insertions in the trapezoidal map and in the Dag, to undo them.
+ * For every insertion it records the number of trapezoids and of nodes before it and a copy of the trapezoids and of the nodes
+ * it overwrites: undoing the insertion restores the copies and removes the appended trapezoids and nodes, in time proportional
+ * to the size of the insertion, and removes the segment from the dataset (the inserted segments are the last ones of the dataset).
+ * The journal is valid only while all the changes of the structures are recorded in it (an insertion not recorded, or a clear of
+ * the structures, requires to clear the journal).
+ */
+class InsertionJournal{
+
+public:
+    // Constructor
+    InsertionJournal(size_t maxInsertions = INSERTION_JOURNAL_MAX_INSERTIONS);
+    // Start the record of an insertion, with the sizes of the structures before it
+    void beginInsertion(size_t segmentIdx, const Dag &dag, const TrapezoidalMap &trapezoidalMap);
+    // Save a trapezoid before the insertion overwrites it
+    void saveTrapezoid(size_t idx, const Trapezoid &trapezoid);
+    // Save a node before the insertion overwrites it
+    void saveNode(size_t idx, const Node &node);
+    // Restore the structures and the dataset as they were before the last recorded insertion
+    bool undoLastInsertion(Dag &dag, TrapezoidalMap &trapezoidalMap, TrapezoidalMapDataset &trapezoidalMapData);
+    // Get the number of insertions that can be undone
+    size_t numInsertions() const;
+    // Forget all the insertions
+    void clear();
+
+private:
+    /**
+     * @brief Record of an insertion
+     */
+    struct Record{
+        size_t segmentIdx;      // Dataset index of the inserted segment
+        size_t numTrapezoids;
+        size_t numNodes;
+        std::vector<std::pair<size_t, Trapezoid>> trapezoids;  // Overwritten trapezoids, with their index
+        std::vector<std::pair<size_t, Node>> nodes;            // Overwritten nodes, with their index
+    };
+
+    std::deque<Record> records;         // Records of the last insertions, the last one at the back
+    std::vector<Record> spareRecords;   // Records of the undone insertions, kept to reuse their storage
+    size_t maxInsertions;
+};
+
+#endif // INSERTION_JOURNAL_H
@@ -0,0 +1,152 @@
+#include "insertion_log.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "utils/fileutils.h"
+
+namespace{
+    // Record on the disk: type, sequence number, segment index, the four coordinates of the endpoints, checksum of the previous fields
+    const size_t RECORD_FIELDS_SIZE = 3 * sizeof(uint64_t) + 4 * sizeof(double);
+    const size_t RECORD_SIZE = RECORD_FIELDS_SIZE + sizeof(uint64_t);
+}
+
+/**
+ * @brief Constructor, the log must be opened before appending the records
+ */
+InsertionLog::InsertionLog() : fd(-1), syncedSize(0), tornTail(false){}
+
+/**
+ * @brief Destructor, syncs the buffered records
+ */
+InsertionLog::~InsertionLog(){
+    close();
+}
+
+/**
+ * @brief Open a log for appending the records, creating it if it does not exist
+ * @param[in] filename the file of the log
+ * @return false if the file cannot be opened
+ * The records after the last valid one (cut by a crash) are removed, so the new records follow the valid ones.
+ */
+bool InsertionLog::open(const std::string &filename){
+    close();
+    size_t validSize = readRecords(filename).size() * RECORD_SIZE;
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT, 0644);
+    if(fd < 0) return false;
+    if(ftruncate(fd, static_cast<off_t>(validSize)) != 0 || lseek(fd, static_cast<off_t>(validSize), SEEK_SET) < 0){
+        close();
+        return false;
+    }
+    buffer.reserve(INSERTION_LOG_BATCH_RECORDS * RECORD_SIZE);
+    syncedSize = static_cast<off_t>(validSize);
+    tornTail = false;
+    return true;
+}
+
+/**
+ * @brief Sync the buffered records and close the log
+ */
+void InsertionLog::close(){
+    if(fd < 0) return;
+    sync();
+    ::close(fd);
+    fd = -1;
+    buffer.clear();
+}
+
+/**
+ * @brief Check if the log is open
+ * @return true if the log is open
+ */
+bool InsertionLog::isOpen() const{
+    return fd >= 0;
+}
+
+/**
+ * @brief Append the record of an inserted or removed segment
+ * @param[in] record the record
+ * @return false if the record was not appended: the log is closed, or the buffer holds a full batch that could not be synced
+ * The record is durable after the next sync: the batch is synced when it has INSERTION_LOG_BATCH_RECORDS records, or by sync. A full
+ * batch that could not be synced is retried by the next append, which refuses its record if the retry fails too, so the buffer never
+ * holds more than a batch.
+ */
+bool InsertionLog::append(const Record &record){
+    const size_t batchSize = INSERTION_LOG_BATCH_RECORDS * RECORD_SIZE;
+    if(fd < 0) return false;
+    if(buffer.size() >= batchSize && !sync()) return false;
+
+    char bytes[RECORD_SIZE];
+    uint64_t fields[3] = {static_cast<uint64_t>(record.type), record.sequence, record.segmentIdx};
+    const cg3::Segment2d &segment = record.segment;
+    double coordinates[4] = {segment.p1().x(), segment.p1().y(), segment.p2().x(), segment.p2().y()};
+    std::memcpy(bytes, fields, sizeof(fields));
+    std::memcpy(bytes + sizeof(fields), coordinates, sizeof(coordinates));
+    uint64_t checksum = FileUtils::checksum(bytes, RECORD_FIELDS_SIZE);
+    std::memcpy(bytes + RECORD_FIELDS_SIZE, &checksum, sizeof(checksum));
+    buffer.insert(buffer.end(), bytes, bytes + RECORD_SIZE);
+    if(buffer.size() >= batchSize) sync();
+    return true;
+}
+
+/**
+ * @brief Write the buffered records and wait for them to be on the disk
+ * @return false if the records could not be written (they stay in the buffer)
+ * A failed write or fsync may leave a part of the buffer in the file: before the retry the file is cut back to the synced records,
+ * so the buffer is written again in the same place.
+ */
+bool InsertionLog::sync(){
+    if(fd < 0) return false;
+    if(buffer.empty()) return true;
+    if(tornTail){
+        if(ftruncate(fd, syncedSize) != 0 || lseek(fd, syncedSize, SEEK_SET) != syncedSize) return false;
+        tornTail = false;
+    }
+    if(!FileUtils::writeAll(fd, buffer.data(), buffer.size()) || fsync(fd) != 0){
+        tornTail = true;
+        return false;
+    }
+    syncedSize += static_cast<off_t>(buffer.size());
+    buffer.clear();
+    return true;
+}
+
+/**
+ * @brief Remove all the records of the log, the buffered ones too
+ * @return false if the log could not be truncated (the next sync truncates it before writing)
+ */
+bool InsertionLog::truncate(){
+    if(fd < 0) return false;
+    buffer.clear();
+    // If the truncation fails, the next sync cuts the file before writing
+    syncedSize = 0;
+    tornTail = true;
+    if(ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) != 0 || fsync(fd) != 0) return false;
+    tornTail = false;
+    return true;
+}
+
+/**
+ * @brief Read the records of a log, up to the first invalid one
+ * @param[in] filename the file of the log
+ * @return the valid records (none if the file does not exist)
+ */
+std::vector<InsertionLog::Record> InsertionLog::readRecords(const std::string &filename){
+    std::vector<Record> records;
+    std::vector<char> data;
+    if(!FileUtils::readAll(filename, data)) return records;
+    for(size_t offset = 0; offset + RECORD_SIZE <= data.size(); offset += RECORD_SIZE){
+        const char *record = data.data() + offset;
+        uint64_t checksum;
+        std::memcpy(&checksum, record + RECORD_FIELDS_SIZE, sizeof(checksum));
+        if(checksum != FileUtils::checksum(record, RECORD_FIELDS_SIZE)) break;
+        uint64_t fields[3];
+        double coordinates[4];
+        std::memcpy(fields, record, sizeof(fields));
+        std::memcpy(coordinates, record + sizeof(fields), sizeof(coordinates));
+        if(fields[0] > static_cast<uint64_t>(RecordType::REMOVAL)) break;
+        Record parsed = {static_cast<RecordType>(fields[0]), fields[1], static_cast<size_t>(fields[2]),
+                         cg3::Segment2d(cg3::Point2d(coordinates[0], coordinates[1]), cg3::Point2d(coordinates[2], coordinates[3]))};
+        records.push_back(parsed);
+    }
+    return records;
+}
@@ -0,0 +1,65 @@
+#ifndef INSERTION_LOG_H
+#define INSERTION_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+#include <cg3/geometry/segment2.h>
+
+// Number of records buffered before they are written and synced to the disk
+#define INSERTION_LOG_BATCH_RECORDS 1024
+
+/**
+ * @brief This class defines an append-only log of the segments inserted in the map and removed from it, to rebuild it after a crash.
+ * Every record stores the operation (insertion or removal of the last segment), its sequence number, the dataset index of the segment
+ * and its endpoints, with a checksum. The records are buffered and written with
+ * a single write and fsync per batch, so a crash loses at most the records of the last batch not synced. A record cut by a crash
+ * fails its checksum: reading the log stops at the first invalid record, and opening it removes the invalid tail. A batch whose write
+ * or fsync failed is written again after the last synced record, so a retry never duplicates the records written before the failure.
+ */
+class InsertionLog{
+
+public:
+    // Operation of a record
+    enum class RecordType{INSERTION, REMOVAL};
+
+    /**
+     * @brief Record of an inserted or removed segment
+     */
+    struct Record{
+        RecordType type;
+        uint64_t sequence;      // Number of the operations logged before this one
+        size_t segmentIdx;
+        cg3::Segment2d segment;
+    };
+
+    // Constructor (the log is closed)
+    InsertionLog();
+    ~InsertionLog();
+    // Open the log for appending, after its valid records
+    bool open(const std::string &filename);
+    // Sync and close the log
+    void close();
+    bool isOpen() const;
+    // Append a record (the batch is synced when it is full), refused if the log is closed or a full batch cannot be synced
+    bool append(const Record &record);
+    // Write the buffered records and wait for them to be on the disk
+    bool sync();
+    // Remove all the records (after a snapshot that contains them)
+    bool truncate();
+    // Read the valid records of a log
+    static std::vector<Record> readRecords(const std::string &filename);
+
+private:
+    InsertionLog(const InsertionLog &);
+    InsertionLog &operator=(const InsertionLog &);
+
+    int fd;
+    std::vector<char> buffer;   // Records not yet written
+    off_t syncedSize;           // Size of the file up to the last synced record
+    bool tornTail;              // A failed sync may have written a part of the buffer after the synced records
+};
+
+#endif // INSERTION_LOG_H
@@ -0,0 +1,65 @@
+#include "map_snapshot.h"
+
+/**
+ * @brief Constructor
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] points the points of the dataset
+ * @param[in] indexedSegments the segments of the dataset
+ * @param[in] version the version of the snapshot
+ * The structures are copied sharing their chunks, so the cost is the size of the chunk tables
+ */
+MapSnapshot::MapSnapshot(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const ChunkedVector<cg3::Point2d> &points,
+                         const ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> &indexedSegments, size_t version) :
+    dag(dag), trapezoidalMap(trapezoidalMap), points(points), indexedSegments(indexedSegments), version(version){}
+
+/**
+ * @brief Get the Dag of the snapshot
+ * @return the Dag
+ */
+const Dag &MapSnapshot::getDag() const{
+    return dag;
+}
+
+/**
+ * @brief Get the trapezoidal map of the snapshot
+ * @return the trapezoidal map
+ */
+const TrapezoidalMap &MapSnapshot::getTrapezoidalMap() const{
+    return trapezoidalMap;
+}
+
+/**
+ * @brief Get a point of the dataset given its index
+ * @param[in] idx the index of the point
+ * @return the point
+ */
+const cg3::Point2d &MapSnapshot::getPoint(size_t idx) const{
+    return points[idx];
+}
+
+/**
+ * @brief Get a segment of the dataset given its index
+ * @param[in] idx the index of the segment
+ * @return the segment, with the endpoints in the order of the dataset
+ */
+cg3::Segment2d MapSnapshot::getSegment(size_t idx) const{
+    const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment = indexedSegments[idx];
+    return cg3::Segment2d(points[indexedSegment.first], points[indexedSegment.second]);
+}
+
+/**
+ * @brief Get the number of segments of the dataset
+ * @return the number of segments
+ */
+size_t MapSnapshot::numSegments() const{
+    return indexedSegments.size();
+}
+
+/**
+ * @brief Get the version of the snapshot
+ * @return the number of snapshots published before this one
+ */
+size_t MapSnapshot::getVersion() const{
+    return version;
+}
@@ -0,0 +1,45 @@
+#ifndef MAP_SNAPSHOT_H
+#define MAP_SNAPSHOT_H
+
+#include <cstddef>
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/segment2.h>
+#include "data_structures/chunked_vector.h"
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+/**
+ * @brief This class defines an immutable version of the trapezoidal map, the Dag and the geometry of the dataset.
+ * A snapshot is a copy of the structures taken after an insertion: the copies share the chunks with the structures of the writer, so
+ * the snapshot costs the chunk tables, and the chunks modified by the next insertions are copied by the writer.
+ * The snapshot provides the points and the segments with the accessors of the dataset, so the Dag can be searched on it.
+ */
+class MapSnapshot{
+
+public:
+    // Constructor (copies the structures, sharing their chunks)
+    MapSnapshot(const Dag &dag, const TrapezoidalMap &trapezoidalMap, const ChunkedVector<cg3::Point2d> &points,
+                const ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> &indexedSegments, size_t version);
+    // Get the Dag
+    const Dag &getDag() const;
+    // Get the trapezoidal map
+    const TrapezoidalMap &getTrapezoidalMap() const;
+    // Get a point of the dataset given its index
+    const cg3::Point2d &getPoint(size_t idx) const;
+    // Get a segment of the dataset given its index
+    cg3::Segment2d getSegment(size_t idx) const;
+    // Get the number of segments of the dataset
+    size_t numSegments() const;
+    // Get the version (the number of publications before this one)
+    size_t getVersion() const;
+
+private:
+    Dag dag;
+    TrapezoidalMap trapezoidalMap;
+    ChunkedVector<cg3::Point2d> points;
+    ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> indexedSegments;
+    size_t version;
+};
+
+#endif // MAP_SNAPSHOT_H
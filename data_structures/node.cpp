@@ -1,4 +1,5 @@
 #include "node.h"
+#include <cstddef>
 
 /**
  * @brief Constructor of a node
@@ -44,3 +45,35 @@ size_t Node::getLeftIdx() const{
 size_t Node::getRightIdx() const{
     return rightIdx;
 }
+
+/**
+ * @brief Get the byte offset of the type in the node record
+ * @return the offset of the type field
+*/
+size_t Node::typeOffset(){
+    return offsetof(Node, type);
+}
+
+/**
+ * @brief Get the byte offset of the stored index in the node record
+ * @return the offset of the index field
+*/
+size_t Node::idxOffset(){
+    return offsetof(Node, nodeIdx);
+}
+
+/**
+ * @brief Get the byte offset of the left child index in the node record
+ * @return the offset of the left child field
+*/
+size_t Node::leftIdxOffset(){
+    return offsetof(Node, leftIdx);
+}
+
+/**
+ * @brief Get the byte offset of the right child index in the node record
+ * @return the offset of the right child field
+*/
+size_t Node::rightIdxOffset(){
+    return offsetof(Node, rightIdx);
+}
@@ -27,6 +27,11 @@ public:
     size_t getLeftIdx() const;
     // Get the right child index of the node
     size_t getRightIdx() const;
+    // Byte offsets of the fields in the node record (used by the vectorized traversal to gather the nodes)
+    static size_t typeOffset();
+    static size_t idxOffset();
+    static size_t leftIdxOffset();
+    static size_t rightIdxOffset();
 
 private:
     // Type of the node
@@ -0,0 +1,102 @@
+#include "packed_geometry.h"
+
+/**
+ * @brief empty constructor
+ */
+PackedGeometry::PackedGeometry(){}
+
+/**
+ * @brief Pack the points and the segments of a dataset, replacing the previous data
+ * @param[in] trapezoidalMapData the trapezoidal map dataset
+ */
+void PackedGeometry::build(const TrapezoidalMapDataset &trapezoidalMapData){
+    clear();
+    const std::vector<cg3::Point2d> &points = trapezoidalMapData.getPoints();
+    const std::vector<TrapezoidalMapDataset::IndexedSegment2d> &segments = trapezoidalMapData.getIndexedSegments();
+
+    pointsX.reserve(points.size());
+    for(const cg3::Point2d &point : points){
+        pointsX.push_back(point.x());
+    }
+
+    segmentsX1.reserve(segments.size());
+    segmentsY1.reserve(segments.size());
+    segmentsX2.reserve(segments.size());
+    segmentsY2.reserve(segments.size());
+    for(const TrapezoidalMapDataset::IndexedSegment2d &segment : segments){
+        // Endpoints ordered by x
+        const cg3::Point2d &p1 = points[segment.first].x() <= points[segment.second].x() ? points[segment.first] : points[segment.second];
+        const cg3::Point2d &p2 = points[segment.first].x() <= points[segment.second].x() ? points[segment.second] : points[segment.first];
+        segmentsX1.push_back(p1.x());
+        segmentsY1.push_back(p1.y());
+        segmentsX2.push_back(p2.x());
+        segmentsY2.push_back(p2.y());
+    }
+}
+
+/**
+ * @brief Get the x coordinates of the points
+ * @return the vector of the x coordinates
+ */
+const std::vector<double> &PackedGeometry::getPointsX() const{
+    return pointsX;
+}
+
+/**
+ * @brief Get the x coordinates of the left endpoints of the segments
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedGeometry::getSegmentsX1() const{
+    return segmentsX1;
+}
+
+/**
+ * @brief Get the y coordinates of the left endpoints of the segments
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedGeometry::getSegmentsY1() const{
+    return segmentsY1;
+}
+
+/**
+ * @brief Get the x coordinates of the right endpoints of the segments
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedGeometry::getSegmentsX2() const{
+    return segmentsX2;
+}
+
+/**
+ * @brief Get the y coordinates of the right endpoints of the segments
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedGeometry::getSegmentsY2() const{
+    return segmentsY2;
+}
+
+/**
+ * @brief Get the number of packed points
+ * @return the number of points
+ */
+size_t PackedGeometry::numPoints() const{
+    return pointsX.size();
+}
+
+/**
+ * @brief Get the number of packed segments
+ * @return the number of segments
+ */
+size_t PackedGeometry::numSegments() const{
+    return segmentsX1.size();
+}
+
+/**
+ * @brief Remove all the packed data
+ */
+void PackedGeometry::clear(){
+    pointsX.clear();
+    segmentsX1.clear();
+    segmentsY1.clear();
+    segmentsX2.clear();
+    segmentsY2.clear();
+}
@@ -0,0 +1,39 @@
+#ifndef PACKED_GEOMETRY_H
+#define PACKED_GEOMETRY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "data_structures/trapezoidalmap_dataset.h"
+
+/**
+ * @brief This class stores the geometry of the dataset in flat arrays (structure of arrays), as needed by the vectorized queries.
+ * For every point it stores its x coordinate (the only one tested by the x-nodes), for every segment the coordinates
+ * of its endpoints ordered by x (as tested by the y-nodes). The indexes are the same of the dataset.
+ */
+class PackedGeometry{
+
+public:
+    // Constructor
+    PackedGeometry();
+    // Pack the points and the segments of a dataset
+    void build(const TrapezoidalMapDataset &trapezoidalMapData);
+    // Get the arrays
+    const std::vector<double> &getPointsX() const;
+    const std::vector<double> &getSegmentsX1() const;
+    const std::vector<double> &getSegmentsY1() const;
+    const std::vector<double> &getSegmentsX2() const;
+    const std::vector<double> &getSegmentsY2() const;
+    // Get the number of packed points and segments
+    size_t numPoints() const;
+    size_t numSegments() const;
+    // Remove all the packed data
+    void clear();
+
+private:
+    std::vector<double> pointsX;
+    // Left (1) and right (2) endpoints of the segments
+    std::vector<double> segmentsX1, segmentsY1, segmentsX2, segmentsY2;
+};
+
+#endif // PACKED_GEOMETRY_H
@@ -0,0 +1,148 @@
+#include "packed_trapezoids.h"
+#include <limits>
+
+/**
+ * @brief empty constructor
+ */
+PackedTrapezoids::PackedTrapezoids() : trapezoids(0){}
+
+/**
+ * @brief Pack the trapezoids of a map, replacing the previous data
+ * @param[in] trapezoidalMap the trapezoidal map
+ */
+void PackedTrapezoids::build(const TrapezoidalMap &trapezoidalMap){
+    clear();
+    trapezoids = trapezoidalMap.numTrapezoids();
+    size_t padded = (trapezoids + PACKED_TRAPEZOIDS_BLOCK - 1) / PACKED_TRAPEZOIDS_BLOCK * PACKED_TRAPEZOIDS_BLOCK;
+
+    // The padding trapezoids start at +infinity, so they contain no point
+    leftX.assign(padded, std::numeric_limits<double>::infinity());
+    rightX.assign(padded, std::numeric_limits<double>::infinity());
+    topX1.assign(padded, 0);
+    topY1.assign(padded, 0);
+    topX2.assign(padded, 0);
+    topY2.assign(padded, 0);
+    bottomX1.assign(padded, 0);
+    bottomY1.assign(padded, 0);
+    bottomX2.assign(padded, 0);
+    bottomY2.assign(padded, 0);
+
+    for(size_t i = 0; i < trapezoids; i++){
+        const Trapezoid &trapezoid = trapezoidalMap.getTrapezoid(i);
+        leftX[i] = trapezoid.getLeftPoint().x();
+        rightX[i] = trapezoid.getRightPoint().x();
+        topX1[i] = trapezoid.getTopSegment().p1().x();
+        topY1[i] = trapezoid.getTopSegment().p1().y();
+        topX2[i] = trapezoid.getTopSegment().p2().x();
+        topY2[i] = trapezoid.getTopSegment().p2().y();
+        bottomX1[i] = trapezoid.getBottomSegment().p1().x();
+        bottomY1[i] = trapezoid.getBottomSegment().p1().y();
+        bottomX2[i] = trapezoid.getBottomSegment().p2().x();
+        bottomY2[i] = trapezoid.getBottomSegment().p2().y();
+    }
+}
+
+/**
+ * @brief Get the x coordinates of the left points
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getLeftX() const{
+    return leftX;
+}
+
+/**
+ * @brief Get the x coordinates of the right points
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getRightX() const{
+    return rightX;
+}
+
+/**
+ * @brief Get the x coordinates of the left endpoints of the top edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getTopX1() const{
+    return topX1;
+}
+
+/**
+ * @brief Get the y coordinates of the left endpoints of the top edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getTopY1() const{
+    return topY1;
+}
+
+/**
+ * @brief Get the x coordinates of the right endpoints of the top edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getTopX2() const{
+    return topX2;
+}
+
+/**
+ * @brief Get the y coordinates of the right endpoints of the top edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getTopY2() const{
+    return topY2;
+}
+
+/**
+ * @brief Get the x coordinates of the left endpoints of the bottom edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getBottomX1() const{
+    return bottomX1;
+}
+
+/**
+ * @brief Get the y coordinates of the left endpoints of the bottom edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getBottomY1() const{
+    return bottomY1;
+}
+
+/**
+ * @brief Get the x coordinates of the right endpoints of the bottom edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getBottomX2() const{
+    return bottomX2;
+}
+
+/**
+ * @brief Get the y coordinates of the right endpoints of the bottom edges
+ * @return the vector of the coordinates
+ */
+const std::vector<double> &PackedTrapezoids::getBottomY2() const{
+    return bottomY2;
+}
+
+/**
+ * @brief Get the number of packed trapezoids
+ * @return the number of trapezoids (without the padding)
+ */
+size_t PackedTrapezoids::numTrapezoids() const{
+    return trapezoids;
+}
+
+/**
+ * @brief Remove all the packed data
+ */
+void PackedTrapezoids::clear(){
+    leftX.clear();
+    rightX.clear();
+    topX1.clear();
+    topY1.clear();
+    topX2.clear();
+    topY2.clear();
+    bottomX1.clear();
+    bottomY1.clear();
+    bottomX2.clear();
+    bottomY2.clear();
+    trapezoids = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef PACKED_TRAPEZOIDS_H
+#define PACKED_TRAPEZOIDS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "data_structures/trapezoidalmap.h"
+
+// Number of trapezoids tested together by the vectorized scan
+#define PACKED_TRAPEZOIDS_BLOCK 4
+
+/**
+ * @brief This class stores the geometry of the trapezoids of a map in flat arrays (structure of arrays), as needed by the linear scan of small maps.
+ * For every trapezoid it stores the x of its left and right points and the endpoints (ordered by x) of its top and bottom edges.
+ * The arrays are padded to a multiple of PACKED_TRAPEZOIDS_BLOCK with empty trapezoids that never contain a point.
+ */
+class PackedTrapezoids{
+
+public:
+    // Constructor
+    PackedTrapezoids();
+    // Pack the trapezoids of a map
+    void build(const TrapezoidalMap &trapezoidalMap);
+    // Get the arrays
+    const std::vector<double> &getLeftX() const;
+    const std::vector<double> &getRightX() const;
+    const std::vector<double> &getTopX1() const;
+    const std::vector<double> &getTopY1() const;
+    const std::vector<double> &getTopX2() const;
+    const std::vector<double> &getTopY2() const;
+    const std::vector<double> &getBottomX1() const;
+    const std::vector<double> &getBottomY1() const;
+    const std::vector<double> &getBottomX2() const;
+    const std::vector<double> &getBottomY2() const;
+    // Get the number of packed trapezoids (without the padding)
+    size_t numTrapezoids() const;
+    // Remove all the packed data
+    void clear();
+
+private:
+    std::vector<double> leftX, rightX;
+    // Left (1) and right (2) endpoints of the top and bottom edges
+    std::vector<double> topX1, topY1, topX2, topY2;
+    std::vector<double> bottomX1, bottomY1, bottomX2, bottomY2;
+    size_t trapezoids;
+};
+
+#endif // PACKED_TRAPEZOIDS_H
@@ -0,0 +1,147 @@
+#ifndef QUANTIZED_GEOMETRY_H
+#define QUANTIZED_GEOMETRY_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_structures/trapezoidalmap_dataset.h"
+
+/**
+ * @brief Integer type wide enough for the cross products of a coordinate type, and the largest coordinate for which they cannot overflow
+ * With |coordinate| <= maxCoordinate the differences fit in 1 + log2(maxCoordinate) + 1 bits and the difference of two products
+ * fits in the wide type.
+ */
+template<class T> struct QuantizedTraits;
+
+template<> struct QuantizedTraits<int32_t>{
+    typedef int64_t Wide;
+    static constexpr double maxCoordinate = 1073741824.0; // 2^30
+};
+
+#if defined(__SIZEOF_INT128__)
+template<> struct QuantizedTraits<int64_t>{
+    typedef __int128 Wide;
+    static constexpr double maxCoordinate = 4611686018427387904.0; // 2^62
+};
+#endif
+
+/**
+ * @brief This class stores a copy of the geometry of the dataset with integer (fixed point) coordinates, for the queries.
+ * The coordinates are multiplied by a scale and rounded (for example scale 100 for metres quantized to centimetres), so the
+ * orientation tests of the y-nodes are exact integer cross products on compact arrays (a point takes 8 bytes with int32).
+ * Only the queries are quantized: the dataset, the map and the Dag keep the double coordinates and are built with them, so the copy
+ * adds memory next to the dataset instead of replacing it (2 coordinates per point and 4 per segment).
+ * The answers are the same of the Dag on the dataset when the coordinates are multiples of 1/scale. The indexes are the same of the dataset.
+ */
+template<class T>
+class QuantizedGeometry{
+
+public:
+    typedef typename QuantizedTraits<T>::Wide Wide;
+
+    // Constructor
+    QuantizedGeometry() : scale(1){}
+
+    /**
+     * @brief Quantize the points and the segments of a dataset, replacing the previous data
+     * @param[in] trapezoidalMapData the trapezoidal map dataset
+     * @param[in] scale the factor applied to the coordinates before rounding them
+     * @return false if a coordinate is too large for the type (the geometry is left empty)
+     */
+    bool build(const TrapezoidalMapDataset &trapezoidalMapData, double scale){
+        clear();
+        this->scale = scale;
+        const std::vector<cg3::Point2d> &points = trapezoidalMapData.getPoints();
+        for(const cg3::Point2d &point : points){
+            if(!representable(point.x()) || !representable(point.y())){
+                clear();
+                return false;
+            }
+        }
+
+        pointsX.reserve(points.size());
+        pointsY.reserve(points.size());
+        for(const cg3::Point2d &point : points){
+            pointsX.push_back(quantize(point.x()));
+            pointsY.push_back(quantize(point.y()));
+        }
+
+        const std::vector<TrapezoidalMapDataset::IndexedSegment2d> &segments = trapezoidalMapData.getIndexedSegments();
+        segmentsX1.reserve(segments.size());
+        segmentsY1.reserve(segments.size());
+        segmentsX2.reserve(segments.size());
+        segmentsY2.reserve(segments.size());
+        for(const TrapezoidalMapDataset::IndexedSegment2d &segment : segments){
+            // Endpoints ordered by x
+            size_t first = pointsX[segment.first] <= pointsX[segment.second] ? segment.first : segment.second;
+            size_t second = first == segment.first ? segment.second : segment.first;
+            segmentsX1.push_back(pointsX[first]);
+            segmentsY1.push_back(pointsY[first]);
+            segmentsX2.push_back(pointsX[second]);
+            segmentsY2.push_back(pointsY[second]);
+        }
+        return true;
+    }
+
+    // Check if a coordinate can be quantized without overflowing the cross products
+    bool representable(double value) const{
+        return std::fabs(std::round(value * scale)) <= QuantizedTraits<T>::maxCoordinate;
+    }
+
+    // Quantize a coordinate
+    T quantize(double value) const{
+        return static_cast<T>(std::llround(value * scale));
+    }
+
+    // Get the quantized x coordinate of a point
+    T getPointX(size_t pointIdx) const{
+        return pointsX[pointIdx];
+    }
+
+    /**
+     * @brief Exact orientation of a point with respect to a segment
+     * @param[in] segmentIdx the dataset index of the segment
+     * @param[in] qx the quantized x coordinate of the point
+     * @param[in] qy the quantized y coordinate of the point
+     * @return 1 if the point is above the segment, -1 if below, 0 if on its line
+     */
+    int orientation(size_t segmentIdx, T qx, T qy) const{
+        Wide x1 = segmentsX1[segmentIdx], y1 = segmentsY1[segmentIdx];
+        Wide cross = (Wide(segmentsX2[segmentIdx]) - x1) * (Wide(qy) - y1) - (Wide(segmentsY2[segmentIdx]) - y1) * (Wide(qx) - x1);
+        return (cross > 0) - (cross < 0);
+    }
+
+    // Get the scale of the coordinates
+    double getScale() const{
+        return scale;
+    }
+
+    // Get the number of quantized points and segments
+    size_t numPoints() const{
+        return pointsX.size();
+    }
+
+    size_t numSegments() const{
+        return segmentsX1.size();
+    }
+
+    // Remove all the quantized data
+    void clear(){
+        pointsX.clear();
+        pointsY.clear();
+        segmentsX1.clear();
+        segmentsY1.clear();
+        segmentsX2.clear();
+        segmentsY2.clear();
+    }
+
+private:
+    std::vector<T> pointsX, pointsY;
+    // Left (1) and right (2) endpoints of the segments, copied from the points so a y-node reads one segment only
+    std::vector<T> segmentsX1, segmentsY1, segmentsX2, segmentsY2;
+    double scale;
+};
+
+#endif // QUANTIZED_GEOMETRY_H
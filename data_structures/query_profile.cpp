@@ -0,0 +1,72 @@
+#include "query_profile.h"
+
+/**
+ * @brief empty constructor
+ */
+QueryProfile::QueryProfile() : queries(0){}
+
+/**
+ * @brief Record the visit of an internal node
+ * @param[in] nodeIdx the index of the node
+ * @param[in] goLeft true if the query moved to the left child of the node
+ * The counts grow with the Dag, so the profile can be kept while segments are inserted
+ */
+void QueryProfile::recordVisit(size_t nodeIdx, bool goLeft){
+    if(nodeIdx >= visits.size()){
+        visits.resize(nodeIdx + 1, 0);
+        leftVisits.resize(nodeIdx + 1, 0);
+    }
+    visits[nodeIdx]++;
+    if(goLeft) leftVisits[nodeIdx]++;
+}
+
+/**
+ * @brief Record the end of a query
+ */
+void QueryProfile::recordQuery(){
+    queries++;
+}
+
+/**
+ * @brief Get the number of visits of a node
+ * @param[in] nodeIdx the index of the node
+ * @return the number of recorded queries that visited the node
+ */
+size_t QueryProfile::getVisits(size_t nodeIdx) const{
+    return nodeIdx < visits.size() ? visits[nodeIdx] : 0;
+}
+
+/**
+ * @brief Get the number of visits of a node that moved to its left child
+ * @param[in] nodeIdx the index of the node
+ * @return the number of recorded queries that moved from the node to its left child
+ */
+size_t QueryProfile::getLeftVisits(size_t nodeIdx) const{
+    return nodeIdx < leftVisits.size() ? leftVisits[nodeIdx] : 0;
+}
+
+/**
+ * @brief Check which child of a node is the more likely
+ * @param[in] nodeIdx the index of the node
+ * @return true if the left child was taken at least as often as the right one
+ */
+bool QueryProfile::isLeftHot(size_t nodeIdx) const{
+    return 2 * getLeftVisits(nodeIdx) >= getVisits(nodeIdx);
+}
+
+/**
+ * @brief Get the number of recorded queries
+ * @return the number of queries
+ */
+size_t QueryProfile::numQueries() const{
+    return queries;
+}
+
+/**
+ * @brief Remove all the counts
+ */
+void QueryProfile::clear(){
+    visits.clear();
+    leftVisits.clear();
+    queries = 0;
+}
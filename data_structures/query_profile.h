@@ -0,0 +1,38 @@
+#ifndef QUERY_PROFILE_H
+#define QUERY_PROFILE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief This class stores the visit counts of the Dag nodes recorded while sampling the queries.
+ * For every node it counts how many queries visited it and how many of them moved to its left child,
+ * so the layout can place the hot paths contiguously, with the more likely child next to its parent.
+ */
+class QueryProfile{
+
+public:
+    // Constructor
+    QueryProfile();
+    // Record the visit of a node and the child taken
+    void recordVisit(size_t nodeIdx, bool goLeft);
+    // Record the end of a query
+    void recordQuery();
+    // Get the number of visits of a node
+    size_t getVisits(size_t nodeIdx) const;
+    // Get the number of visits of a node that moved to its left child
+    size_t getLeftVisits(size_t nodeIdx) const;
+    // Check if the left child of a node was taken at least as often as the right one
+    bool isLeftHot(size_t nodeIdx) const;
+    // Get the number of recorded queries
+    size_t numQueries() const;
+    // Remove all the counts (needed after the Dag is relaid out, since the node indexes change)
+    void clear();
+
+private:
+    // Visits and left visits of every node
+    std::vector<size_t> visits, leftVisits;
+    size_t queries;
+};
+
+#endif // QUERY_PROFILE_H
@@ -13,6 +13,10 @@ void SegmentIntersectionChecker::insert(const cg3::Segment2d& seg) {
     aabbTree.insert(seg);
 }
 
+bool SegmentIntersectionChecker::erase(const cg3::Segment2d& seg) {
+    return aabbTree.erase(seg);
+}
+
 size_t SegmentIntersectionChecker::countIntersections(const cg3::Segment2d& seg) {
     std::vector<cg3::AABBTree<2, cg3::Segment2d>::iterator> out;
     aabbTree.aabbOverlapQuery(seg, std::back_inserter(out), this->keyOverlapChecker);
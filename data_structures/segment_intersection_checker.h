@@ -15,6 +15,7 @@ public:
     SegmentIntersectionChecker();
 
     void insert(const cg3::Segment2d& seg);
+    bool erase(const cg3::Segment2d& seg);
 
     size_t countIntersections(const cg3::Segment2d& seg);
     bool checkIntersections(const cg3::Segment2d& seg);
@@ -0,0 +1,250 @@
+#include "slab_tree.h"
+#include "utils/projectUtils.h"
+#include "utils/predicates.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief empty constructor
+ */
+SlabTree::SlabTree(){}
+
+/**
+ * @brief Compare two segments crossing the same slab
+ * @param[in] segmentIdx the first segment
+ * @param[in] otherSegmentIdx the second segment
+ * @return true if the first segment is below the second one in the slabs crossed by both
+ * The left endpoint that comes later lies in the x range of the other segment, so its orientation with respect to the other
+ * segment decides (if the segments share the left endpoint, the right endpoint decides). Only exact orientation tests are used.
+ */
+bool SlabTree::isBelow(size_t segmentIdx, size_t otherSegmentIdx) const{
+    const cg3::Segment2d &s = segments[segmentIdx], &t = segments[otherSegmentIdx];
+    if(s.p1().x() >= t.p1().x()){
+        const cg3::Point2d &p = s.p1() == t.p1() ? s.p2() : s.p1();
+        return ProjectUtils::isPointBelow(t, p);
+    }
+    const cg3::Point2d &p = t.p1() == s.p1() ? t.p2() : t.p1();
+    return ProjectUtils::isPointAbove(s, p);
+}
+
+/**
+ * @brief Get the height of a subtree
+ * @param[in] nodeIdx the root of the subtree (null index for the empty tree)
+ * @return the height of the subtree
+ */
+int SlabTree::height(size_t nodeIdx) const{
+    return nodeIdx == std::numeric_limits<size_t>::max() ? 0 : nodes[nodeIdx].height;
+}
+
+/**
+ * @brief Create a tree node
+ * @param[in] segmentIdx the segment stored in the node
+ * @param[in] leftIdx the left child (segments below)
+ * @param[in] rightIdx the right child (segments above)
+ * @return the index of the new node
+ */
+size_t SlabTree::newNode(size_t segmentIdx, size_t leftIdx, size_t rightIdx){
+    TreeNode node;
+    node.segmentIdx = segmentIdx;
+    node.leftIdx = leftIdx;
+    node.rightIdx = rightIdx;
+    node.height = std::max(height(leftIdx), height(rightIdx)) + 1;
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+/**
+ * @brief Rotate a subtree to the left, copying the nodes that change
+ * @param[in] nodeIdx the root of the subtree
+ * @return the new root of the subtree
+ */
+size_t SlabTree::rotateLeft(size_t nodeIdx){
+    TreeNode node = nodes[nodeIdx], right = nodes[node.rightIdx];
+    size_t newLeft = newNode(node.segmentIdx, node.leftIdx, right.leftIdx);
+    return newNode(right.segmentIdx, newLeft, right.rightIdx);
+}
+
+/**
+ * @brief Rotate a subtree to the right, copying the nodes that change
+ * @param[in] nodeIdx the root of the subtree
+ * @return the new root of the subtree
+ */
+size_t SlabTree::rotateRight(size_t nodeIdx){
+    TreeNode node = nodes[nodeIdx], left = nodes[node.leftIdx];
+    size_t newRight = newNode(node.segmentIdx, left.rightIdx, node.rightIdx);
+    return newNode(left.segmentIdx, left.leftIdx, newRight);
+}
+
+/**
+ * @brief Create a node with the given children and restore the AVL balance
+ * @param[in] segmentIdx the segment stored in the node
+ * @param[in] leftIdx the left child
+ * @param[in] rightIdx the right child
+ * @return the root of the balanced subtree
+ */
+size_t SlabTree::balance(size_t segmentIdx, size_t leftIdx, size_t rightIdx){
+    size_t nodeIdx = newNode(segmentIdx, leftIdx, rightIdx);
+    int factor = height(leftIdx) - height(rightIdx);
+    if(factor > 1){
+        const TreeNode &left = nodes[leftIdx];
+        if(height(left.leftIdx) < height(left.rightIdx)){
+            size_t rotatedLeft = rotateLeft(leftIdx);
+            nodes[nodeIdx].leftIdx = rotatedLeft; // The node has just been created, it is not shared yet
+        }
+        return rotateRight(nodeIdx);
+    }
+    if(factor < -1){
+        const TreeNode &right = nodes[rightIdx];
+        if(height(right.rightIdx) < height(right.leftIdx)){
+            size_t rotatedRight = rotateRight(rightIdx);
+            nodes[nodeIdx].rightIdx = rotatedRight;
+        }
+        return rotateLeft(nodeIdx);
+    }
+    return nodeIdx;
+}
+
+/**
+ * @brief Insert a segment in a version, copying the path
+ * @param[in] nodeIdx the root of the version
+ * @param[in] segmentIdx the segment to insert
+ * @return the root of the new version
+ */
+size_t SlabTree::insert(size_t nodeIdx, size_t segmentIdx){
+    if(nodeIdx == std::numeric_limits<size_t>::max()){
+        return newNode(segmentIdx, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
+    }
+    TreeNode node = nodes[nodeIdx];
+    if(isBelow(segmentIdx, node.segmentIdx)){
+        size_t leftIdx = insert(node.leftIdx, segmentIdx);
+        return balance(node.segmentIdx, leftIdx, node.rightIdx);
+    }
+    size_t rightIdx = insert(node.rightIdx, segmentIdx);
+    return balance(node.segmentIdx, node.leftIdx, rightIdx);
+}
+
+/**
+ * @brief Remove the lowest segment of a subtree, copying the path
+ * @param[in] nodeIdx the root of the subtree
+ * @param[out] minSegmentIdx the removed segment
+ * @return the root of the new subtree
+ */
+size_t SlabTree::eraseMin(size_t nodeIdx, size_t &minSegmentIdx){
+    TreeNode node = nodes[nodeIdx];
+    if(node.leftIdx == std::numeric_limits<size_t>::max()){
+        minSegmentIdx = node.segmentIdx;
+        return node.rightIdx;
+    }
+    size_t leftIdx = eraseMin(node.leftIdx, minSegmentIdx);
+    return balance(node.segmentIdx, leftIdx, node.rightIdx);
+}
+
+/**
+ * @brief Remove a segment from a version, copying the path
+ * @param[in] nodeIdx the root of the version
+ * @param[in] segmentIdx the segment to remove
+ * @return the root of the new version
+ */
+size_t SlabTree::erase(size_t nodeIdx, size_t segmentIdx){
+    if(nodeIdx == std::numeric_limits<size_t>::max()) return nodeIdx;
+    TreeNode node = nodes[nodeIdx];
+    if(node.segmentIdx == segmentIdx){
+        if(node.rightIdx == std::numeric_limits<size_t>::max()) return node.leftIdx;
+        if(node.leftIdx == std::numeric_limits<size_t>::max()) return node.rightIdx;
+        size_t successorIdx;
+        size_t rightIdx = eraseMin(node.rightIdx, successorIdx);
+        return balance(successorIdx, node.leftIdx, rightIdx);
+    }
+    if(isBelow(segmentIdx, node.segmentIdx)){
+        size_t leftIdx = erase(node.leftIdx, segmentIdx);
+        return balance(node.segmentIdx, leftIdx, node.rightIdx);
+    }
+    size_t rightIdx = erase(node.rightIdx, segmentIdx);
+    return balance(node.segmentIdx, node.leftIdx, rightIdx);
+}
+
+/**
+ * @brief Build the versions of the slabs for the segments of a dataset, replacing the previous ones
+ * @param[in] trapezoidalMapData the trapezoidal map dataset
+ * Every endpoint opens a new slab: the segments ending there are removed and the segments starting there are inserted.
+ */
+void SlabTree::build(const TrapezoidalMapDataset &trapezoidalMapData){
+    clear();
+    segments = trapezoidalMapData.getSegments();
+    for(cg3::Segment2d &segment : segments){
+        ProjectUtils::orderSegment(segment);
+    }
+
+    // Events: (x, insertion) for the left endpoints, (x, removal) for the right ones
+    std::vector<std::pair<double, std::pair<bool, size_t>>> events;
+    events.reserve(2 * segments.size());
+    for(size_t segmentIdx = 0; segmentIdx < segments.size(); segmentIdx++){
+        events.push_back(std::make_pair(segments[segmentIdx].p1().x(), std::make_pair(true, segmentIdx)));
+        events.push_back(std::make_pair(segments[segmentIdx].p2().x(), std::make_pair(false, segmentIdx)));
+    }
+    // At the same x the removals (false) come before the insertions
+    std::sort(events.begin(), events.end());
+
+    size_t root = std::numeric_limits<size_t>::max();
+    for(size_t i = 0; i < events.size(); i++){
+        const std::pair<bool, size_t> &event = events[i].second;
+        root = event.first ? insert(root, event.second) : erase(root, event.second);
+        if(i + 1 == events.size() || events[i + 1].first != events[i].first){
+            slabX.push_back(events[i].first);
+            slabRoot.push_back(root);
+        }
+    }
+}
+
+/**
+ * @brief Find the segments directly above and below a point
+ * @param[in] q the query point
+ * @return the dataset index of the segment above (first) and below (second) q, null index if there is no segment
+ * A point on a segment is considered below it, and a point on the vertical line of an endpoint belongs to the slab on its right,
+ * as in the Dag.
+ */
+std::pair<size_t, size_t> SlabTree::query(const cg3::Point2d &q) const{
+    size_t above = std::numeric_limits<size_t>::max(), below = std::numeric_limits<size_t>::max();
+    size_t slab = std::upper_bound(slabX.begin(), slabX.end(), q.x()) - slabX.begin();
+    if(slab == 0) return std::make_pair(above, below);
+
+    size_t nodeIdx = slabRoot[slab - 1];
+    while(nodeIdx != std::numeric_limits<size_t>::max()){
+        const TreeNode &node = nodes[nodeIdx];
+        if(ProjectUtils::isPointAbove(segments[node.segmentIdx], q)){
+            below = node.segmentIdx;
+            nodeIdx = node.rightIdx;
+        }else{
+            above = node.segmentIdx;
+            nodeIdx = node.leftIdx;
+        }
+    }
+
+    return std::make_pair(above, below);
+}
+
+/**
+ * @brief Get the number of slabs
+ * @return the number of versions of the tree
+ */
+size_t SlabTree::numSlabs() const{
+    return slabX.size();
+}
+
+/**
+ * @brief Get the number of tree nodes
+ * @return the number of nodes of all the versions
+ */
+size_t SlabTree::numNodes() const{
+    return nodes.size();
+}
+
+/**
+ * @brief Remove all the versions
+ */
+void SlabTree::clear(){
+    slabX.clear();
+    slabRoot.clear();
+    nodes.clear();
+    segments.clear();
+}
@@ -0,0 +1,59 @@
+#ifndef SLAB_TREE_H
+#define SLAB_TREE_H
+
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/segment2.h>
+#include <utility>
+#include <vector>
+
+#include "data_structures/trapezoidalmap_dataset.h"
+
+/**
+ * @brief This class defines a persistent search tree over the x-slabs of the dataset (Sarnak-Tarjan point location).
+ * The x coordinates of the endpoints split the plane in vertical slabs; in every slab the segments crossing it are totally ordered
+ * from bottom to top. Sweeping the slabs from left to right, the ordered set changes by one insertion or deletion per endpoint,
+ * so every slab is a version of a persistent AVL tree (with path copying) sharing most of its nodes with the previous versions.
+ * A query is a binary search of the slab followed by a descent of its version, O(log n) in the worst case.
+ */
+class SlabTree{
+
+public:
+    // Constructor
+    SlabTree();
+    // Build the versions for the segments of a dataset
+    void build(const TrapezoidalMapDataset &trapezoidalMapData);
+    // Find the dataset index of the segment above (first) and below (second) a point (null index for the bounding box)
+    std::pair<size_t, size_t> query(const cg3::Point2d &q) const;
+    // Get the number of slabs (versions) and the number of tree nodes of all the versions
+    size_t numSlabs() const;
+    size_t numNodes() const;
+    // Remove all the versions
+    void clear();
+
+private:
+    // Node of the persistent tree (nodes are never modified once created, an update copies the nodes of the path)
+    struct TreeNode{
+        size_t segmentIdx;
+        size_t leftIdx, rightIdx;
+        int height;
+    };
+
+    // Left x of every slab and root of the version of the slab
+    std::vector<double> slabX;
+    std::vector<size_t> slabRoot;
+    std::vector<TreeNode> nodes;
+    // Segments of the dataset, with endpoints ordered by x
+    std::vector<cg3::Segment2d> segments;
+
+    bool isBelow(size_t segmentIdx, size_t otherSegmentIdx) const;
+    int height(size_t nodeIdx) const;
+    size_t newNode(size_t segmentIdx, size_t leftIdx, size_t rightIdx);
+    size_t rotateLeft(size_t nodeIdx);
+    size_t rotateRight(size_t nodeIdx);
+    size_t balance(size_t segmentIdx, size_t leftIdx, size_t rightIdx);
+    size_t insert(size_t nodeIdx, size_t segmentIdx);
+    size_t erase(size_t nodeIdx, size_t segmentIdx);
+    size_t eraseMin(size_t nodeIdx, size_t &minSegmentIdx);
+};
+
+#endif // SLAB_TREE_H
@@ -0,0 +1,92 @@
+#include "snapshot_publisher.h"
+#include <functional>
+#include <limits>
+#include <thread>
+
+/**
+ * @brief Constructor of a read guard
+ * @param[in] publisher the publisher of the snapshots
+ * The reader takes a free slot (starting from a slot chosen by its thread, to spread the readers) announcing the current epoch,
+ * then loads the current snapshot. If the writer did not see the slot when it checked the readers, the snapshot loaded is
+ * already the new one, so the snapshots it deletes are never taken.
+ */
+SnapshotPublisher::ReadGuard::ReadGuard(const SnapshotPublisher &publisher) : publisher(publisher){
+    const uint64_t enteredEpoch = publisher.epoch.load();
+    slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % SNAPSHOT_PUBLISHER_READER_SLOTS;
+    while(true){
+        uint64_t freeEpoch = 0;
+        if(publisher.slots[slot].epoch.compare_exchange_strong(freeEpoch, enteredEpoch)) break;
+        slot = (slot + 1) % SNAPSHOT_PUBLISHER_READER_SLOTS;
+    }
+    snapshot = publisher.current.load();
+}
+
+/**
+ * @brief Destructor of a read guard, frees the slot of the reader
+ */
+SnapshotPublisher::ReadGuard::~ReadGuard(){
+    publisher.slots[slot].epoch.store(0);
+}
+
+/**
+ * @brief Get the snapshot taken by the reader
+ * @return the snapshot, null if nothing was published yet
+ */
+const MapSnapshot *SnapshotPublisher::ReadGuard::getSnapshot() const{
+    return snapshot;
+}
+
+/**
+ * @brief Constructor
+ * The epochs start from 1, 0 marks a free reader slot
+ */
+SnapshotPublisher::SnapshotPublisher() : current(nullptr), epoch(1){
+    for(ReaderSlot &readerSlot : slots) readerSlot.epoch.store(0);
+}
+
+/**
+ * @brief Destructor, deletes the current snapshot and the replaced ones
+ */
+SnapshotPublisher::~SnapshotPublisher(){
+    for(const std::pair<uint64_t, const MapSnapshot *> &retiredSnapshot : retired) delete retiredSnapshot.second;
+    delete current.load();
+}
+
+/**
+ * @brief Publish a new snapshot
+ * @param[in] snapshot the snapshot, the publisher takes its ownership
+ * The old snapshot can be taken only by the readers that entered before the epoch is advanced, so it is retired with that epoch
+ */
+void SnapshotPublisher::publish(const MapSnapshot *snapshot){
+    const MapSnapshot *old = current.exchange(snapshot);
+    uint64_t lastEpoch = epoch.fetch_add(1);
+    if(old != nullptr) retired.push_back(std::make_pair(lastEpoch, old));
+    reclaim();
+}
+
+/**
+ * @brief Delete the replaced snapshots that no active reader can hold
+ * A snapshot retired in an epoch is deleted when every active reader entered in a later epoch
+ */
+void SnapshotPublisher::reclaim(){
+    uint64_t oldestEpoch = std::numeric_limits<uint64_t>::max();
+    for(const ReaderSlot &readerSlot : slots){
+        uint64_t readerEpoch = readerSlot.epoch.load();
+        if(readerEpoch != 0 && readerEpoch < oldestEpoch) oldestEpoch = readerEpoch;
+    }
+
+    size_t kept = 0;
+    for(size_t i = 0; i < retired.size(); i++){
+        if(retired[i].first < oldestEpoch) delete retired[i].second;
+        else retired[kept++] = retired[i];
+    }
+    retired.resize(kept);
+}
+
+/**
+ * @brief Get the number of replaced snapshots still alive
+ * @return the number of snapshots waiting for the readers that may hold them
+ */
+size_t SnapshotPublisher::numRetired() const{
+    return retired.size();
+}
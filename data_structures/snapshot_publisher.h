@@ -0,0 +1,70 @@
+#ifndef SNAPSHOT_PUBLISHER_H
+#define SNAPSHOT_PUBLISHER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "data_structures/map_snapshot.h"
+
+// Number of readers that can hold a snapshot at the same time (a reader waits for a free slot only beyond it)
+#define SNAPSHOT_PUBLISHER_READER_SLOTS 64
+
+/**
+ * @brief This class publishes the snapshots of the map from a writer to the readers, with epoch based reclamation.
+ * The writer publishes a new snapshot with an atomic exchange, and the readers take the current one without locks: a reader
+ * announces the epoch it entered in a slot, and the replaced snapshots are deleted only when no reader entered before their
+ * replacement is still active. Readers never wait for the writer and always see a whole version.
+ * There must be a single writer (publish and reclaim are not synchronized with each other).
+ */
+class SnapshotPublisher{
+
+public:
+    /**
+     * @brief Access of a reader to the current snapshot: the snapshot stays alive until the guard is destroyed
+     */
+    class ReadGuard{
+    public:
+        // Constructor (enters the current epoch and takes the current snapshot)
+        ReadGuard(const SnapshotPublisher &publisher);
+        // Destructor (leaves the epoch)
+        ~ReadGuard();
+        // Get the snapshot (null if nothing was published)
+        const MapSnapshot *getSnapshot() const;
+    private:
+        ReadGuard(const ReadGuard &);
+        ReadGuard &operator=(const ReadGuard &);
+        const SnapshotPublisher &publisher;
+        size_t slot;
+        const MapSnapshot *snapshot;
+    };
+
+    // Constructor
+    SnapshotPublisher();
+    // Destructor (deletes all the snapshots, no reader must be active)
+    ~SnapshotPublisher();
+    // Publish a snapshot (the publisher takes its ownership) and reclaim the old ones no reader can see
+    void publish(const MapSnapshot *snapshot);
+    // Delete the replaced snapshots no reader can see
+    void reclaim();
+    // Get the number of replaced snapshots not yet deleted
+    size_t numRetired() const;
+
+private:
+    SnapshotPublisher(const SnapshotPublisher &);
+    SnapshotPublisher &operator=(const SnapshotPublisher &);
+
+    // Epoch entered by a reader (0 if the slot is free), one per cache line
+    struct alignas(64) ReaderSlot{
+        std::atomic<uint64_t> epoch;
+    };
+
+    mutable ReaderSlot slots[SNAPSHOT_PUBLISHER_READER_SLOTS];
+    std::atomic<const MapSnapshot *> current;
+    std::atomic<uint64_t> epoch;
+    // Replaced snapshots, with the last epoch in which a reader could take them
+    std::vector<std::pair<uint64_t, const MapSnapshot *>> retired;
+};
+
+#endif // SNAPSHOT_PUBLISHER_H
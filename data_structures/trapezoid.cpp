@@ -1,4 +1,5 @@
 #include "trapezoid.h"
+#include <limits>
 
 /**
  * @brief Constructor
@@ -8,7 +9,8 @@
  * @param[in] rightPoint the right point of the trapezoid
 */
 Trapezoid::Trapezoid(cg3::Segment2d topSegment, cg3::Segment2d bottomSegment, cg3::Point2d leftPoint, cg3::Point2d rightPoint) :
-    topSegment(topSegment), bottomSegment(bottomSegment), leftPoint(leftPoint), rightPoint(rightPoint)
+    topSegment(topSegment), bottomSegment(bottomSegment), leftPoint(leftPoint), rightPoint(rightPoint),
+    topSegmentIdx(std::numeric_limits<size_t>::max()), bottomSegmentIdx(std::numeric_limits<size_t>::max())
 {
 
 }
@@ -30,7 +32,7 @@ Trapezoid::Trapezoid(cg3::Segment2d topSegment, cg3::Segment2d bottomSegment, cg
                      size_t nodeIdx) :
     topSegment(topSegment), bottomSegment(bottomSegment), leftPoint(leftPoint), rightPoint(rightPoint),
     upperLeftNeighbor(upperLeftNeighbor), lowerLeftNeighbor(lowerLeftNeighbor), upperRightNeighbor(upperRightNeighbor), lowerRightNeighbor(lowerRightNeighbor),
-    nodeIdx(nodeIdx)
+    nodeIdx(nodeIdx), topSegmentIdx(std::numeric_limits<size_t>::max()), bottomSegmentIdx(std::numeric_limits<size_t>::max())
 {
 
 }
@@ -179,6 +181,38 @@ size_t Trapezoid::getNodeIdx() const{
     return nodeIdx;
 }
 
+/**
+ * @brief Set the dataset index of the top edge of the trapezoid
+ * @param[in] idx the index of the top segment in the dataset (null index for the bounding box edge)
+*/
+void Trapezoid::setTopSegmentIdx(size_t idx){
+    topSegmentIdx = idx;
+}
+
+/**
+ * @brief Get the dataset index of the top edge of the trapezoid
+ * @return the index of the top segment in the dataset (null index for the bounding box edge)
+*/
+size_t Trapezoid::getTopSegmentIdx() const{
+    return topSegmentIdx;
+}
+
+/**
+ * @brief Set the dataset index of the bottom edge of the trapezoid
+ * @param[in] idx the index of the bottom segment in the dataset (null index for the bounding box edge)
+*/
+void Trapezoid::setBottomSegmentIdx(size_t idx){
+    bottomSegmentIdx = idx;
+}
+
+/**
+ * @brief Get the dataset index of the bottom edge of the trapezoid
+ * @return the index of the bottom segment in the dataset (null index for the bounding box edge)
+*/
+size_t Trapezoid::getBottomSegmentIdx() const{
+    return bottomSegmentIdx;
+}
+
 /**
  * @brief Return the corners of the trapezoid (in clockwise order)
  * @return a vector containing the corners of the trapezoid in clockwise order
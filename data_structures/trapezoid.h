@@ -8,7 +8,7 @@
 /**
  * @brief This class define the Trapezoid data structure.
  * It stores the top and the bottom edge of the trapezoid, and the left and the right point.
- * Also stores the index of adjacent trapezoids, the index of the Dag leaf that represent itself.
+ * Also stores the index of adjacent trapezoids, the index of the Dag leaf that represent itself and the dataset indexes of its top and bottom edges.
  * Is possible to get and set its top and bototm edges, its left and right points, and all its neighbors.
  * Provide a function that compute the corner of the trapezoid (useless to draw the trapezoid)
  */
@@ -38,6 +38,11 @@ public:
     size_t getUpperRightNeighbor() const;
     void setLowerRightNeighbor(size_t idx);
     size_t getLowerRightNeighbor() const;
+    // Getters and setters for the dataset indexes of the top and bottom edges (null index for the bounding box edges)
+    void setTopSegmentIdx(size_t idx);
+    size_t getTopSegmentIdx() const;
+    void setBottomSegmentIdx(size_t idx);
+    size_t getBottomSegmentIdx() const;
     // Set the index of the dag representing the trapezoid
     void setNodeIdx(size_t idx);
     // Get the index of the dag representing the trapezoid
@@ -53,6 +58,7 @@ private:
     // Storing adjacent trapezoid with their indexes
     size_t upperLeftNeighbor, lowerLeftNeighbor, upperRightNeighbor, lowerRightNeighbor;
     size_t nodeIdx; // Link to node of dag storing its idx
+    size_t topSegmentIdx, bottomSegmentIdx; // Indexes of the top and bottom edges in the dataset
 
 };
 
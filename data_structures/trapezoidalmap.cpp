@@ -9,6 +9,11 @@ TrapezoidalMap::TrapezoidalMap(cg3::Point2d upperLeftPointBB, cg3::Point2d lower
 
 }
 
+/**
+ * @brief Destructor
+*/
+TrapezoidalMap::~TrapezoidalMap(){}
+
 /**
  * @brief Add a trapezoid in the trapezoidal map
  * @param[in] trapezoid the trapezoid to be inserted
@@ -17,11 +22,20 @@ void TrapezoidalMap::addTrapezoid(Trapezoid &trapezoid){
     trapezoids.push_back(trapezoid);
 }
 
+/**
+ * @brief Reserve the storage of the trapezoids
+ * @param[in] numTrapezoids the number of trapezoids expected
+ * The chunks of the trapezoids never move, they are allocated here with the chunk table
+*/
+void TrapezoidalMap::reserve(size_t numTrapezoids){
+    trapezoids.reserve(numTrapezoids);
+}
+
 /**
  * @brief Get the trapezoids stored in the trapezoidal map
- * @return the vector storing all the trapezoids
+ * @return the chunked vector storing all the trapezoids
 */
-const std::vector<Trapezoid> &TrapezoidalMap::getTrapezoids() const{
+const ChunkedVector<Trapezoid> &TrapezoidalMap::getTrapezoids() const{
     return trapezoids;
 }
 
@@ -34,7 +48,7 @@ const Trapezoid &TrapezoidalMap::getTrapezoid(size_t index) const{
     return trapezoids[index];
 }
 Trapezoid &TrapezoidalMap::getTrapezoid(size_t index){
-    return trapezoids[index];
+    return trapezoids.getMutable(index);
 }
 
 /**
@@ -46,7 +60,7 @@ Trapezoid &TrapezoidalMap::getTrapezoid(size_t index){
 bool TrapezoidalMap::replaceTrapezoid(Trapezoid &trapezoid, size_t idx){
     if(idx >= trapezoids.size()) return false;
 
-    trapezoids[idx] = trapezoid;
+    trapezoids.getMutable(idx) = trapezoid;
     return true;
 }
 
@@ -66,6 +80,14 @@ size_t TrapezoidalMap::numTrapezoids() const{
     return trapezoids.size();
 }
 
+/**
+ * @brief Remove the last trapezoids
+ * @param[in] numTrapezoids the number of trapezoids to keep
+*/
+void TrapezoidalMap::truncate(size_t numTrapezoids){
+    trapezoids.truncate(numTrapezoids);
+}
+
 /**
  * @brief Remove all the stored trapezoids
 */
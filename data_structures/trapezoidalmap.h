@@ -2,7 +2,7 @@
 #define TRAPEZOIDALMAP_H
 
 #include "trapezoid.h"
-#include <vector>
+#include "chunked_vector.h"
 
 #include <cg3/geometry/bounding_box2.h>
 
@@ -10,16 +10,20 @@
  * @brief This class defines the Trapezoidal Map data structure.
  * It stores all the trapezoids in a vector, is possible to add a trapezoid, replace an existing trapezoid, get the vector of the trapezoids, get a trapezoid by its index and get the number of
  * trapezoids stored in the trapezoidalmap. Store also a bounding box needed for the drawable version of the trapezoidal map
+ * The trapezoids are stored in a chunked vector, so a copy of the map shares the trapezoids with the original one until they are modified.
  */
 class TrapezoidalMap{
 
 public:
     // Constructor
     TrapezoidalMap(cg3::Point2d upperLeftPointBB, cg3::Point2d lowerRightPointBB);
-    // Add a trapezoid to the vector
-    void addTrapezoid(Trapezoid &trapezoid);
+    virtual ~TrapezoidalMap();
+    // Add a trapezoid to the vector (the drawable map adds also its color)
+    virtual void addTrapezoid(Trapezoid &trapezoid);
+    // Reserve the storage for a number of trapezoids
+    virtual void reserve(size_t numTrapezoids);
     // Get all stored trapezoids
-    const std::vector<Trapezoid> &getTrapezoids() const;
+    const ChunkedVector<Trapezoid> &getTrapezoids() const;
     // Get a stored trapezoid by its index
     const Trapezoid &getTrapezoid(size_t idx) const;
     Trapezoid &getTrapezoid(size_t idx);
@@ -29,10 +33,12 @@ public:
     bool replaceTrapezoid(Trapezoid &trapezoid, size_t idx);
     // Get the bounding box of the trapezoidal map
     const cg3::BoundingBox2 &getBoundingBox() const;
+    // Remove the trapezoids after the first numTrapezoids ones
+    virtual void truncate(size_t numTrapezoids);
     // Remove all the stored trapezoids
-    void clear();
+    virtual void clear();
 private:
-    std::vector<Trapezoid> trapezoids; // Vector of all trapezoids
+    ChunkedVector<Trapezoid> trapezoids; // Vector of all trapezoids
     cg3::BoundingBox2 boundingBox;  //  Bounding box
 };
 
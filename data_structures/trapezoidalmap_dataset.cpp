@@ -26,6 +26,7 @@ size_t TrapezoidalMapDataset::addPoint(const cg3::Point2d& point, bool& pointIns
 
         //Add point
         points.push_back(point);
+        pointSegments.push_back(0);
 
         pointMap.insert(std::make_pair(point, id));
         xCoordSet.insert(point.x());
@@ -102,6 +103,8 @@ size_t TrapezoidalMapDataset::addSegment(const cg3::Segment2d& segment, bool& se
                 }
 
                 indexedSegments.push_back(indexedSegment);
+                pointSegments[indexedSegment.first]++;
+                pointSegments[indexedSegment.second]++;
 
                 segmentMap.insert(std::make_pair(indexedSegment, id));
 
@@ -140,6 +143,8 @@ size_t TrapezoidalMapDataset::addIndexedSegment(const IndexedSegment2d& indexedS
             id = indexedSegments.size();
 
             indexedSegments.push_back(orderedIndexedSegment);
+            pointSegments[orderedIndexedSegment.first]++;
+            pointSegments[orderedIndexedSegment.second]++;
 
             segmentMap.insert(std::make_pair(orderedIndexedSegment, id));
 
@@ -150,6 +155,60 @@ size_t TrapezoidalMapDataset::addIndexedSegment(const IndexedSegment2d& indexedS
     return id;
 }
 
+//Remove the last added segment and the endpoints added with it (the last points, if no other segment uses them),
+//so the dataset is as before the segment was added. Return false if there is no segment
+bool TrapezoidalMapDataset::removeLastSegment()
+{
+    if (indexedSegments.empty())
+        return false;
+
+    IndexedSegment2d indexedSegment = indexedSegments.back();
+    cg3::Segment2d segment = getSegment(indexedSegments.size() - 1);
+
+    indexedSegments.pop_back();
+    segmentMap.erase(indexedSegment);
+    pointSegments[indexedSegment.first]--;
+    pointSegments[indexedSegment.second]--;
+
+    //The checker stores the segment as it was added (ordered by point, or by index)
+    if (!intersectionChecker.erase(segment)) {
+        bool erased = intersectionChecker.erase(cg3::Segment2d(segment.p2(), segment.p1()));
+        assert(erased);
+        (void) erased;
+    }
+
+    //Remove the endpoints added with the segment (the second one has the larger index)
+    bool boundingBoxPoint = false;
+    while (!points.empty() && pointSegments.back() == 0 &&
+           (points.size() - 1 == indexedSegment.second || points.size() - 1 == indexedSegment.first)) {
+        const cg3::Point2d& point = points.back();
+        if (point.x() == boundingBox.min().x() || point.y() == boundingBox.min().y() ||
+                point.x() == boundingBox.max().x() || point.y() == boundingBox.max().y()) {
+            boundingBoxPoint = true;
+        }
+        pointMap.erase(point);
+        xCoordSet.erase(point.x());
+        points.pop_back();
+        pointSegments.pop_back();
+    }
+
+    //Update bounding box
+    if (boundingBoxPoint) {
+        boundingBox.setMin(cg3::Point2d(0,0));
+        boundingBox.setMax(cg3::Point2d(0,0));
+        for (const cg3::Point2d& point : points) {
+            boundingBox.setMax(cg3::Point2d(
+                    std::max(point.x(), boundingBox.max().x()),
+                    std::max(point.y(), boundingBox.max().y())));
+            boundingBox.setMin(cg3::Point2d(
+                    std::min(point.x(), boundingBox.min().x()),
+                    std::min(point.y(), boundingBox.min().y())));
+        }
+    }
+
+    return true;
+}
+
 size_t TrapezoidalMapDataset::findPoint(const cg3::Point2d &point, bool &found)
 {
     std::unordered_map<cg3::Point2d, size_t>::iterator it = pointMap.find(point);
@@ -273,6 +332,7 @@ const cg3::BoundingBox2& TrapezoidalMapDataset::getBoundingBox() const
 void TrapezoidalMapDataset::clear()
 {
     points.clear();
+    pointSegments.clear();
     indexedSegments.clear();
     pointMap.clear();
     segmentMap.clear();
@@ -28,6 +28,8 @@ public:
     size_t addSegment(const cg3::Segment2d& segment, bool& segmentInserted);
     size_t addIndexedSegment(const IndexedSegment2d& segment, bool& segmentInserted);
 
+    bool removeLastSegment();
+
     size_t findPoint(const cg3::Point2d& point, bool& found);
     size_t findSegment(const cg3::Segment2d& segment, bool& found);
     size_t findIndexedSegment(const IndexedSegment2d& indexedSegment, bool& found);
@@ -53,6 +55,7 @@ public:
 private:
 
     std::vector<cg3::Point2d> points;
+    std::vector<size_t> pointSegments; //Number of segments with each point as endpoint
     std::vector<IndexedSegment2d> indexedSegments;
 
     std::unordered_map<cg3::Point2d, size_t> pointMap;
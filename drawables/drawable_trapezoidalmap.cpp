@@ -73,6 +73,15 @@ void DrawableTrapezoidalMap::addTrapezoid(Trapezoid &trapezoid){
     TrapezoidalMap::addTrapezoid(trapezoid);
 }
 
+/**
+ * @brief Reserve the storage of the trapezoids and of their colors
+ * @param[in] numTrapezoids the number of trapezoids expected
+*/
+void DrawableTrapezoidalMap::reserve(size_t numTrapezoids){
+    colors.reserve(numTrapezoids);
+    TrapezoidalMap::reserve(numTrapezoids);
+}
+
 /**
  * @brief Set the index of the highlighted trapezoid
  * @param[in] idx the index of the trapezoid
@@ -81,6 +90,16 @@ void DrawableTrapezoidalMap::setHighlightedTrap(size_t idx){
     highlightedTrap = idx;
 }
 
+/**
+ * @brief Delete the last trapezoids stored in the trapezoidal map and their colors, reset the highlighted trapezoid if it is deleted
+ * @param[in] numTrapezoids the number of trapezoids to keep
+*/
+void DrawableTrapezoidalMap::truncate(size_t numTrapezoids){
+    if(highlightedTrap >= numTrapezoids) highlightedTrap = std::numeric_limits<size_t>::max();
+    if(colors.size() > numTrapezoids) colors.erase(colors.begin() + numTrapezoids, colors.end());
+    TrapezoidalMap::truncate(numTrapezoids);
+}
+
 /**
  * @brief Delete all trapezoids stored in the trapezoidal map and all colors, reset also the color of the highlighted trapezoid
 */
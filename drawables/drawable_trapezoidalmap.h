@@ -19,15 +19,19 @@ public:
     // Constructor
     DrawableTrapezoidalMap(cg3::Point2d upperLeftPointBB, cg3::Point2d lowerRightPointBB);
 
-    void draw() const;
-    cg3::Point3d sceneCenter() const;
-    double sceneRadius() const;
+    void draw() const override;
+    cg3::Point3d sceneCenter() const override;
+    double sceneRadius() const override;
     // Add trapezoid adapted for adding also a color when a trapezoid is added
-    void addTrapezoid(Trapezoid &trapezoid);
+    void addTrapezoid(Trapezoid &trapezoid) override;
+    // Reserve adapted for reserving also the colors
+    void reserve(size_t numTrapezoids) override;
     // Set the index of the trapezoid to highlight
     void setHighlightedTrap(size_t idx);
+    // Delete the last trapezoids and their colors
+    void truncate(size_t numTrapezoids) override;
     // Delete all trapezoids and all colors stored
-    void clear();
+    void clear() override;
 private:
     std::vector<cg3::Color> colors;
     size_t highlightedTrap;
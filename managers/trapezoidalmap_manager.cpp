@@ -206,7 +206,8 @@ void TrapezoidalMapManager::addSegmentToTrapezoidalMap(const cg3::Segment2d& seg
     //structures, you could save directly the point (Point2d) in each trapezoid (it is fine).
 
 
-    algorithms::buildTrapezoidalMap(segment, dag, drawableTrapezoidalMap, drawableTrapezoidalMapDataset);
+    drawableTrapezoidalMap.setHighlightedTrap(std::numeric_limits<size_t>::max()); // Setting no one highlighted trapezoid
+    algorithms::buildTrapezoidalMap(segment, dag, drawableTrapezoidalMap, drawableTrapezoidalMapDataset, buildContext);
 
 
     //#####################################################################
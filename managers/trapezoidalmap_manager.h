@@ -14,6 +14,7 @@
 
 #include "data_structures/dag.h"
 #include "drawables/drawable_trapezoidalmap.h"
+#include "algorithms/algorithms.h"
 
 namespace Ui {
     class TrapezoidalMapManager;
@@ -61,6 +62,7 @@ private:
     //Declare your attributes here
     Dag dag;
     DrawableTrapezoidalMap drawableTrapezoidalMap;
+    algorithms::BuildContext buildContext; // Scratch buffers reused by the insertions
 
 
 
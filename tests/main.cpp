@@ -0,0 +1,46 @@
+#include "tests.h"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Run the tests (all of them, or the ones whose name contains the first argument)
+ * @return 0 if all the checks passed, 1 otherwise
+ */
+int main(int argc, char *argv[]){
+    struct Test{
+        const char *name;
+        void (*run)();
+    };
+    const Test allTests[] = {
+        {"balanced_dag", tests::testBalancedDag},
+        {"batch_location", tests::testBatchLocation},
+        {"build_allocations", tests::testBuildAllocations},
+        {"chunked_vector", tests::testChunkedVector},
+        {"dag_layout", tests::testDagLayout},
+        {"insertion_journal", tests::testInsertionJournal},
+        {"insertion_log", tests::testInsertionLog},
+        {"interleaved_location", tests::testInterleavedLocation},
+        {"live_map", tests::testLiveMap},
+        {"map_clone", tests::testMapClone},
+        {"parallel_build", tests::testParallelBuild},
+        {"parallel_insertion", tests::testParallelInsertion},
+        {"point_locator", tests::testPointLocator},
+        {"predicates", tests::testPredicates},
+        {"quantized_location", tests::testQuantizedLocation},
+        {"query_above_below", tests::testQueryAboveBelow},
+        {"segment_crossing", tests::testSegmentCrossing},
+        {"simd_location", tests::testSimdLocation},
+        {"small_map_scan", tests::testSmallMapScan},
+        {"stab_vertical", tests::testStabVertical},
+        {"versioned_map", tests::testVersionedMap},
+        {"window_query", tests::testWindowQuery},
+    };
+
+    for(const Test &test : allTests){
+        if(argc > 1 && std::strstr(test.name, argv[1]) == nullptr) continue;
+        size_t failuresBefore = tests::numFailures();
+        test.run();
+        std::printf("%-24s %s\n", test.name, tests::numFailures() == failuresBefore ? "passed" : "FAILED");
+    }
+    return tests::numFailures() == 0 ? 0 : 1;
+}
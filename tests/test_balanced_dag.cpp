@@ -0,0 +1,77 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cmath>
+#include "algorithms/algorithms.h"
+#include "algorithms/balanced_dag.h"
+
+namespace{
+    /**
+     * @brief Get random points, the endpoints and the midpoints of the segments of a map
+     */
+    std::vector<cg3::Point2d> queryPointsOf(const tests::TestMap &map, unsigned seed){
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(5000, seed);
+        queryPoints.insert(queryPoints.end(), map.dataset.getPoints().begin(), map.dataset.getPoints().end());
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+        return queryPoints;
+    }
+
+    /**
+     * @brief Rebuild the Dag of a map built with the first half of the segments and check it: the queries find the same trapezoids,
+     * and the other half of the segments can be inserted incrementally, giving the answers of a build without rebuild
+     */
+    void checkBalanced(const std::vector<cg3::Segment2d> &segments, unsigned seed){
+        size_t half = segments.size() / 2;
+        tests::TestMap map;
+        map.insert(std::vector<cg3::Segment2d>(segments.begin(), segments.begin() + half));
+        std::vector<cg3::Point2d> queryPoints = queryPointsOf(map, seed);
+        std::vector<size_t> before;
+        for(const cg3::Point2d &q : queryPoints) before.push_back(algorithms::queryPoint(q, map.dag, map.dataset));
+
+        algorithms::buildBalancedDag(map.dag, map.trapezoidalMap, map.dataset);
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size(); i++){
+            if(algorithms::queryPoint(queryPoints[i], map.dag, map.dataset) != before[i]) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+
+        map.insert(std::vector<cg3::Segment2d>(segments.begin() + half, segments.end()));
+        tests::TestMap fresh;
+        fresh.insert(segments);
+        queryPoints = queryPointsOf(fresh, seed);
+        TEST_CHECK(algorithms::queryAboveBelow(queryPoints, map.dag, map.trapezoidalMap, map.dataset) ==
+                   algorithms::queryAboveBelow(queryPoints, fresh.dag, fresh.trapezoidalMap, fresh.dataset));
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Balanced Dag: same answers as the incremental Dag, incremental insertions after the rebuild, and a logarithmic depth on the
+ * worst case of the incremental Dag (segments inserted from left to right, every one in the last trapezoid)
+ */
+void testBalancedDag(){
+    for(unsigned seed = 1; seed <= 3; seed++){
+        checkBalanced(seed < 3 ? randomSegments(300, 30, seed) : gridSegments(5000, seed), seed);
+    }
+
+    std::vector<cg3::Segment2d> sortedSegments;
+    const size_t numSorted = 2000;
+    double step = 1.8 * TEST_BOUNDINGBOX / numSorted;
+    for(size_t i = 0; i < numSorted; i++){
+        double x = -0.9 * TEST_BOUNDINGBOX + i * step;
+        sortedSegments.push_back(cg3::Segment2d(cg3::Point2d(x, (i % 7) * 1000.0), cg3::Point2d(x + 0.5 * step, (i % 5) * 1000.0)));
+    }
+    TestMap sortedMap;
+    sortedMap.insert(sortedSegments);
+    size_t incrementalDepth = algorithms::dagDepth(sortedMap.dag);
+    algorithms::buildBalancedDag(sortedMap.dag, sortedMap.trapezoidalMap, sortedMap.dataset);
+    size_t balancedDepth = algorithms::dagDepth(sortedMap.dag);
+    double logTrapezoids = std::log2(static_cast<double>(sortedMap.trapezoidalMap.numTrapezoids()));
+    TEST_CHECK(incrementalDepth >= numSorted);
+    TEST_CHECK(balancedDepth <= 2 * logTrapezoids);
+    checkBalanced(sortedSegments, 4);
+}
+
+}
@@ -0,0 +1,45 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/algorithms.h"
+#include "algorithms/batch_location.h"
+
+namespace{
+    /**
+     * @brief Check the offline sweep against queryPoint, query by query
+     */
+    void checkSweep(const tests::TestMap &map, const std::vector<cg3::Point2d> &queryPoints){
+        std::vector<size_t> swept = algorithms::locateAllSorted(queryPoints, map.trapezoidalMap);
+        TEST_CHECK(swept.size() == queryPoints.size());
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size() && i < swept.size(); i++){
+            if(swept[i] != algorithms::queryPoint(queryPoints[i], map.dag, map.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Offline sweep location against queryPoint: random points, the endpoints (on the vertical sides) and the midpoints of the
+ * segments (on the edges), on the empty map, on maps with shared endpoints and on a grid map
+ */
+void testBatchLocation(){
+    TestMap emptyMap;
+    checkSweep(emptyMap, randomPoints(10, 1));
+    checkSweep(emptyMap, std::vector<cg3::Point2d>());
+
+    for(unsigned seed = 1; seed <= 3; seed++){
+        TestMap map;
+        map.insert(seed < 3 ? randomSegments(300, 30, seed) : gridSegments(20000, seed));
+
+        std::vector<cg3::Point2d> queryPoints = randomPoints(20000, seed);
+        for(const cg3::Point2d &point : map.dataset.getPoints()) queryPoints.push_back(point);
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+        checkSweep(map, queryPoints);
+    }
+}
+
+}
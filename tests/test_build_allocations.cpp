@@ -0,0 +1,95 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cstdlib>
+#include <new>
+#include "algorithms/algorithms.h"
+
+namespace{
+    // Number of calls of operator new while counting is set
+    size_t allocations = 0;
+    bool counting = false;
+}
+
+// The global allocation functions of the test program, counting the allocations
+void *operator new(std::size_t size){
+    if(counting) allocations++;
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if(pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+
+namespace{
+    /**
+     * @brief Insert the segments of a dataset in reserved structures with a build context, counting the allocations of the insertions
+     * after the first ones (which size the scratch buffers), then of a rebuild of the cleared structures
+     * @param[in] numNodes the size of the Dag built in the same order, reserved on top of the expected size of reserveStructures
+     */
+    void checkBuildAllocations(TrapezoidalMapDataset &dataset, size_t numNodes){
+        tests::TestMap map;
+        size_t numSegments = dataset.getIndexedSegments().size();
+        algorithms::reserveStructures(numSegments, map.dag, map.trapezoidalMap);
+        map.dag.reserve(numNodes);
+        algorithms::BuildContext context;
+        context.intersectedTrapezoids.reserve(4096);
+
+        const size_t numWarmUp = 10;
+        for(size_t i = 0; i < numWarmUp && i < numSegments; i++){
+            algorithms::buildTrapezoidalMap(dataset.getSegment(i), map.dag, map.trapezoidalMap, dataset, context);
+        }
+        allocations = 0;
+        counting = true;
+        for(size_t i = numWarmUp; i < numSegments; i++){
+            algorithms::buildTrapezoidalMap(dataset.getSegment(i), map.dag, map.trapezoidalMap, dataset, context);
+        }
+        counting = false;
+        TEST_CHECK(map.dag.numNodes() == numNodes);
+        TEST_CHECK(allocations == 0);
+
+        // The cleared structures keep their chunks as spare chunks
+        map.dag.clear();
+        map.trapezoidalMap.clear();
+        algorithms::initializeStructures(map.dag, map.trapezoidalMap);
+        allocations = 0;
+        counting = true;
+        for(size_t i = 0; i < numSegments; i++){
+            algorithms::buildTrapezoidalMap(dataset.getSegment(i), map.dag, map.trapezoidalMap, dataset, context);
+        }
+        counting = false;
+        TEST_CHECK(map.dag.numNodes() == numNodes);
+        TEST_CHECK(allocations == 0);
+
+        // The insertion without a build context allocates its scratch buffers (a check of the counter)
+        tests::TestMap plain;
+        allocations = 0;
+        counting = true;
+        for(size_t i = 0; i < numSegments; i++) algorithms::buildTrapezoidalMap(dataset.getSegment(i), plain.dag, plain.trapezoidalMap, dataset);
+        counting = false;
+        TEST_CHECK(allocations > 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Insertions in reserved structures with a build context do not allocate: on segments sharing endpoints and on a map whose
+ * Dag spans many chunks
+ */
+void testBuildAllocations(){
+    for(unsigned seed = 1; seed <= 2; seed++){
+        TestMap input;
+        input.insert(seed == 1 ? randomSegments(300, 30, seed) : gridSegments(20000, seed));
+        // The expected size of reserveStructures covers these Dags, the reserve of the known size covers any order
+        TEST_CHECK(input.dag.numNodes() <= 10 * input.dataset.getIndexedSegments().size() + 1);
+        checkBuildAllocations(input.dataset, input.dag.numNodes());
+    }
+}
+
+}
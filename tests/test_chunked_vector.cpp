@@ -0,0 +1,69 @@
+#include "tests.h"
+#include <utility>
+#include "data_structures/chunked_vector.h"
+
+namespace{
+    typedef ChunkedVector<size_t> Vector;
+
+    /**
+     * @brief Fill a vector with the items 0, 1, ..., numItems - 1
+     */
+    void fill(Vector &vector, size_t numItems){
+        for(size_t i = 0; i < numItems; i++) vector.push_back(i);
+    }
+
+    /**
+     * @brief Check that a vector contains the items first, first + 1, ..., first + numItems - 1
+     */
+    bool contains(const Vector &vector, size_t first, size_t numItems){
+        if(vector.size() != numItems) return false;
+        for(size_t i = 0; i < numItems; i++){
+            if(vector[i] != first + i) return false;
+        }
+        return true;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Copy-on-write chunks of the chunked vector, and the state of a copied and of a moved vector
+ */
+void testChunkedVector(){
+    const size_t numItems = 3 * Vector::CHUNK_SIZE + 5;
+
+    // A copy shares the chunks until one of the two vectors writes them
+    Vector original;
+    fill(original, numItems);
+    Vector copy(original);
+    copy.getMutable(1) = 1000;
+    copy.push_back(numItems);
+    TEST_CHECK(contains(original, 0, numItems));
+    TEST_CHECK(copy[1] == 1000 && copy.size() == numItems + 1 && copy[numItems] == numItems);
+
+    // A moved vector is empty and can be filled again
+    Vector moved(std::move(original));
+    TEST_CHECK(contains(moved, 0, numItems));
+    TEST_CHECK(original.size() == 0 && original.empty() && original.numChunks() == 0);
+    TEST_CHECK(original.begin() == original.end());
+    fill(original, 10);
+    TEST_CHECK(contains(original, 0, 10));
+
+    Vector assigned;
+    fill(assigned, 7);
+    assigned = std::move(moved);
+    TEST_CHECK(contains(assigned, 0, numItems));
+    TEST_CHECK(moved.size() == 0 && moved.empty() && moved.numChunks() == 0);
+    fill(moved, Vector::CHUNK_SIZE + 1);
+    TEST_CHECK(contains(moved, 0, Vector::CHUNK_SIZE + 1));
+
+    // Truncate and clear of a vector that shares its chunks leave the other vector unchanged
+    Vector shared(assigned);
+    shared.truncate(Vector::CHUNK_SIZE + 3);
+    TEST_CHECK(contains(shared, 0, Vector::CHUNK_SIZE + 3));
+    shared.clear();
+    TEST_CHECK(shared.empty());
+    TEST_CHECK(contains(assigned, 0, numItems));
+}
+
+}
@@ -0,0 +1,83 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/algorithms.h"
+#include "algorithms/dag_layout.h"
+
+namespace{
+    /**
+     * @brief Check that every trapezoid points to its leaf
+     */
+    bool leavesLinked(const Dag &dag, const TrapezoidalMap &trapezoidalMap){
+        for(size_t trapezoidIdx = 0; trapezoidIdx < trapezoidalMap.numTrapezoids(); trapezoidIdx++){
+            const Node &leaf = dag.getNode(trapezoidalMap.getTrapezoid(trapezoidIdx).getNodeIdx());
+            if(leaf.getType() != Node::NodeType::LEAF || leaf.getIdx() != trapezoidIdx) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Relayout a map built with the first half of the segments and check it: the root is still the first node, the queries
+     * find the same trapezoids, the trapezoids point to their leaves, and the other half of the segments can be inserted, giving the
+     * map of a build without relayout
+     */
+    template<class Relayout>
+    void checkRelayout(const std::vector<cg3::Segment2d> &segments, unsigned seed, Relayout relayout){
+        size_t half = segments.size() / 2;
+        tests::TestMap map;
+        map.insert(std::vector<cg3::Segment2d>(segments.begin(), segments.begin() + half));
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(5000, seed);
+        queryPoints.insert(queryPoints.end(), map.dataset.getPoints().begin(), map.dataset.getPoints().end());
+        std::vector<size_t> before;
+        for(const cg3::Point2d &q : queryPoints) before.push_back(algorithms::queryPoint(q, map.dag, map.dataset));
+        Node root = map.dag.getRoot();
+        size_t numNodes = map.dag.numNodes();
+
+        relayout(map);
+        TEST_CHECK(map.dag.numNodes() == numNodes);
+        TEST_CHECK(map.dag.getRoot().getType() == root.getType() && map.dag.getRoot().getIdx() == root.getIdx());
+        TEST_CHECK(leavesLinked(map.dag, map.trapezoidalMap));
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size(); i++){
+            if(algorithms::queryPoint(queryPoints[i], map.dag, map.dataset) != before[i]) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+
+        map.insert(std::vector<cg3::Segment2d>(segments.begin() + half, segments.end()));
+        TEST_CHECK(leavesLinked(map.dag, map.trapezoidalMap));
+        tests::TestMap fresh;
+        fresh.insert(segments);
+        TEST_CHECK(map.trapezoidalMap.numTrapezoids() == fresh.trapezoidalMap.numTrapezoids());
+        mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            if(algorithms::queryPoint(q, map.dag, map.dataset) != algorithms::queryPoint(q, fresh.dag, fresh.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Relayout of the Dag in van Emde Boas order and following the hot paths of a query profile (sampled on a small region, so many
+ * nodes are never visited), on the empty map, on maps with shared endpoints and on a grid map
+ */
+void testDagLayout(){
+    std::vector<cg3::Point2d> sampledPoints = randomPoints(2000, 9);
+    for(cg3::Point2d &point : sampledPoints) point = cg3::Point2d(0.1 * point.x(), 0.1 * point.y());
+    auto vanEmdeBoas = [](TestMap &map){ algorithms::relayoutDag(map.dag, map.trapezoidalMap); };
+    auto hotPaths = [&sampledPoints](TestMap &map){
+        QueryProfile profile;
+        for(const cg3::Point2d &q : sampledPoints) algorithms::queryPoint(q, map.dag, map.dataset, profile);
+        algorithms::relayoutDag(map.dag, map.trapezoidalMap, profile);
+    };
+
+    for(unsigned seed = 1; seed <= 3; seed++){
+        std::vector<cg3::Segment2d> segments = seed < 3 ? randomSegments(300, 30, seed) : gridSegments(5000, seed);
+        checkRelayout(segments, seed, vanEmdeBoas);
+        checkRelayout(segments, seed, hotPaths);
+    }
+    checkRelayout(std::vector<cg3::Segment2d>(), 1, vanEmdeBoas);
+    checkRelayout(std::vector<cg3::Segment2d>(), 1, hotPaths);
+}
+
+}
@@ -0,0 +1,100 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <tuple>
+#include "algorithms/algorithms.h"
+#include "data_structures/insertion_journal.h"
+
+namespace{
+    typedef std::tuple<size_t, size_t, double, double, double, double> TrapezoidKey;
+
+    /**
+     * @brief Get the trapezoids of a map as sorted (top, bottom, left point, right point) tuples
+     */
+    std::vector<TrapezoidKey> trapezoidKeys(const TrapezoidalMap &trapezoidalMap){
+        std::vector<TrapezoidKey> keys;
+        for(const Trapezoid &t : trapezoidalMap.getTrapezoids()){
+            keys.push_back(TrapezoidKey(t.getTopSegmentIdx(), t.getBottomSegmentIdx(), t.getLeftPoint().x(), t.getLeftPoint().y(), t.getRightPoint().x(), t.getRightPoint().y()));
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    /**
+     * @brief Add a segment to the dataset and insert it in the structures, recording the insertion in a journal
+     * @return false if the dataset rejected the segment
+     */
+    bool insertRecorded(const cg3::Segment2d &segment, tests::TestMap &map, algorithms::BuildContext &context){
+        bool inserted;
+        map.dataset.addSegment(segment, inserted);
+        if(inserted) algorithms::buildTrapezoidalMap(segment, map.dag, map.trapezoidalMap, map.dataset, context);
+        return inserted;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Undo of the recorded insertions: the map, the Dag and the dataset are restored, so the undone segments (and the segments
+ * crossing them) can be inserted again
+ */
+void testInsertionJournal(){
+    for(unsigned seed = 1; seed <= 2; seed++){
+        std::vector<cg3::Segment2d> segments = seed == 1 ? randomSegments(300, 30, seed) : gridSegments(2000, seed);
+        size_t half = segments.size() / 2;
+        TestMap map;
+        map.insert(std::vector<cg3::Segment2d>(segments.begin(), segments.begin() + half));
+        std::vector<TrapezoidKey> keysBefore = trapezoidKeys(map.trapezoidalMap);
+        size_t numPoints = map.dataset.getPoints().size(), numSegments = map.dataset.getIndexedSegments().size();
+        size_t numNodes = map.dag.numNodes();
+
+        InsertionJournal journal(0);
+        algorithms::BuildContext context;
+        context.journal = &journal;
+        size_t numRecorded = 0;
+        for(size_t i = half; i < segments.size(); i++){
+            if(insertRecorded(segments[i], map, context)) numRecorded++;
+        }
+        TEST_CHECK(journal.numInsertions() == numRecorded);
+        while(journal.undoLastInsertion(map.dag, map.trapezoidalMap, map.dataset)){}
+        TEST_CHECK(map.dataset.getPoints().size() == numPoints);
+        TEST_CHECK(map.dataset.getIndexedSegments().size() == numSegments);
+        TEST_CHECK(map.dag.numNodes() == numNodes);
+        TEST_CHECK(trapezoidKeys(map.trapezoidalMap) == keysBefore);
+
+        // The undone segments are accepted again, and the map is the one of all the segments
+        size_t numReinserted = 0;
+        for(size_t i = half; i < segments.size(); i++){
+            if(insertRecorded(segments[i], map, context)) numReinserted++;
+        }
+        TEST_CHECK(numReinserted == numRecorded);
+        TestMap fresh;
+        fresh.insert(segments);
+        TEST_CHECK(trapezoidKeys(map.trapezoidalMap) == trapezoidKeys(fresh.trapezoidalMap));
+        std::vector<cg3::Point2d> queryPoints = randomPoints(5000, seed);
+        size_t mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            if(algorithms::queryAboveBelow(q, map.dag, map.trapezoidalMap, map.dataset) != algorithms::queryAboveBelow(q, fresh.dag, fresh.trapezoidalMap, fresh.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+
+    // A segment crossing an undone segment is accepted, the endpoints of the undone segment are removed and the shared ones are kept
+    TestMap map;
+    InsertionJournal journal;
+    algorithms::BuildContext context;
+    context.journal = &journal;
+    TEST_CHECK(insertRecorded(cg3::Segment2d(cg3::Point2d(-1000, 0), cg3::Point2d(1000, 10)), map, context));
+    TEST_CHECK(insertRecorded(cg3::Segment2d(cg3::Point2d(1000, 10), cg3::Point2d(2000, 500)), map, context));
+    TEST_CHECK(journal.undoLastInsertion(map.dag, map.trapezoidalMap, map.dataset));
+    TEST_CHECK(map.dataset.getPoints().size() == 2);
+    TEST_CHECK(journal.undoLastInsertion(map.dag, map.trapezoidalMap, map.dataset));
+    TEST_CHECK(map.dataset.getPoints().empty() && map.dataset.getIndexedSegments().empty());
+    TEST_CHECK(!journal.undoLastInsertion(map.dag, map.trapezoidalMap, map.dataset));
+    TEST_CHECK(map.trapezoidalMap.numTrapezoids() == 1 && map.dag.numNodes() == 1);
+    TEST_CHECK(insertRecorded(cg3::Segment2d(cg3::Point2d(-500, 500), cg3::Point2d(500, -500)), map, context));
+    TEST_CHECK(insertRecorded(cg3::Segment2d(cg3::Point2d(-1000, 0), cg3::Point2d(-600, 10)), map, context));
+    TEST_CHECK(map.dataset.getPoints().size() == 4);
+}
+
+}
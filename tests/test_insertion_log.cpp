@@ -0,0 +1,240 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "algorithms/algorithms.h"
+#include "algorithms/durable_map.h"
+#include "data_structures/insertion_log.h"
+
+namespace{
+    /**
+     * @brief Limit the size of the files written by the process (RLIM_INFINITY to remove the limit): the writes past the limit fail
+     */
+    void limitFileSize(rlim_t size){
+        struct rlimit limit;
+        getrlimit(RLIMIT_FSIZE, &limit);
+        limit.rlim_cur = size;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    /**
+     * @brief Get the size of a file
+     */
+    long fileSize(const std::string &filename){
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        return file ? static_cast<long>(file.tellg()) : -1;
+    }
+
+    /**
+     * @brief Make the record of the insertion of a segment, the i-th operation of the log
+     */
+    InsertionLog::Record insertionRecord(size_t i, const cg3::Segment2d &segment){
+        InsertionLog::Record record = {InsertionLog::RecordType::INSERTION, i, i, segment};
+        return record;
+    }
+
+    /**
+     * @brief Check that the records of a log are the insertions of the given segments, with their indexes
+     */
+    bool sameRecords(const std::vector<InsertionLog::Record> &records, const std::vector<cg3::Segment2d> &segments){
+        if(records.size() != segments.size()) return false;
+        for(size_t i = 0; i < records.size(); i++){
+            if(records[i].type != InsertionLog::RecordType::INSERTION || records[i].sequence != i || records[i].segmentIdx != i ||
+               records[i].segment != segments[i]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check that a durable map has the segments of a map built with the sequential insertion, and answers as it
+     */
+    bool sameMap(const DurableTrapezoidalMap &map, const tests::TestMap &expected, unsigned seed){
+        if(map.getDataset().getSegments() != expected.dataset.getSegments()) return false;
+        if(map.getTrapezoidalMap().numTrapezoids() != expected.trapezoidalMap.numTrapezoids()) return false;
+        for(const cg3::Point2d &q : tests::randomPoints(1000, seed)){
+            if(map.locate(q) != algorithms::queryAboveBelow(q, expected.dag, expected.trapezoidalMap, expected.dataset)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copy a file
+     */
+    bool copyFile(const std::string &source, const std::string &destination){
+        std::ifstream input(source, std::ios::binary);
+        std::ofstream output(destination, std::ios::binary | std::ios::trunc);
+        output << input.rdbuf();
+        return input && output;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Records of the insertion log: a closed log refuses them, a torn tail is removed, a failed sync is retried without duplicating
+ * the records written before the failure, and a durable map does not apply the insertions that cannot be logged. The undone insertions
+ * are recovered as removals, and a log already in the snapshot is skipped.
+ */
+void testInsertionLog(){
+    char directoryTemplate[] = "/tmp/insertion_log_test_XXXXXX";
+    if(mkdtemp(directoryTemplate) == nullptr){
+        TEST_CHECK(false);
+        return;
+    }
+    const std::string directory = directoryTemplate;
+    const std::string filename = directory + "/test.log";
+    const size_t numRecords = INSERTION_LOG_BATCH_RECORDS + INSERTION_LOG_BATCH_RECORDS / 2;
+    std::vector<cg3::Segment2d> segments = gridSegments(numRecords, 1);
+
+    InsertionLog log;
+    TEST_CHECK(!log.isOpen());
+    TEST_CHECK(!log.append(insertionRecord(0, segments[0])));
+    TEST_CHECK(!log.sync());
+
+    // The records are read back after the close, a torn tail is ignored and removed by the next open
+    TEST_CHECK(log.open(filename));
+    for(size_t i = 0; i < numRecords; i++) TEST_CHECK(log.append(insertionRecord(i, segments[i])));
+    log.close();
+    TEST_CHECK(!log.append(insertionRecord(numRecords, segments[0])));
+    TEST_CHECK(sameRecords(InsertionLog::readRecords(filename), segments));
+    long validSize = fileSize(filename);
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        file << "torn record";
+    }
+    TEST_CHECK(sameRecords(InsertionLog::readRecords(filename), segments));
+    TEST_CHECK(log.open(filename));
+    TEST_CHECK(fileSize(filename) == validSize);
+    TEST_CHECK(log.truncate());
+    TEST_CHECK(fileSize(filename) == 0);
+
+    // A sync that writes a part of the batch and fails is retried in the same place, and the full batch refuses the new records
+    std::signal(SIGXFSZ, SIG_IGN);
+    for(size_t i = 0; i < INSERTION_LOG_BATCH_RECORDS / 2; i++) TEST_CHECK(log.append(insertionRecord(i, segments[i])));
+    TEST_CHECK(log.sync());
+    validSize = fileSize(filename);
+    limitFileSize(static_cast<rlim_t>(validSize + 1000));
+    for(size_t i = INSERTION_LOG_BATCH_RECORDS / 2; i < numRecords; i++) TEST_CHECK(log.append(insertionRecord(i, segments[i])));
+    TEST_CHECK(fileSize(filename) == validSize + 1000);
+    TEST_CHECK(!log.append(insertionRecord(numRecords, segments[0])));
+    TEST_CHECK(!log.sync());
+    limitFileSize(RLIM_INFINITY);
+    TEST_CHECK(log.sync());
+    TEST_CHECK(sameRecords(InsertionLog::readRecords(filename), segments));
+    log.close();
+
+    // The map refuses the insertions when the full batch cannot be synced, and the refused segments can be inserted later
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        TEST_CHECK(map.isOpen());
+        TEST_CHECK(map.getDataset().getIndexedSegments().size() == 0);
+        limitFileSize(1000);
+        for(size_t i = 0; i < INSERTION_LOG_BATCH_RECORDS; i++) TEST_CHECK(map.insertSegment(segments[i]));
+        size_t numTrapezoids = map.getTrapezoidalMap().numTrapezoids(), numPoints = map.getDataset().getPoints().size();
+        TEST_CHECK(!map.insertSegment(segments[INSERTION_LOG_BATCH_RECORDS]));
+        TEST_CHECK(!map.undoLastInsertion());
+        TEST_CHECK(map.getDataset().getIndexedSegments().size() == INSERTION_LOG_BATCH_RECORDS);
+        TEST_CHECK(map.getDataset().getPoints().size() == numPoints);
+        TEST_CHECK(map.getTrapezoidalMap().numTrapezoids() == numTrapezoids);
+        TEST_CHECK(!map.saveSnapshot());
+        limitFileSize(RLIM_INFINITY);
+        for(size_t i = INSERTION_LOG_BATCH_RECORDS; i < numRecords; i++) TEST_CHECK(map.insertSegment(segments[i]));
+        TEST_CHECK(map.sync());
+    }
+    std::signal(SIGXFSZ, SIG_DFL);
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        TEST_CHECK(map.getNumReplayed() == numRecords);
+        TestMap fresh;
+        fresh.insert(segments);
+        TEST_CHECK(map.getTrapezoidalMap().numTrapezoids() == fresh.trapezoidalMap.numTrapezoids());
+    }
+
+    // Without a log the insertions are refused
+    {
+        DurableTrapezoidalMap map(directory + "/missing", 0);
+        TEST_CHECK(!map.isOpen());
+        TEST_CHECK(!map.insertSegment(segments[0]));
+        TEST_CHECK(!map.undoLastInsertion());
+        TEST_CHECK(map.getDataset().getIndexedSegments().empty());
+    }
+    std::remove((directory + "/insertions.log").c_str());
+    std::remove((directory + "/map.snapshot").c_str());
+
+    // The type of a record is covered by the checksum
+    TEST_CHECK(log.open(filename));
+    TEST_CHECK(log.truncate());
+    InsertionLog::Record removal = {InsertionLog::RecordType::REMOVAL, 1, 0, segments[0]};
+    TEST_CHECK(log.append(insertionRecord(0, segments[0])) && log.append(removal));
+    log.close();
+    std::vector<InsertionLog::Record> records = InsertionLog::readRecords(filename);
+    TEST_CHECK(records.size() == 2 && records[1].type == InsertionLog::RecordType::REMOVAL && records[1].sequence == 1);
+    {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(fileSize(filename) / 2);
+        file.put(static_cast<char>(InsertionLog::RecordType::INSERTION));
+    }
+    TEST_CHECK(InsertionLog::readRecords(filename).size() == 1);
+
+    // The undone insertions are logged as removals: the recovery undoes them again, with the journal of the replayed insertions or,
+    // for a segment of the snapshot, building the map again without it
+    std::vector<cg3::Segment2d> expected(segments.begin(), segments.begin() + 17);
+    const size_t numSegments = expected.size();
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        for(size_t i = 0; i < 20; i++) TEST_CHECK(map.insertSegment(segments[i]));
+        for(size_t i = 0; i < 3; i++) TEST_CHECK(map.undoLastInsertion());
+        TEST_CHECK(map.insertSegment(segments[20]) && map.insertSegment(segments[21]));
+        TEST_CHECK(map.undoLastInsertion());
+    }
+    expected.push_back(segments[20]);
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        TEST_CHECK(map.getNumReplayed() == 26);
+        TestMap fresh;
+        fresh.insert(expected);
+        TEST_CHECK(sameMap(map, fresh, 1));
+        TEST_CHECK(map.saveSnapshot());
+        TEST_CHECK(map.undoLastInsertion());
+    }
+    expected.pop_back();
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        TEST_CHECK(map.getNumReplayed() == 1);
+        TestMap fresh;
+        fresh.insert(expected);
+        TEST_CHECK(sameMap(map, fresh, 2));
+
+        // A crash after the snapshot and before the log is emptied: the records in the snapshot are skipped by their sequence number,
+        // even when the segment indexes of the log match the snapshot
+        TEST_CHECK(map.saveSnapshot());
+        TEST_CHECK(map.insertSegment(segments[numSegments]) && map.insertSegment(segments[numSegments + 1]));
+        TEST_CHECK(map.undoLastInsertion() && map.undoLastInsertion());
+        TEST_CHECK(map.insertSegment(segments[numSegments + 2]) && map.insertSegment(segments[numSegments + 1]));
+        TEST_CHECK(map.sync());
+        TEST_CHECK(copyFile(directory + "/insertions.log", directory + "/crash.log"));
+        TEST_CHECK(map.saveSnapshot());
+    }
+    TEST_CHECK(std::rename((directory + "/crash.log").c_str(), (directory + "/insertions.log").c_str()) == 0);
+    expected.push_back(segments[numSegments + 2]);
+    expected.push_back(segments[numSegments + 1]);
+    {
+        DurableTrapezoidalMap map(directory, 0);
+        TEST_CHECK(map.getNumReplayed() == 0);
+        TestMap fresh;
+        fresh.insert(expected);
+        TEST_CHECK(sameMap(map, fresh, 3));
+    }
+
+    std::remove((directory + "/insertions.log").c_str());
+    std::remove((directory + "/map.snapshot").c_str());
+    std::remove(filename.c_str());
+    rmdir(directory.c_str());
+}
+
+}
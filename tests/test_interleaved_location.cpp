@@ -0,0 +1,51 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/algorithms.h"
+#include "algorithms/batch_location.h"
+
+namespace{
+    /**
+     * @brief Check the interleaved descent against queryPoint, query by query
+     */
+    void checkInterleaved(const tests::TestMap &map, const std::vector<cg3::Point2d> &queryPoints){
+        std::vector<size_t> located = algorithms::queryPointsInterleaved(queryPoints, map.dag, map.dataset);
+        TEST_CHECK(located.size() == queryPoints.size());
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size() && i < located.size(); i++){
+            if(located[i] != algorithms::queryPoint(queryPoints[i], map.dag, map.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Interleaved Dag descent against queryPoint: empty batches, batches smaller and larger than a group of queries, random points,
+ * the endpoints and points on the segments, on the empty map, on a map with shared endpoints and on a grid map
+ */
+void testInterleavedLocation(){
+    TestMap emptyMap;
+    checkInterleaved(emptyMap, std::vector<cg3::Point2d>());
+    checkInterleaved(emptyMap, randomPoints(5, 1));
+
+    for(unsigned seed = 1; seed <= 2; seed++){
+        TestMap map;
+        map.insert(seed == 1 ? randomSegments(300, 30, seed) : gridSegments(20000, seed));
+
+        std::vector<cg3::Point2d> queryPoints = randomPoints(20000, seed);
+        for(const cg3::Point2d &point : map.dataset.getPoints()) queryPoints.push_back(point);
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+        checkInterleaved(map, queryPoints);
+
+        // Batches that do not fill a group, fill it exactly, or leave a partial group at the end
+        checkInterleaved(map, std::vector<cg3::Point2d>());
+        for(size_t batchSize : {1, 2, 15, 16, 17, 31, 33}){
+            checkInterleaved(map, std::vector<cg3::Point2d>(queryPoints.end() - batchSize, queryPoints.end()));
+        }
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "algorithms/algorithms.h"
+#include "algorithms/live_map.h"
+#include "data_structures/snapshot_publisher.h"
+
+namespace{
+    typedef std::vector<std::pair<size_t, size_t>> Answers;
+
+    /**
+     * @brief Make a snapshot of the structures of a map
+     */
+    const MapSnapshot *makeSnapshot(const tests::TestMap &map, size_t version){
+        ChunkedVector<cg3::Point2d> points;
+        ChunkedVector<TrapezoidalMapDataset::IndexedSegment2d> indexedSegments;
+        for(const cg3::Point2d &point : map.dataset.getPoints()) points.push_back(point);
+        for(const TrapezoidalMapDataset::IndexedSegment2d &indexedSegment : map.dataset.getIndexedSegments()) indexedSegments.push_back(indexedSegment);
+        return new MapSnapshot(map.dag, map.trapezoidalMap, points, indexedSegments, version);
+    }
+
+    /**
+     * @brief Get the segments above and below the query points on a snapshot
+     */
+    Answers snapshotAnswers(const MapSnapshot &snapshot, const std::vector<cg3::Point2d> &queryPoints){
+        Answers answers;
+        for(const cg3::Point2d &q : queryPoints){
+            const Trapezoid &trapezoid = snapshot.getTrapezoidalMap().getTrapezoid(algorithms::queryPoint(q, snapshot));
+            answers.push_back(std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx()));
+        }
+        return answers;
+    }
+
+    /**
+     * @brief The replaced snapshots held by a read guard are kept by reclaim until the guard is destroyed (a snapshot deleted too early
+     * is read after its deletion, which the address sanitizer reports)
+     */
+    void checkReclaim(){
+        std::vector<cg3::Segment2d> segments = tests::gridSegments(300, 1);
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(500, 1);
+        tests::TestMap first, second;
+        first.insert(std::vector<cg3::Segment2d>(segments.begin(), segments.begin() + 100));
+        second.insert(segments);
+        Answers firstAnswers = algorithms::queryAboveBelow(queryPoints, first.dag, first.trapezoidalMap, first.dataset);
+
+        SnapshotPublisher publisher;
+        {
+            SnapshotPublisher::ReadGuard empty(publisher);
+            TEST_CHECK(empty.getSnapshot() == nullptr);
+        }
+        publisher.publish(makeSnapshot(first, 0));
+        {
+            SnapshotPublisher::ReadGuard guard(publisher);
+            TEST_CHECK(guard.getSnapshot()->getVersion() == 0);
+            publisher.publish(makeSnapshot(second, 1));
+            publisher.reclaim();
+            TEST_CHECK(publisher.numRetired() == 1);
+            TEST_CHECK(guard.getSnapshot()->getVersion() == 0);
+            TEST_CHECK(snapshotAnswers(*guard.getSnapshot(), queryPoints) == firstAnswers);
+        }
+        {
+            // A reader entering after a publication holds only the snapshots replaced after it entered
+            SnapshotPublisher::ReadGuard later(publisher);
+            TEST_CHECK(later.getSnapshot()->getVersion() == 1);
+            publisher.publish(makeSnapshot(first, 2));
+            TEST_CHECK(publisher.numRetired() == 1);
+            TEST_CHECK(later.getSnapshot()->getVersion() == 1);
+            publisher.reclaim();
+            TEST_CHECK(publisher.numRetired() == 1);
+        }
+        publisher.reclaim();
+        TEST_CHECK(publisher.numRetired() == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Snapshots of a live map: reclaim keeps the snapshots held by the readers, and concurrent readers always see a whole published
+ * version (the answers of a map built with the segments of that version) while the writer inserts and publishes
+ */
+void testLiveMap(){
+    checkReclaim();
+
+    const size_t batchSize = 40;
+    std::vector<cg3::Segment2d> segments = gridSegments(2000, 2);
+    std::vector<cg3::Point2d> queryPoints = randomPoints(300, 2);
+    for(size_t i = 0; i < segments.size(); i += 7) queryPoints.push_back(segments[i].p1());
+
+    // Answers of every version: the empty map, then one more batch of segments for each publication
+    std::vector<Answers> versionAnswers;
+    TestMap map;
+    for(size_t numSegments = 0; ; numSegments += batchSize){
+        size_t end = std::min(numSegments + batchSize, segments.size());
+        versionAnswers.push_back(algorithms::queryAboveBelow(queryPoints, map.dag, map.trapezoidalMap, map.dataset));
+        if(numSegments >= segments.size()) break;
+        map.insert(std::vector<cg3::Segment2d>(segments.begin() + numSegments, segments.begin() + end));
+    }
+    const size_t lastVersion = versionAnswers.size() - 1;
+
+    LiveTrapezoidalMap liveMap;
+    std::atomic<size_t> mismatches(0), reads(0);
+    std::vector<std::thread> readers;
+    for(size_t readerIdx = 0; readerIdx < 4; readerIdx++){
+        readers.emplace_back([&, readerIdx](){
+            size_t seenVersion = 0;
+            while(seenVersion < lastVersion){
+                SnapshotPublisher::ReadGuard guard(liveMap.getPublisher());
+                const MapSnapshot &snapshot = *guard.getSnapshot();
+                if(snapshot.getVersion() < seenVersion || snapshot.getVersion() > lastVersion){
+                    mismatches++;
+                    break;
+                }
+                seenVersion = snapshot.getVersion();
+                size_t pointIdx = (reads++ + readerIdx) % queryPoints.size();
+                const Trapezoid &trapezoid = snapshot.getTrapezoidalMap().getTrapezoid(algorithms::queryPoint(queryPoints[pointIdx], snapshot));
+                if(std::make_pair(trapezoid.getTopSegmentIdx(), trapezoid.getBottomSegmentIdx()) != versionAnswers[seenVersion][pointIdx]) mismatches++;
+                if(seenVersion % 10 == readerIdx && snapshotAnswers(snapshot, queryPoints) != versionAnswers[seenVersion]) mismatches++;
+            }
+        });
+    }
+
+    // The writer: a publication every batch, the readers query the last published version with locate too
+    for(size_t i = 0; i < segments.size(); i++){
+        TEST_CHECK(liveMap.insertSegment(segments[i]));
+        if((i + 1) % batchSize == 0 || i + 1 == segments.size()) liveMap.publish();
+        if(i % 100 == 0) std::this_thread::yield();
+    }
+    for(std::thread &reader : readers) reader.join();
+    TEST_CHECK(mismatches == 0);
+    TEST_CHECK(reads > 0);
+
+    size_t locateMismatches = 0;
+    for(size_t pointIdx = 0; pointIdx < queryPoints.size(); pointIdx++){
+        if(liveMap.locate(queryPoints[pointIdx]) != versionAnswers[lastVersion][pointIdx]) locateMismatches++;
+    }
+    TEST_CHECK(locateMismatches == 0);
+}
+
+}
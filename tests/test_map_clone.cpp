@@ -0,0 +1,67 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/algorithms.h"
+#include "algorithms/map_clone.h"
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace{
+    /**
+     * @brief Get the use counts of the chunks of the Dag and of the trapezoidal map of a clone
+     */
+    std::vector<long> chunkUseCounts(const MapClone &clone){
+        std::vector<long> useCounts;
+        const ChunkedVector<Node> &nodes = clone.getDag().getNodes();
+        const ChunkedVector<Trapezoid> &trapezoids = clone.getTrapezoidalMap().getTrapezoids();
+        for(size_t chunkIdx = 0; chunkIdx < nodes.numChunks(); chunkIdx++) useCounts.push_back(nodes.chunkUseCount(chunkIdx));
+        for(size_t chunkIdx = 0; chunkIdx < trapezoids.numChunks(); chunkIdx++) useCounts.push_back(trapezoids.chunkUseCount(chunkIdx));
+        return useCounts;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief A rejected insertion in a clone does not copy the chunks it shares with the original map, an accepted one copies them
+ * without changing the original map
+ */
+void testMapClone(){
+    TestMap map;
+    map.insert(gridSegments(2000, 1));
+    size_t numTrapezoids = map.trapezoidalMap.numTrapezoids(), numNodes = map.dag.numNodes();
+    MapClone clone(map.dag, map.trapezoidalMap, map.dataset);
+    std::vector<long> useCountsBefore = chunkUseCounts(clone);
+    for(long useCount : useCountsBefore) TEST_CHECK(useCount == 2);
+
+    // Almost vertical segments through the midpoints of the segments of the map cross them
+    const std::vector<cg3::Point2d> &points = map.dataset.getPoints();
+    const std::vector<TrapezoidalMapDataset::IndexedSegment2d> &segments = map.dataset.getIndexedSegments();
+    for(size_t segmentIdx = 0; segmentIdx < segments.size(); segmentIdx += 50){
+        const cg3::Point2d &p1 = points[segments[segmentIdx].first], &p2 = points[segments[segmentIdx].second];
+        double midX = (p1.x() + p2.x()) / 2, midY = (p1.y() + p2.y()) / 2;
+        cg3::Segment2d crossing(cg3::Point2d(midX - 1, midY + 1000), cg3::Point2d(midX + 1, midY - 1000));
+        TEST_CHECK(!clone.insertSegment(crossing));
+    }
+    TEST_CHECK(chunkUseCounts(clone) == useCountsBefore);
+    TEST_CHECK(clone.numSegments() == segments.size());
+
+    // A segment in the empty band below the grid is accepted: the clone copies the chunks it writes, the original map does not change
+    std::vector<cg3::Point2d> queryPoints = randomPoints(2000, 1);
+    std::vector<std::pair<size_t, size_t>> answersBefore = algorithms::queryAboveBelow(queryPoints, map.dag, map.trapezoidalMap, map.dataset);
+    TEST_CHECK(clone.insertSegment(cg3::Segment2d(cg3::Point2d(-0.5 * TEST_BOUNDINGBOX, -0.95 * TEST_BOUNDINGBOX), cg3::Point2d(0.5 * TEST_BOUNDINGBOX, -0.95 * TEST_BOUNDINGBOX))));
+    TEST_CHECK(chunkUseCounts(clone) != useCountsBefore);
+    TEST_CHECK(clone.getTrapezoidalMap().numTrapezoids() > numTrapezoids);
+    TEST_CHECK(map.trapezoidalMap.numTrapezoids() == numTrapezoids && map.dag.numNodes() == numNodes);
+    TEST_CHECK(algorithms::queryAboveBelow(queryPoints, map.dag, map.trapezoidalMap, map.dataset) == answersBefore);
+    size_t mismatches = 0;
+    for(size_t i = 0; i < queryPoints.size(); i++){
+        // Above the new segment the clone answers as the original map, except for the points that had no segment below
+        if(queryPoints[i].y() < -0.9 * TEST_BOUNDINGBOX) continue;
+        std::pair<size_t, size_t> answer = clone.locate(queryPoints[i]);
+        if(answer.first != answersBefore[i].first || (answersBefore[i].second != std::numeric_limits<size_t>::max() && answer.second != answersBefore[i].second)) mismatches++;
+    }
+    TEST_CHECK(mismatches == 0);
+}
+
+}
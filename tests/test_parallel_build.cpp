@@ -0,0 +1,100 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include "algorithms/algorithms.h"
+#include "algorithms/parallel_build.h"
+
+namespace{
+    typedef std::tuple<size_t, size_t, double, double, double, double> TrapezoidKey;
+
+    /**
+     * @brief Get the trapezoids of a map as sorted (top, bottom, left point, right point) tuples, to compare maps built in different orders
+     */
+    std::vector<TrapezoidKey> trapezoidKeys(const TrapezoidalMap &trapezoidalMap){
+        std::vector<TrapezoidKey> keys;
+        for(const Trapezoid &t : trapezoidalMap.getTrapezoids()){
+            keys.push_back(TrapezoidKey(t.getTopSegmentIdx(), t.getBottomSegmentIdx(), t.getLeftPoint().x(), t.getLeftPoint().y(), t.getRightPoint().x(), t.getRightPoint().y()));
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    /**
+     * @brief Check that the neighbors of every trapezoid touch it and point back to it
+     */
+    bool consistentNeighbors(const TrapezoidalMap &trapezoidalMap){
+        const size_t nullIdx = std::numeric_limits<size_t>::max();
+        for(size_t i = 0; i < trapezoidalMap.numTrapezoids(); i++){
+            const Trapezoid &t = trapezoidalMap.getTrapezoid(i);
+            for(size_t n : {t.getUpperRightNeighbor(), t.getLowerRightNeighbor()}){
+                if(n == nullIdx) continue;
+                const Trapezoid &o = trapezoidalMap.getTrapezoid(n);
+                if(o.getLeftPoint().x() != t.getRightPoint().x() || (o.getUpperLeftNeighbor() != i && o.getLowerLeftNeighbor() != i)) return false;
+            }
+            for(size_t n : {t.getUpperLeftNeighbor(), t.getLowerLeftNeighbor()}){
+                if(n == nullIdx) continue;
+                const Trapezoid &o = trapezoidalMap.getTrapezoid(n);
+                if(o.getRightPoint().x() != t.getLeftPoint().x() || (o.getUpperRightNeighbor() != i && o.getLowerRightNeighbor() != i)) return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Build in parallel the map of the first 4/5 of the segments, compare it with the sequential map, then insert the others
+     * with buildTrapezoidalMap and compare the queries with the sequential construction of all the segments
+     */
+    void checkParallelBuild(const std::vector<cg3::Segment2d> &segments, size_t numSlabs, unsigned seed){
+        tests::TestMap sequential;
+        sequential.insert(segments);
+        size_t numBuilt = sequential.dataset.getSegments().size() * 4 / 5;
+
+        tests::TestMap parallel, partialSequential;
+        for(size_t i = 0; i < numBuilt; i++){
+            bool inserted;
+            parallel.dataset.addSegment(sequential.dataset.getSegment(i), inserted);
+        }
+        partialSequential.insert(parallel.dataset.getSegments());
+        algorithms::buildTrapezoidalMapParallel(parallel.dag, parallel.trapezoidalMap, parallel.dataset, numSlabs, 4);
+        TEST_CHECK(consistentNeighbors(parallel.trapezoidalMap));
+        TEST_CHECK(trapezoidKeys(parallel.trapezoidalMap) == trapezoidKeys(partialSequential.trapezoidalMap));
+
+        std::vector<cg3::Segment2d> remaining;
+        for(size_t i = numBuilt; i < sequential.dataset.getSegments().size(); i++) remaining.push_back(sequential.dataset.getSegment(i));
+        parallel.insert(remaining);
+        TEST_CHECK(consistentNeighbors(parallel.trapezoidalMap));
+        TEST_CHECK(trapezoidKeys(parallel.trapezoidalMap) == trapezoidKeys(sequential.trapezoidalMap));
+
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(20000, seed);
+        for(const cg3::Point2d &point : sequential.dataset.getPoints()) queryPoints.push_back(point);
+        size_t mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            if(algorithms::queryAboveBelow(q, parallel.dag, parallel.trapezoidalMap, parallel.dataset) !=
+               algorithms::queryAboveBelow(q, sequential.dag, sequential.trapezoidalMap, sequential.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Parallel construction against the sequential one, on short segments (in one or two slabs), on long random segments (most
+ * of them cut by most of the boundaries) and on segments sharing their endpoints, with one slab and with many slabs
+ */
+void testParallelBuild(){
+    for(unsigned seed = 1; seed <= 2; seed++){
+        std::vector<cg3::Segment2d> shortSegments = gridSegments(2000, seed);
+        std::vector<cg3::Segment2d> mostlyLongSegments = longSegments(1000, seed);
+        std::vector<cg3::Segment2d> sharedEndpoints = randomSegments(600, 40, seed);
+        for(size_t numSlabs : {1, 3, 16, 64}){
+            checkParallelBuild(shortSegments, numSlabs, seed);
+            checkParallelBuild(mostlyLongSegments, numSlabs, seed);
+            checkParallelBuild(sharedEndpoints, numSlabs, seed);
+        }
+    }
+}
+
+}
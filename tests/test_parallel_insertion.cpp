@@ -0,0 +1,85 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <vector>
+#include "algorithms/algorithms.h"
+#include "algorithms/parallel_insertion.h"
+
+namespace{
+    /**
+     * @brief Check that two maps have the same trapezoids (segments, points, dataset indexes, neighbors and leaves) at the same indexes
+     */
+    bool sameTrapezoids(const TrapezoidalMap &trapezoidalMap, const TrapezoidalMap &expected){
+        if(trapezoidalMap.numTrapezoids() != expected.numTrapezoids()) return false;
+        for(size_t i = 0; i < expected.numTrapezoids(); i++){
+            const Trapezoid &t = trapezoidalMap.getTrapezoid(i), &e = expected.getTrapezoid(i);
+            if(t.getTopSegment() != e.getTopSegment() || t.getBottomSegment() != e.getBottomSegment() ||
+               t.getLeftPoint() != e.getLeftPoint() || t.getRightPoint() != e.getRightPoint() ||
+               t.getTopSegmentIdx() != e.getTopSegmentIdx() || t.getBottomSegmentIdx() != e.getBottomSegmentIdx() ||
+               t.getUpperLeftNeighbor() != e.getUpperLeftNeighbor() || t.getLowerLeftNeighbor() != e.getLowerLeftNeighbor() ||
+               t.getUpperRightNeighbor() != e.getUpperRightNeighbor() || t.getLowerRightNeighbor() != e.getLowerRightNeighbor() ||
+               t.getNodeIdx() != e.getNodeIdx()) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check that two Dags have the same nodes at the same indexes
+     */
+    bool sameNodes(const Dag &dag, const Dag &expected){
+        if(dag.numNodes() != expected.numNodes()) return false;
+        for(size_t i = 0; i < expected.numNodes(); i++){
+            const Node &n = dag.getNode(i), &e = expected.getNode(i);
+            if(n.getType() != e.getType() || n.getIdx() != e.getIdx() || n.getLeftIdx() != e.getLeftIdx() || n.getRightIdx() != e.getRightIdx()) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Insert the segments in parallel, and compare the structures with the sequential insertion. With shared set, the first third
+     * of the segments is inserted sequentially, and the partial map is shared with a copy which must not change.
+     */
+    void checkParallelInsertion(const std::vector<cg3::Segment2d> &segments, bool shared, size_t numThreads){
+        tests::TestMap sequential;
+        sequential.insert(segments);
+        const std::vector<cg3::Segment2d> &accepted = sequential.dataset.getSegments();
+        size_t numBuilt = shared ? accepted.size() / 3 : 0;
+
+        tests::TestMap parallel;
+        parallel.insert(std::vector<cg3::Segment2d>(accepted.begin(), accepted.begin() + numBuilt));
+        tests::TestMap copy = parallel;
+        std::vector<size_t> segmentOrder;
+        for(size_t i = numBuilt; i < accepted.size(); i++){
+            bool inserted;
+            parallel.dataset.addSegment(accepted[i], inserted);
+            segmentOrder.push_back(i);
+        }
+        algorithms::insertSegmentsParallel(segmentOrder, parallel.dag, parallel.trapezoidalMap, parallel.dataset, numThreads);
+        TEST_CHECK(sameTrapezoids(parallel.trapezoidalMap, sequential.trapezoidalMap));
+        TEST_CHECK(sameNodes(parallel.dag, sequential.dag));
+
+        tests::TestMap partial;
+        partial.insert(std::vector<cg3::Segment2d>(accepted.begin(), accepted.begin() + numBuilt));
+        TEST_CHECK(sameTrapezoids(copy.trapezoidalMap, partial.trapezoidalMap));
+        TEST_CHECK(sameNodes(copy.dag, partial.dag));
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Parallel insertion against the sequential one, index by index: with 1, 3 and 8 threads, on segments sharing endpoints, on
+ * short segments and on long segments (many conflicts), from the empty map and from a partial map shared with a copy
+ */
+void testParallelInsertion(){
+    for(unsigned seed = 1; seed <= 2; seed++){
+        std::vector<std::vector<cg3::Segment2d>> inputs = {randomSegments(1000, 60, seed), gridSegments(3000, seed), longSegments(1000, seed)};
+        for(const std::vector<cg3::Segment2d> &segments : inputs){
+            for(size_t numThreads : {1, 3, 8}){
+                checkParallelInsertion(segments, false, numThreads);
+                checkParallelInsertion(segments, true, numThreads);
+            }
+        }
+    }
+}
+
+}
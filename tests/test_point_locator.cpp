@@ -0,0 +1,33 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/point_locator.h"
+
+namespace tests{
+
+/**
+ * @brief The slab tree locator answers as the Dag locator: random points, the endpoints (on the slab boundaries) and the midpoints of
+ * the segments, on the empty map, on maps with shared endpoints and on a grid map
+ */
+void testPointLocator(){
+    for(unsigned seed = 0; seed <= 3; seed++){
+        TestMap map;
+        if(seed > 0) map.insert(seed < 3 ? randomSegments(300, 30, seed) : gridSegments(5000, seed));
+
+        std::vector<cg3::Point2d> queryPoints = randomPoints(5000, seed);
+        queryPoints.insert(queryPoints.end(), map.dataset.getPoints().begin(), map.dataset.getPoints().end());
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+
+        DagPointLocator dagLocator(map.dag, map.trapezoidalMap, map.dataset);
+        SlabPointLocator slabLocator(map.dataset);
+        std::vector<std::pair<size_t, size_t>> dagAnswers = dagLocator.locate(queryPoints), slabAnswers = slabLocator.locate(queryPoints);
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size(); i++){
+            if(dagAnswers[i] != slabAnswers[i]) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+}
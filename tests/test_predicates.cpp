@@ -0,0 +1,99 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cmath>
+#include <random>
+#include "utils/predicates.h"
+
+namespace{
+    /**
+     * @brief Exact sign of the orientation of points whose coordinates are integers once multiplied by 2^scale (at most 2^62)
+     */
+    int exactSign(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c, int scale){
+        long long ax = std::llround(std::ldexp(a.x(), scale)), ay = std::llround(std::ldexp(a.y(), scale));
+        long long bx = std::llround(std::ldexp(b.x(), scale)), by = std::llround(std::ldexp(b.y(), scale));
+        long long cx = std::llround(std::ldexp(c.x(), scale)), cy = std::llround(std::ldexp(c.y(), scale));
+        __int128 det = static_cast<__int128>(ax - cx) * (by - cy) - static_cast<__int128>(ay - cy) * (bx - cx);
+        return det > 0 ? 1 : (det < 0 ? -1 : 0);
+    }
+
+    int sign(double value){
+        return value > 0 ? 1 : (value < 0 ? -1 : 0);
+    }
+
+    /**
+     * @brief Check if the floating point filter cannot decide an orientation (the products have the same sign and the determinant is
+     * within the error bound)
+     */
+    bool filterUncertain(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c){
+        double detLeft = (a.x() - c.x()) * (b.y() - c.y()), detRight = (a.y() - c.y()) * (b.x() - c.x());
+        if((detLeft > 0 && detRight > 0) || (detLeft < 0 && detRight < 0)){
+            return std::abs(detLeft - detRight) < ORIENT2D_ERROR_BOUND * (std::abs(detLeft) + std::abs(detRight));
+        }
+        return false;
+    }
+
+    /**
+     * @brief Check an orientation against its exact sign, and the fallback counter: it moves only if the filter cannot decide
+     */
+    void checkOrientation(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c, int expected, size_t &mismatches){
+        size_t fallbacks = ProjectUtils::orientationFallbacks();
+        double orientation = ProjectUtils::orient2d(a, b, c);
+        size_t moved = ProjectUtils::orientationFallbacks() - fallbacks;
+        if(sign(orientation) != expected) mismatches++;
+        if(moved != (filterUncertain(a, b, c) ? 1u : 0u)) mismatches++;
+        if(sign(ProjectUtils::orient2dExact(a, b, c)) != expected) mismatches++;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Orientation predicates against exact integer determinants: nearly collinear points (Shewchuk's grid of points a few ulps from
+ * a line), random integer points, and shared endpoints; the fallback counter moves only on the orientations the filter cannot decide
+ */
+void testPredicates(){
+    size_t mismatches = 0;
+
+    // Points (0.5 + i ulp, 0.5 + j ulp) around the line y = x through (12, 12) and (24, 24): most of them need the exact evaluation
+    const double ulp = std::ldexp(1.0, -53);
+    cg3::Point2d b(12, 12), c(24, 24);
+    ProjectUtils::resetOrientationFallbacks();
+    for(int i = 0; i < 64; i++){
+        for(int j = 0; j < 64; j++){
+            cg3::Point2d a(0.5 + i * ulp, 0.5 + j * ulp);
+            int expected = exactSign(a, b, c, 53);
+            checkOrientation(a, b, c, expected, mismatches);
+            checkOrientation(b, c, a, expected, mismatches);
+            checkOrientation(b, a, c, -expected, mismatches);
+        }
+    }
+    size_t nearlyCollinearFallbacks = ProjectUtils::orientationFallbacks();
+
+    // Random integer points, well separated: the filter decides all of them
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<long long> coordinate(-(1LL << 26), 1LL << 26);
+    ProjectUtils::resetOrientationFallbacks();
+    size_t uncertain = 0;
+    for(size_t i = 0; i < 10000; i++){
+        cg3::Point2d p(coordinate(generator), coordinate(generator)), q(coordinate(generator), coordinate(generator)), r(coordinate(generator), coordinate(generator));
+        if(filterUncertain(p, q, r)) uncertain++;
+        size_t fallbacks = ProjectUtils::orientationFallbacks();
+        if(sign(ProjectUtils::orient2d(p, q, r)) != exactSign(p, q, r, 0)) mismatches++;
+        if(ProjectUtils::orientationFallbacks() != fallbacks + (filterUncertain(p, q, r) ? 1 : 0)) mismatches++;
+    }
+    TEST_CHECK(ProjectUtils::orientationFallbacks() == uncertain);
+
+    // Shared endpoints: the orientation is exactly zero; only a repeated first point (both products equal) needs the exact evaluation
+    std::uniform_real_distribution<double> real(-TEST_BOUNDINGBOX, TEST_BOUNDINGBOX);
+    for(size_t i = 0; i < 1000; i++){
+        cg3::Point2d p(real(generator), real(generator)), q(real(generator), real(generator));
+        checkOrientation(p, q, p, 0, mismatches);
+        checkOrientation(p, q, q, 0, mismatches);
+        checkOrientation(p, p, q, 0, mismatches);
+    }
+
+    TEST_CHECK(mismatches == 0);
+    TEST_CHECK(nearlyCollinearFallbacks > 0);
+}
+
+}
@@ -0,0 +1,65 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cmath>
+#include <limits>
+#include "algorithms/algorithms.h"
+#include "algorithms/quantized_location.h"
+
+namespace{
+    /**
+     * @brief Check queryPointQuantized against queryPoint, on query points whose coordinates are multiples of 1/scale
+     */
+    template<class T>
+    void checkQuantized(const tests::TestMap &map, const std::vector<cg3::Point2d> &queryPoints, double scale){
+        QuantizedGeometry<T> geometry;
+        TEST_CHECK(geometry.build(map.dataset, scale));
+        size_t mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            if(algorithms::queryPointQuantized(q, map.dag, geometry) != algorithms::queryPoint(q, map.dag, map.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Quantized point location against queryPoint (random points and the endpoints, the exact ties of the predicates), and the
+ * rejection of the coordinates too large for the type, in the dataset and in the query points
+ */
+void testQuantizedLocation(){
+    // Segments with integer endpoints, so the geometry is exact with every integer scale
+    std::vector<cg3::Segment2d> segments = randomSegments(300, 30, 1);
+    for(cg3::Segment2d &segment : segments){
+        segment = cg3::Segment2d(cg3::Point2d(std::round(segment.p1().x()), std::round(segment.p1().y())),
+                                 cg3::Point2d(std::round(segment.p2().x()), std::round(segment.p2().y())));
+    }
+    TestMap map;
+    map.insert(segments);
+
+    const double scale = 1000;
+    std::vector<cg3::Point2d> queryPoints = randomPoints(20000, 1);
+    for(cg3::Point2d &q : queryPoints) q = cg3::Point2d(std::round(q.x() * scale) / scale, std::round(q.y() * scale) / scale);
+    for(const cg3::Point2d &point : map.dataset.getPoints()) queryPoints.push_back(point);
+    checkQuantized<int32_t>(map, queryPoints, scale);
+#if defined(__SIZEOF_INT128__)
+    checkQuantized<int64_t>(map, queryPoints, scale);
+#endif
+
+    // A dataset with coordinates too large for the type is rejected
+    QuantizedGeometry<int32_t> tooFine;
+    TEST_CHECK(!tooFine.build(map.dataset, 10000));
+    TEST_CHECK(tooFine.numPoints() == 0);
+
+    // A query point too large for the type is not quantized, a point far outside the bounding box but representable is located
+    QuantizedGeometry<int32_t> geometry;
+    geometry.build(map.dataset, scale);
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    TEST_CHECK(algorithms::queryPointQuantized(cg3::Point2d(2e+6, 0), map.dag, geometry) == nullIdx);
+    TEST_CHECK(algorithms::queryPointQuantized(cg3::Point2d(0, -2e+6), map.dag, geometry) == nullIdx);
+    TEST_CHECK(algorithms::queryPointQuantized(cg3::Point2d(1e+300, 1e+300), map.dag, geometry) == nullIdx);
+    cg3::Point2d outside(1e+6, -1e+6);
+    TEST_CHECK(algorithms::queryPointQuantized(outside, map.dag, geometry) == algorithms::queryPoint(outside, map.dag, map.dataset));
+}
+
+}
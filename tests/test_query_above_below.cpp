@@ -0,0 +1,74 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <limits>
+#include <utility>
+#include <vector>
+#include "algorithms/algorithms.h"
+#include "utils/predicates.h"
+
+namespace{
+    /**
+     * @brief Vertical ray shooting by brute force: among the segments spanning the x of q (right endpoint excluded, as the x-nodes), the
+     * lowest one above q and the highest one below q, ordered by their y at x and then by their slope. A segment through q is above it.
+     */
+    std::pair<size_t, size_t> aboveBelowBruteForce(const cg3::Point2d &q, const TrapezoidalMapDataset &dataset){
+        const size_t nullIdx = std::numeric_limits<size_t>::max();
+        std::pair<size_t, size_t> aboveBelow(nullIdx, nullIdx);
+        long double aboveY = 0, aboveSlope = 0, belowY = 0, belowSlope = 0;
+        for(size_t segmentIdx = 0; segmentIdx < dataset.getIndexedSegments().size(); segmentIdx++){
+            cg3::Segment2d segment = dataset.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            if(q.x() < segment.p1().x() || q.x() >= segment.p2().x()) continue;
+            long double slope = (static_cast<long double>(segment.p2().y()) - segment.p1().y()) / (static_cast<long double>(segment.p2().x()) - segment.p1().x());
+            long double y = segment.p1().y() + slope * (q.x() - segment.p1().x());
+            if(ProjectUtils::orient2dExact(segment.p1(), segment.p2(), q) <= 0){
+                if(aboveBelow.first == nullIdx || y < aboveY || (y == aboveY && slope < aboveSlope)){
+                    aboveBelow.first = segmentIdx;
+                    aboveY = y;
+                    aboveSlope = slope;
+                }
+            }else if(aboveBelow.second == nullIdx || y > belowY || (y == belowY && slope > belowSlope)){
+                aboveBelow.second = segmentIdx;
+                belowY = y;
+                belowSlope = slope;
+            }
+        }
+        return aboveBelow;
+    }
+
+    /**
+     * @brief Check the query at random points and at the endpoints against the brute force
+     */
+    void checkAboveBelow(const tests::TestMap &map, unsigned seed){
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(1000, seed);
+        queryPoints.insert(queryPoints.end(), map.dataset.getPoints().begin(), map.dataset.getPoints().end());
+        std::vector<std::pair<size_t, size_t>> aboveBelow = algorithms::queryAboveBelow(queryPoints, map.dag, map.trapezoidalMap, map.dataset);
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size(); i++){
+            if(aboveBelow[i] != aboveBelowBruteForce(queryPoints[i], map.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Segments above and below random points and the endpoints, on the empty map, on maps with shared endpoints and on a grid map
+ */
+void testQueryAboveBelow(){
+    const size_t nullIdx = std::numeric_limits<size_t>::max();
+    TestMap empty;
+    TEST_CHECK(algorithms::queryAboveBelow(cg3::Point2d(0, 0), empty.dag, empty.trapezoidalMap, empty.dataset) == std::make_pair(nullIdx, nullIdx));
+
+    for(unsigned seed = 1; seed <= 3; seed++){
+        TestMap map;
+        map.insert(randomSegments(300, 40, seed));
+        checkAboveBelow(map, seed);
+    }
+    TestMap gridMap;
+    gridMap.insert(gridSegments(2000, 4));
+    checkAboveBelow(gridMap, 4);
+}
+
+}
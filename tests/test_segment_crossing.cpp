@@ -0,0 +1,84 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "algorithms/algorithms.h"
+#include "utils/predicates.h"
+
+namespace{
+    /**
+     * @brief Segments crossed by a query segment by brute force: the proper crossings, ordered from the left (lower) endpoint of the query
+     */
+    std::vector<size_t> crossingBruteForce(const cg3::Segment2d &querySegment, const TrapezoidalMapDataset &dataset){
+        cg3::Segment2d query = querySegment;
+        if(query.p2() < query.p1()) query = cg3::Segment2d(querySegment.p2(), querySegment.p1());
+        const cg3::Point2d &a = query.p1(), &b = query.p2();
+        std::vector<std::pair<long double, size_t>> crossings;
+        for(size_t segmentIdx = 0; segmentIdx < dataset.getIndexedSegments().size(); segmentIdx++){
+            cg3::Segment2d segment = dataset.getSegment(segmentIdx);
+            const cg3::Point2d &c = segment.p1(), &d = segment.p2();
+            double o1 = ProjectUtils::orient2dExact(a, b, c), o2 = ProjectUtils::orient2dExact(a, b, d);
+            double o3 = ProjectUtils::orient2dExact(c, d, a), o4 = ProjectUtils::orient2dExact(c, d, b);
+            if(!((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) || !((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0))) continue;
+            // Parameter of the crossing along the query
+            long double dx = static_cast<long double>(b.x()) - a.x(), dy = static_cast<long double>(b.y()) - a.y();
+            long double ex = static_cast<long double>(d.x()) - c.x(), ey = static_cast<long double>(d.y()) - c.y();
+            long double t = ((static_cast<long double>(c.x()) - a.x()) * ey - (static_cast<long double>(c.y()) - a.y()) * ex) / (dx * ey - dy * ex);
+            crossings.push_back(std::make_pair(t, segmentIdx));
+        }
+        std::sort(crossings.begin(), crossings.end());
+        std::vector<size_t> crossedSegments;
+        for(const std::pair<long double, size_t> &crossing : crossings) crossedSegments.push_back(crossing.second);
+        return crossedSegments;
+    }
+
+    /**
+     * @brief Check a query and its reverse against the brute force: the crossed segments, and the trapezoids of the endpoints at the
+     * ends of the walk
+     */
+    void checkCrossing(const cg3::Segment2d &querySegment, const tests::TestMap &map){
+        std::vector<size_t> crossedTrapezoids, crossedSegments;
+        algorithms::querySegmentCrossing(querySegment, map.dag, map.trapezoidalMap, map.dataset, crossedTrapezoids, crossedSegments);
+        std::vector<size_t> expected = crossingBruteForce(querySegment, map.dataset);
+        TEST_CHECK(crossedSegments == expected);
+        TEST_CHECK(crossedTrapezoids.size() >= crossedSegments.size() + 1);
+
+        cg3::Segment2d query = querySegment;
+        if(query.p2() < query.p1()) query = cg3::Segment2d(querySegment.p2(), querySegment.p1());
+        if(query.p1().x() != query.p2().x()){
+            TEST_CHECK(crossedTrapezoids.front() == algorithms::queryPoint(query.p1(), map.dag, map.dataset));
+            TEST_CHECK(crossedTrapezoids.back() == algorithms::queryPoint(query.p2(), map.dag, map.dataset));
+        }
+
+        std::vector<size_t> reversedTrapezoids, reversedSegments;
+        algorithms::querySegmentCrossing(cg3::Segment2d(querySegment.p2(), querySegment.p1()), map.dag, map.trapezoidalMap, map.dataset, reversedTrapezoids, reversedSegments);
+        TEST_CHECK(reversedTrapezoids == crossedTrapezoids && reversedSegments == crossedSegments);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Segment-crossing queries against a brute force: long and short random queries, vertical queries, and the same queries reversed,
+ * on maps with shared endpoints and on a grid map
+ */
+void testSegmentCrossing(){
+    for(unsigned seed = 1; seed <= 4; seed++){
+        TestMap map;
+        if(seed < 4) map.insert(randomSegments(300, 40, seed));
+        else map.insert(gridSegments(2000, seed));
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-TEST_BOUNDINGBOX, TEST_BOUNDINGBOX), offset(-0.1 * TEST_BOUNDINGBOX, 0.1 * TEST_BOUNDINGBOX);
+        for(size_t i = 0; i < 200; i++){
+            cg3::Point2d p(0.9 * coordinate(generator), 0.9 * coordinate(generator));
+            checkCrossing(cg3::Segment2d(p, cg3::Point2d(0.9 * coordinate(generator), 0.9 * coordinate(generator))), map);
+            checkCrossing(cg3::Segment2d(p, cg3::Point2d(p.x() + offset(generator), p.y() + offset(generator))), map);
+            checkCrossing(cg3::Segment2d(p, cg3::Point2d(p.x(), 0.9 * coordinate(generator))), map);
+        }
+    }
+}
+
+}
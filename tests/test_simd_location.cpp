@@ -0,0 +1,52 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cstdio>
+#include "algorithms/algorithms.h"
+#include "algorithms/simd_location.h"
+
+namespace{
+    /**
+     * @brief Check the vectorized and the scalar packed descents against queryPoint, query by query
+     */
+    void checkSimd(const tests::TestMap &map, const std::vector<cg3::Point2d> &queryPoints){
+        PackedGeometry packedGeometry;
+        packedGeometry.build(map.dataset);
+        std::vector<size_t> simd = algorithms::queryPointsSimd(queryPoints, map.dag, packedGeometry);
+        std::vector<size_t> scalar = algorithms::queryPointsScalar(queryPoints, map.dag, packedGeometry);
+        TEST_CHECK(simd.size() == queryPoints.size());
+        TEST_CHECK(scalar.size() == queryPoints.size());
+        size_t mismatches = 0;
+        for(size_t i = 0; i < queryPoints.size() && i < simd.size() && i < scalar.size(); i++){
+            size_t expected = algorithms::queryPoint(queryPoints[i], map.dag, map.dataset);
+            if(simd[i] != expected || scalar[i] != expected) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Vectorized Dag descent against queryPoint: random points, the endpoints and points on the segments (exact ties of the
+ * predicates), on a map with shared endpoints and on a map whose Dag spans thousands of chunks
+ */
+void testSimdLocation(){
+    TestMap emptyMap;
+    checkSimd(emptyMap, randomPoints(10, 1));
+
+    for(unsigned seed = 1; seed <= 2; seed++){
+        TestMap map;
+        map.insert(seed == 1 ? randomSegments(300, 30, seed) : gridSegments(50000, seed));
+
+        std::vector<cg3::Point2d> queryPoints = randomPoints(20000, seed);
+        for(const cg3::Point2d &point : map.dataset.getPoints()) queryPoints.push_back(point);
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+        checkSimd(map, queryPoints);
+        if(seed == 2) TEST_CHECK(map.dag.getNodes().numChunks() > 1000);
+    }
+    if(!algorithms::simdQueriesSupported()) std::printf("simd_location: AVX2 not supported, only the scalar kernel was tested\n");
+}
+
+}
@@ -0,0 +1,83 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <cstdio>
+#include <limits>
+#include "algorithms/algorithms.h"
+#include "algorithms/simd_location.h"
+
+namespace{
+    /**
+     * @brief Check the vectorized and the scalar scans against each other, and the small map query against queryPoint: a point found
+     * by the scan is in the trapezoid of queryPoint, the points on the border of the bounding box are found by no trapezoid
+     */
+    void checkScan(const tests::TestMap &map, const std::vector<cg3::Point2d> &queryPoints){
+        const size_t nullIdx = std::numeric_limits<size_t>::max();
+        PackedTrapezoids packedTrapezoids;
+        packedTrapezoids.build(map.trapezoidalMap);
+        size_t mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            size_t expected = algorithms::queryPoint(q, map.dag, map.dataset);
+            size_t scanned = algorithms::scanTrapezoids(q, packedTrapezoids);
+            if(scanned != algorithms::scanTrapezoidsScalar(q, packedTrapezoids)) mismatches++;
+            if(scanned != nullIdx && scanned != expected) mismatches++;
+            if(algorithms::queryPointSmallMap(q, map.dag, map.dataset, packedTrapezoids) != expected) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+
+    /**
+     * @brief Get the query points of a map: random points, the endpoints, points above and below the endpoints (on the vertical sides),
+     * the midpoints of the segments and points on the border of the bounding box
+     */
+    std::vector<cg3::Point2d> queryPointsOf(const tests::TestMap &map, unsigned seed){
+        std::vector<cg3::Point2d> queryPoints = tests::randomPoints(2000, seed);
+        for(const cg3::Point2d &point : map.dataset.getPoints()){
+            queryPoints.push_back(point);
+            queryPoints.push_back(cg3::Point2d(point.x(), point.y() + 1000));
+            queryPoints.push_back(cg3::Point2d(point.x(), point.y() - 1000));
+        }
+        for(const cg3::Segment2d &segment : map.dataset.getSegments()){
+            queryPoints.push_back(cg3::Point2d((segment.p1().x() + segment.p2().x()) / 2, (segment.p1().y() + segment.p2().y()) / 2));
+        }
+        for(double t = -1; t <= 1; t += 0.25){
+            queryPoints.push_back(cg3::Point2d(t * TEST_BOUNDINGBOX, TEST_BOUNDINGBOX));
+            queryPoints.push_back(cg3::Point2d(t * TEST_BOUNDINGBOX, -TEST_BOUNDINGBOX));
+            queryPoints.push_back(cg3::Point2d(TEST_BOUNDINGBOX, t * TEST_BOUNDINGBOX));
+            queryPoints.push_back(cg3::Point2d(-TEST_BOUNDINGBOX, t * TEST_BOUNDINGBOX));
+        }
+        return queryPoints;
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Linear scan of small maps (the vectorized one and the scalar one) against queryPoint, on maps of up to 64 segments: the empty
+ * map, maps with shared endpoints, and a map with integer coordinates, whose midpoints lie exactly on the segments
+ */
+void testSmallMapScan(){
+    TestMap emptyMap;
+    checkScan(emptyMap, queryPointsOf(emptyMap, 1));
+
+    for(unsigned seed = 1; seed <= 3; seed++){
+        TestMap map;
+        map.insert(randomSegments(seed == 1 ? 1 : 64, 12, seed));
+        TEST_CHECK(map.dataset.getIndexedSegments().size() <= 64);
+        checkScan(map, queryPointsOf(map, seed));
+    }
+
+    // Segments in disjoint x ranges with even integer differences between the endpoints
+    std::vector<cg3::Segment2d> segments;
+    for(int i = 0; i < 60; i++){
+        cg3::Point2d p1(-900000 + 30000 * i, -800000 + 50000 * (i % 7));
+        segments.push_back(cg3::Segment2d(p1, cg3::Point2d(p1.x() + 20000, p1.y() + 2000 * (i % 5) - 4000)));
+    }
+    TestMap integerMap;
+    integerMap.insert(segments);
+    TEST_CHECK(integerMap.dataset.getIndexedSegments().size() == segments.size());
+    checkScan(integerMap, queryPointsOf(integerMap, 4));
+
+    if(!algorithms::simdQueriesSupported()) std::printf("small_map_scan: AVX2 not supported, only the scalar scan was tested\n");
+}
+
+}
@@ -0,0 +1,92 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <random>
+#include "algorithms/algorithms.h"
+#include "algorithms/balanced_dag.h"
+
+namespace{
+    /**
+     * @brief Key of a segment crossing a vertical line: its y at the line, then its slope (the order just to the right of the line)
+     */
+    struct CrossingKey{
+        long double y;
+        long double slope;
+        size_t segmentIdx;
+        bool operator<(const CrossingKey &other) const{ return y != other.y ? y < other.y : slope < other.slope; }
+    };
+
+    /**
+     * @brief Stabbing query by brute force: the segments spanning x (right endpoint excluded), sorted by their y at x
+     */
+    std::vector<CrossingKey> stabBruteForce(double x, const TrapezoidalMapDataset &dataset){
+        std::vector<CrossingKey> crossings;
+        for(size_t segmentIdx = 0; segmentIdx < dataset.getIndexedSegments().size(); segmentIdx++){
+            cg3::Segment2d segment = dataset.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            if(x < segment.p1().x() || x >= segment.p2().x()) continue;
+            long double slope = (static_cast<long double>(segment.p2().y()) - segment.p1().y()) / (static_cast<long double>(segment.p2().x()) - segment.p1().x());
+            CrossingKey key = {segment.p1().y() + slope * (x - segment.p1().x()), slope, segmentIdx};
+            crossings.push_back(key);
+        }
+        std::sort(crossings.begin(), crossings.end());
+        return crossings;
+    }
+
+    /**
+     * @brief Check the stabbing query and the vertical crossing query at some x against the brute force
+     */
+    void checkStab(const TrapezoidalMapDataset &dataset, const Dag &dag, const TrapezoidalMap &trapezoidalMap, const std::vector<double> &xs){
+        std::mt19937 generator(7);
+        for(double x : xs){
+            std::vector<CrossingKey> expected = stabBruteForce(x, dataset);
+            std::vector<size_t> stabbed = algorithms::stabVertical(x, dag, trapezoidalMap, dataset);
+            TEST_CHECK(stabbed.size() == expected.size());
+            for(size_t i = 0; i < std::min(stabbed.size(), expected.size()); i++){
+                TEST_CHECK(stabbed[i] == expected[i].segmentIdx);
+            }
+
+            // A vertical query between two random heights crosses the segments in between
+            std::uniform_real_distribution<double> height(-TEST_BOUNDINGBOX, TEST_BOUNDINGBOX);
+            double y1 = height(generator), y2 = height(generator);
+            cg3::Segment2d querySegment(cg3::Point2d(x, std::max(y1, y2)), cg3::Point2d(x, std::min(y1, y2)));
+            std::vector<size_t> crossedTrapezoids, crossedSegments;
+            algorithms::querySegmentCrossing(querySegment, dag, trapezoidalMap, dataset, crossedTrapezoids, crossedSegments);
+            std::vector<size_t> expectedCrossed;
+            for(const CrossingKey &key : expected){
+                if(key.y > std::min(y1, y2) && key.y < std::max(y1, y2)) expectedCrossed.push_back(key.segmentIdx);
+            }
+            TEST_CHECK(crossedSegments == expectedCrossed);
+            TEST_CHECK(crossedTrapezoids.size() == crossedSegments.size() + 1);
+        }
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Stabbing queries on maps with shared endpoints, at random x and at the x of the endpoints, on the Dag of the insertion
+ * and on a balanced Dag of the same map
+ */
+void testStabVertical(){
+    for(unsigned seed = 1; seed <= 4; seed++){
+        TestMap map;
+        map.insert(randomSegments(300, 40, seed));
+
+        std::vector<double> xs;
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-TEST_BOUNDINGBOX, TEST_BOUNDINGBOX);
+        for(size_t i = 0; i < 100; i++) xs.push_back(coordinate(generator));
+        for(const cg3::Point2d &point : map.dataset.getPoints()) xs.push_back(point.x());
+
+        checkStab(map.dataset, map.dag, map.trapezoidalMap, xs);
+
+        // The y-nodes of a balanced Dag are not the ones of the insertion, the walk must not depend on them
+        Dag balancedDag = map.dag;
+        TrapezoidalMap balancedMap = map.trapezoidalMap;
+        algorithms::buildBalancedDag(balancedDag, balancedMap, map.dataset);
+        checkStab(map.dataset, balancedDag, balancedMap, xs);
+    }
+}
+
+}
@@ -0,0 +1,140 @@
+#include "test_utils.h"
+#include "tests.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "algorithms/algorithms.h"
+
+namespace tests{
+
+static size_t failures = 0;
+
+/**
+ * @brief Check a condition of a test
+ * @param[in] condition the condition
+ * @param[in] expression the text of the condition
+ * @param[in] file the file of the check
+ * @param[in] line the line of the check
+ */
+void check(bool condition, const char *expression, const char *file, int line){
+    if(condition) return;
+    failures++;
+    std::printf("%s:%d: check failed: %s\n", file, line, expression);
+}
+
+/**
+ * @brief Get the number of failed checks
+ * @return the number of failed checks since the start
+ */
+size_t numFailures(){
+    return failures;
+}
+
+/**
+ * @brief Constructor, the structures of the empty map
+ */
+TestMap::TestMap() : trapezoidalMap(cg3::Point2d(-TEST_BOUNDINGBOX, -TEST_BOUNDINGBOX), cg3::Point2d(TEST_BOUNDINGBOX, TEST_BOUNDINGBOX)){
+    algorithms::initializeStructures(dag, trapezoidalMap);
+}
+
+/**
+ * @brief Insert segments in the dataset and in the map (the ones rejected by the dataset are skipped)
+ * @param[in] segments the segments
+ */
+void TestMap::insert(const std::vector<cg3::Segment2d> &segments){
+    for(const cg3::Segment2d &segment : segments){
+        bool inserted;
+        dataset.addSegment(segment, inserted);
+        if(inserted) algorithms::buildTrapezoidalMap(segment, dag, trapezoidalMap, dataset);
+    }
+}
+
+/**
+ * @brief Generate random non-crossing segments with the endpoints on a grid, so many of them share an endpoint
+ * @param[in] numSegments the number of segments
+ * @param[in] gridSize the number of points of the grid in every direction
+ * @param[in] seed the seed of the generator
+ * @return the segments accepted by the dataset (the crossing ones and the ones not in general position are discarded)
+ */
+std::vector<cg3::Segment2d> randomSegments(size_t numSegments, size_t gridSize, unsigned seed){
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<size_t> coordinate(0, gridSize - 1);
+    double step = 1.8 * TEST_BOUNDINGBOX / gridSize;
+    // The rows are slightly slanted, so the points have distinct x
+    std::vector<cg3::Point2d> grid;
+    for(size_t i = 0; i < 4 * numSegments; i++){
+        size_t column = coordinate(generator), row = coordinate(generator);
+        grid.push_back(cg3::Point2d(-0.9 * TEST_BOUNDINGBOX + column * step + row * step / gridSize, -0.9 * TEST_BOUNDINGBOX + row * step));
+    }
+    std::uniform_int_distribution<size_t> pointIdx(0, grid.size() - 1);
+
+    TrapezoidalMapDataset dataset;
+    std::vector<cg3::Segment2d> segments;
+    for(size_t attempt = 0; attempt < 100 * numSegments && segments.size() < numSegments; attempt++){
+        cg3::Segment2d segment(grid[pointIdx(generator)], grid[pointIdx(generator)]);
+        bool inserted;
+        dataset.addSegment(segment, inserted);
+        if(inserted) segments.push_back(segment);
+    }
+    return segments;
+}
+
+/**
+ * @brief Generate random segments, one in every cell of a grid, so they never cross (no intersection test is needed)
+ * @param[in] numSegments the number of segments
+ * @param[in] seed the seed of the generator
+ * @return the segments, in random order
+ */
+std::vector<cg3::Segment2d> gridSegments(size_t numSegments, unsigned seed){
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> offset(0.05, 0.95);
+    size_t gridSize = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(numSegments))));
+    double cell = 1.8 * TEST_BOUNDINGBOX / gridSize;
+    std::vector<cg3::Segment2d> segments;
+    for(size_t i = 0; i < numSegments; i++){
+        double x = -0.9 * TEST_BOUNDINGBOX + (i % gridSize) * cell, y = -0.9 * TEST_BOUNDINGBOX + (i / gridSize) * cell;
+        segments.push_back(cg3::Segment2d(cg3::Point2d(x + offset(generator) * cell, y + offset(generator) * cell),
+                                          cg3::Point2d(x + offset(generator) * cell, y + offset(generator) * cell)));
+    }
+    std::shuffle(segments.begin(), segments.end(), generator);
+    return segments;
+}
+
+/**
+ * @brief Generate segments of random length, most of them long, one in every horizontal band so they never cross or touch
+ * @param[in] numSegments the number of segments
+ * @param[in] seed the seed of the generator
+ * @return the segments, in random order
+ */
+std::vector<cg3::Segment2d> longSegments(size_t numSegments, unsigned seed){
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> x(-0.9 * TEST_BOUNDINGBOX, 0.9 * TEST_BOUNDINGBOX), offset(0.05, 0.45);
+    double band = 1.8 * TEST_BOUNDINGBOX / numSegments;
+    std::vector<cg3::Segment2d> segments;
+    for(size_t i = 0; i < numSegments; i++){
+        double y = -0.9 * TEST_BOUNDINGBOX + i * band;
+        segments.push_back(cg3::Segment2d(cg3::Point2d(x(generator), y + offset(generator) * band), cg3::Point2d(x(generator), y + offset(generator) * band)));
+    }
+    std::shuffle(segments.begin(), segments.end(), generator);
+    return segments;
+}
+
+/**
+ * @brief Generate random points in the bounding box
+ * @param[in] numPoints the number of points
+ * @param[in] seed the seed of the generator
+ * @return the points
+ */
+std::vector<cg3::Point2d> randomPoints(size_t numPoints, unsigned seed){
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coordinate(-TEST_BOUNDINGBOX, TEST_BOUNDINGBOX);
+    std::vector<cg3::Point2d> points;
+    for(size_t i = 0; i < numPoints; i++){
+        double x = coordinate(generator);
+        points.push_back(cg3::Point2d(x, coordinate(generator)));
+    }
+    return points;
+}
+
+}
@@ -0,0 +1,38 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <cg3/geometry/segment2.h>
+#include <vector>
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
+// Bounding box of the maps of the tests (the one of the application)
+#define TEST_BOUNDINGBOX 1e+6
+
+/**
+ * @brief Input generators and helpers shared by the tests and by the benchmarks
+ */
+namespace tests{
+    /**
+     * @brief Dataset, Dag and map built with the sequential insertion
+     */
+    struct TestMap{
+        TrapezoidalMapDataset dataset;
+        Dag dag;
+        TrapezoidalMap trapezoidalMap;
+
+        TestMap();
+        void insert(const std::vector<cg3::Segment2d> &segments);
+    };
+
+    std::vector<cg3::Segment2d> randomSegments(size_t numSegments, size_t gridSize, unsigned seed);
+
+    std::vector<cg3::Segment2d> gridSegments(size_t numSegments, unsigned seed);
+
+    std::vector<cg3::Segment2d> longSegments(size_t numSegments, unsigned seed);
+
+    std::vector<cg3::Point2d> randomPoints(size_t numPoints, unsigned seed);
+}
+
+#endif // TEST_UTILS_H
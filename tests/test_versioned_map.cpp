@@ -0,0 +1,29 @@
+#include "tests.h"
+#include "test_utils.h"
+#include "algorithms/algorithms.h"
+#include "algorithms/versioned_map.h"
+
+namespace tests{
+
+/**
+ * @brief The queries on every past version of a persistent map answer as a map built with the segments of that version
+ */
+void testVersionedMap(){
+    std::vector<cg3::Segment2d> segments = gridSegments(1000, 1);
+    VersionedTrapezoidalMap versionedMap;
+    for(const cg3::Segment2d &segment : segments) TEST_CHECK(versionedMap.insertSegment(segment));
+    TEST_CHECK(versionedMap.getVersion() == segments.size());
+
+    std::vector<cg3::Point2d> queryPoints = randomPoints(2000, 1);
+    for(size_t version = 0; version <= segments.size(); version += 125){
+        TestMap map;
+        map.insert(std::vector<cg3::Segment2d>(segments.begin(), segments.begin() + version));
+        size_t mismatches = 0;
+        for(const cg3::Point2d &q : queryPoints){
+            if(versionedMap.locate(q, version) != algorithms::queryAboveBelow(q, map.dag, map.trapezoidalMap, map.dataset)) mismatches++;
+        }
+        TEST_CHECK(mismatches == 0);
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+#include "tests.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "algorithms/algorithms.h"
+
+namespace{
+    /**
+     * @brief Restrict an x-range to the part where a (non vertical) segment is above (or below) a horizontal line
+     * @return false if the part is empty
+     */
+    bool clipRange(const cg3::Segment2d &segment, long double y, bool above, long double &xMin, long double &xMax){
+        cg3::Segment2d ordered = segment;
+        ProjectUtils::orderSegment(ordered);
+        long double slope = (static_cast<long double>(ordered.p2().y()) - ordered.p1().y()) / (static_cast<long double>(ordered.p2().x()) - ordered.p1().x());
+        long double yMin = ordered.p1().y() + slope * (xMin - ordered.p1().x()), yMax = ordered.p1().y() + slope * (xMax - ordered.p1().x());
+        bool minInside = above ? yMin >= y : yMin <= y, maxInside = above ? yMax >= y : yMax <= y;
+        if(!minInside && !maxInside) return false;
+        if(minInside != maxInside){
+            long double xCross = ordered.p1().x() + (y - ordered.p1().y()) / slope;
+            if(minInside) xMax = std::min(xMax, xCross);
+            else xMin = std::max(xMin, xCross);
+        }
+        return xMin <= xMax;
+    }
+
+    /**
+     * @brief Window query by brute force: the trapezoids and the segments with a point in the closed window, sorted by index
+     */
+    void windowBruteForce(const cg3::BoundingBox2 &window, const tests::TestMap &map, std::vector<size_t> &windowTrapezoids, std::vector<size_t> &windowSegments){
+        windowTrapezoids.clear();
+        windowSegments.clear();
+        for(size_t trapezoidIdx = 0; trapezoidIdx < map.trapezoidalMap.numTrapezoids(); trapezoidIdx++){
+            const Trapezoid &trapezoid = map.trapezoidalMap.getTrapezoid(trapezoidIdx);
+            long double xMin = std::max(trapezoid.getLeftPoint().x(), window.min().x()), xMax = std::min(trapezoid.getRightPoint().x(), window.max().x());
+            if(xMin <= xMax && clipRange(trapezoid.getTopSegment(), window.min().y(), true, xMin, xMax) &&
+               clipRange(trapezoid.getBottomSegment(), window.max().y(), false, xMin, xMax)) windowTrapezoids.push_back(trapezoidIdx);
+        }
+        for(size_t segmentIdx = 0; segmentIdx < map.dataset.getIndexedSegments().size(); segmentIdx++){
+            cg3::Segment2d segment = map.dataset.getSegment(segmentIdx);
+            ProjectUtils::orderSegment(segment);
+            long double xMin = std::max(segment.p1().x(), window.min().x()), xMax = std::min(segment.p2().x(), window.max().x());
+            if(xMin <= xMax && clipRange(segment, window.min().y(), true, xMin, xMax) && clipRange(segment, window.max().y(), false, xMin, xMax)){
+                windowSegments.push_back(segmentIdx);
+            }
+        }
+    }
+}
+
+namespace tests{
+
+/**
+ * @brief Window queries against a brute force, with windows from a small part of a trapezoid to the whole bounding box, on maps with
+ * shared endpoints and on a grid map
+ */
+void testWindowQuery(){
+    for(unsigned seed = 1; seed <= 4; seed++){
+        TestMap map;
+        if(seed < 4) map.insert(randomSegments(300, 40, seed));
+        else map.insert(gridSegments(2000, seed));
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-0.99 * TEST_BOUNDINGBOX, 0.99 * TEST_BOUNDINGBOX);
+        std::uniform_real_distribution<double> logSize(2, 6.3);
+        for(size_t i = 0; i < 300; i++){
+            double width = std::pow(10.0, logSize(generator)), height = std::pow(10.0, logSize(generator));
+            double x = coordinate(generator), y = coordinate(generator);
+            cg3::BoundingBox2 window(cg3::Point2d(x, y), cg3::Point2d(std::min(x + width, 0.99 * TEST_BOUNDINGBOX), std::min(y + height, 0.99 * TEST_BOUNDINGBOX)));
+            std::vector<size_t> windowTrapezoids, windowSegments, expectedTrapezoids, expectedSegments;
+            algorithms::queryWindow(window, map.dag, map.trapezoidalMap, map.dataset, windowTrapezoids, windowSegments);
+            windowBruteForce(window, map, expectedTrapezoids, expectedSegments);
+            std::sort(windowTrapezoids.begin(), windowTrapezoids.end());
+            std::sort(windowSegments.begin(), windowSegments.end());
+            TEST_CHECK(windowTrapezoids == expectedTrapezoids);
+            TEST_CHECK(windowSegments == expectedSegments);
+        }
+    }
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <cstddef>
+
+// Check a condition of a test: a failure is reported with its position and the test goes on
+#define TEST_CHECK(condition) tests::check((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * @brief Tests of the algorithms and of the data structures, one function per file, run by main
+ */
+namespace tests{
+    void check(bool condition, const char *expression, const char *file, int line);
+
+    size_t numFailures();
+
+    void testBalancedDag();
+
+    void testBatchLocation();
+
+    void testBuildAllocations();
+
+    void testChunkedVector();
+
+    void testDagLayout();
+
+    void testInsertionJournal();
+
+    void testInsertionLog();
+
+    void testInterleavedLocation();
+
+    void testLiveMap();
+
+    void testMapClone();
+
+    void testParallelBuild();
+
+    void testParallelInsertion();
+
+    void testPointLocator();
+
+    void testPredicates();
+
+    void testQuantizedLocation();
+
+    void testQueryAboveBelow();
+
+    void testSegmentCrossing();
+
+    void testSimdLocation();
+
+    void testSmallMapScan();
+
+    void testStabVertical();
+
+    void testVersionedMap();
+
+    void testWindowQuery();
+}
+
+#endif // TESTS_H
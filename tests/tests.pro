@@ -0,0 +1,46 @@
+# Tests of the algorithms and of the data structures (console application, without the viewer)
+TEMPLATE = app
+TARGET = tests
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+# The tests use only the core of cg3lib
+CONFIG += CG3_CORE
+include (../cg3lib/cg3.pri)
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    $$files(../algorithms/*.cpp) \
+    $$files(../data_structures/*.cpp) \
+    ../utils/fileutils.cpp \
+    ../utils/predicates.cpp \
+    ../utils/projectUtils.cpp \
+    main.cpp \
+    test_balanced_dag.cpp \
+    test_batch_location.cpp \
+    test_build_allocations.cpp \
+    test_chunked_vector.cpp \
+    test_dag_layout.cpp \
+    test_insertion_journal.cpp \
+    test_insertion_log.cpp \
+    test_interleaved_location.cpp \
+    test_live_map.cpp \
+    test_map_clone.cpp \
+    test_parallel_build.cpp \
+    test_parallel_insertion.cpp \
+    test_point_locator.cpp \
+    test_predicates.cpp \
+    test_quantized_location.cpp \
+    test_query_above_below.cpp \
+    test_segment_crossing.cpp \
+    test_simd_location.cpp \
+    test_small_map_scan.cpp \
+    test_stab_vertical.cpp \
+    test_utils.cpp \
+    test_versioned_map.cpp \
+    test_window_query.cpp
+
+HEADERS += \
+    tests.h \
+    test_utils.h
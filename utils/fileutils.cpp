@@ -3,11 +3,50 @@
 #include <fstream>
 #include <random>
 #include <iomanip>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "assert.h"
 
 #include "data_structures/trapezoidalmap_dataset.h"
 
+
+namespace {
+
+// First field of a map snapshot file (its last byte is the version of the format)
+const uint64_t SNAPSHOT_MAGIC = 0x32504e5350414d54ULL;
+
+template<class T>
+void appendValue(std::vector<char>& data, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<class T>
+bool readValue(const std::vector<char>& data, size_t& offset, T& value) {
+    if (offset + sizeof(T) > data.size())
+        return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+void appendPoint(std::vector<char>& data, const cg3::Point2d& point) {
+    appendValue(data, point.x());
+    appendValue(data, point.y());
+}
+
+bool readPoint(const std::vector<char>& data, size_t& offset, cg3::Point2d& point) {
+    double x, y;
+    if (!readValue(data, offset, x) || !readValue(data, offset, y))
+        return false;
+    point = cg3::Point2d(x, y);
+    return true;
+}
+
+}
+
 namespace FileUtils {
 
 std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename) {
@@ -57,4 +96,204 @@ std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, cons
 }
 
 
+/**
+ * @brief Save the built structures in a binary file, to load them instead of building them again
+ * @param[in] filename the file of the snapshot
+ * @param[in] dag The DAG search structure
+ * @param[in] trapezoidalMap The trapezoidal Map data structure
+ * @param[in] trapezoidalMapData the trapezoidal map dataset structure
+ * @param[in] sequence a number saved with the structures (the number of logged operations they contain)
+ * @return false if the file could not be written
+ * The snapshot is written in a temporary file, synced and renamed over the old one, so a crash leaves the old snapshot or the new one.
+ * The values are written in the byte order of the machine, with a checksum at the end.
+ */
+bool saveMapSnapshot(const std::string& filename, const Dag& dag, const TrapezoidalMap& trapezoidalMap, const TrapezoidalMapDataset& trapezoidalMapData, uint64_t sequence) {
+    std::vector<char> data;
+    appendValue(data, SNAPSHOT_MAGIC);
+    appendValue(data, sequence);
+    appendValue<uint64_t>(data, trapezoidalMapData.getPoints().size());
+    appendValue<uint64_t>(data, trapezoidalMapData.getIndexedSegments().size());
+    appendValue<uint64_t>(data, trapezoidalMap.numTrapezoids());
+    appendValue<uint64_t>(data, dag.numNodes());
+
+    for (const cg3::Point2d& point : trapezoidalMapData.getPoints()) {
+        appendPoint(data, point);
+    }
+    for (const TrapezoidalMapDataset::IndexedSegment2d& indexedSegment : trapezoidalMapData.getIndexedSegments()) {
+        appendValue<uint64_t>(data, indexedSegment.first);
+        appendValue<uint64_t>(data, indexedSegment.second);
+    }
+    for (const Trapezoid& trapezoid : trapezoidalMap.getTrapezoids()) {
+        appendPoint(data, trapezoid.getTopSegment().p1());
+        appendPoint(data, trapezoid.getTopSegment().p2());
+        appendPoint(data, trapezoid.getBottomSegment().p1());
+        appendPoint(data, trapezoid.getBottomSegment().p2());
+        appendPoint(data, trapezoid.getLeftPoint());
+        appendPoint(data, trapezoid.getRightPoint());
+        appendValue<uint64_t>(data, trapezoid.getUpperLeftNeighbor());
+        appendValue<uint64_t>(data, trapezoid.getLowerLeftNeighbor());
+        appendValue<uint64_t>(data, trapezoid.getUpperRightNeighbor());
+        appendValue<uint64_t>(data, trapezoid.getLowerRightNeighbor());
+        appendValue<uint64_t>(data, trapezoid.getNodeIdx());
+        appendValue<uint64_t>(data, trapezoid.getTopSegmentIdx());
+        appendValue<uint64_t>(data, trapezoid.getBottomSegmentIdx());
+    }
+    for (const Node& node : dag.getNodes()) {
+        appendValue<uint64_t>(data, node.getType());
+        appendValue<uint64_t>(data, node.getIdx());
+        appendValue<uint64_t>(data, node.getLeftIdx());
+        appendValue<uint64_t>(data, node.getRightIdx());
+    }
+    appendValue(data, checksum(data.data(), data.size()));
+
+    std::string temporaryFilename = filename + ".tmp";
+    int fd = open(temporaryFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    bool written = writeAll(fd, data.data(), data.size()) && fsync(fd) == 0;
+    close(fd);
+    if (!written || rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+        return false;
+
+    // Sync the directory, so the rename is on the disk
+    std::string::size_type separator = filename.find_last_of('/');
+    std::string directory = separator == std::string::npos ? "." : filename.substr(0, separator + 1);
+    int directoryFd = open(directory.c_str(), O_RDONLY);
+    if (directoryFd >= 0) {
+        fsync(directoryFd);
+        close(directoryFd);
+    }
+    return true;
+}
+
+/**
+ * @brief Load the structures saved by saveMapSnapshot
+ * @param[in] filename the file of the snapshot
+ * @param[out] dag The DAG search structure (empty)
+ * @param[out] trapezoidalMap The trapezoidal Map data structure (empty)
+ * @param[out] trapezoidalMapData the trapezoidal map dataset structure (empty)
+ * @param[out] sequence the number saved with the structures
+ * @return false if the file does not exist or it is not a valid snapshot, the structures are not modified
+ * The trapezoids and the nodes are read as they are. The points and the segments are added to the dataset, so its lookup tables and
+ * its intersection checker are built again.
+ */
+bool loadMapSnapshot(const std::string& filename, Dag& dag, TrapezoidalMap& trapezoidalMap, TrapezoidalMapDataset& trapezoidalMapData, uint64_t& sequence) {
+    std::vector<char> data;
+    if (!readAll(filename, data) || data.size() < sizeof(uint64_t))
+        return false;
+    size_t checksumOffset = data.size() - sizeof(uint64_t);
+    uint64_t savedChecksum;
+    std::memcpy(&savedChecksum, data.data() + checksumOffset, sizeof(savedChecksum));
+    if (savedChecksum != checksum(data.data(), checksumOffset))
+        return false;
+    data.resize(checksumOffset);
+
+    size_t offset = 0;
+    uint64_t magic, savedSequence, numPoints, numSegments, numTrapezoids, numNodes;
+    if (!readValue(data, offset, magic) || magic != SNAPSHOT_MAGIC || !readValue(data, offset, savedSequence))
+        return false;
+    if (!readValue(data, offset, numPoints) || !readValue(data, offset, numSegments) ||
+            !readValue(data, offset, numTrapezoids) || !readValue(data, offset, numNodes))
+        return false;
+    size_t trapezoidSize = 12 * sizeof(double) + 7 * sizeof(uint64_t);
+    if (data.size() - offset != numPoints * 2 * sizeof(double) + numSegments * 2 * sizeof(uint64_t) + numTrapezoids * trapezoidSize + numNodes * 4 * sizeof(uint64_t))
+        return false;
+
+    for (uint64_t i = 0; i < numPoints; i++) {
+        cg3::Point2d point;
+        readPoint(data, offset, point);
+        bool inserted;
+        trapezoidalMapData.addPoint(point, inserted);
+        assert(inserted);
+    }
+    for (uint64_t i = 0; i < numSegments; i++) {
+        uint64_t first, second;
+        readValue(data, offset, first);
+        readValue(data, offset, second);
+        bool inserted;
+        trapezoidalMapData.addIndexedSegment(TrapezoidalMapDataset::IndexedSegment2d(first, second), inserted);
+        assert(inserted);
+    }
+
+    trapezoidalMap.reserve(numTrapezoids);
+    for (uint64_t i = 0; i < numTrapezoids; i++) {
+        cg3::Point2d top1, top2, bottom1, bottom2, leftPoint, rightPoint;
+        readPoint(data, offset, top1);
+        readPoint(data, offset, top2);
+        readPoint(data, offset, bottom1);
+        readPoint(data, offset, bottom2);
+        readPoint(data, offset, leftPoint);
+        readPoint(data, offset, rightPoint);
+        uint64_t fields[7];
+        for (uint64_t& field : fields) {
+            readValue(data, offset, field);
+        }
+        Trapezoid trapezoid(cg3::Segment2d(top1, top2), cg3::Segment2d(bottom1, bottom2), leftPoint, rightPoint,
+                            fields[0], fields[1], fields[2], fields[3], fields[4]);
+        trapezoid.setTopSegmentIdx(fields[5]);
+        trapezoid.setBottomSegmentIdx(fields[6]);
+        trapezoidalMap.addTrapezoid(trapezoid);
+    }
+
+    dag.reserve(numNodes);
+    for (uint64_t i = 0; i < numNodes; i++) {
+        uint64_t fields[4];
+        for (uint64_t& field : fields) {
+            readValue(data, offset, field);
+        }
+        Node node(static_cast<Node::NodeType>(fields[0]), fields[1], fields[2], fields[3]);
+        dag.addNode(node);
+    }
+    sequence = savedSequence;
+    return true;
+}
+
+/**
+ * @brief Checksum of the bytes of a file (64 bit FNV-1a)
+ * @param[in] data the bytes
+ * @param[in] size the number of bytes
+ * @return the checksum
+ */
+uint64_t checksum(const char* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Write all the bytes to a file descriptor, retrying the partial writes
+ * @param[in] fd the file descriptor
+ * @param[in] data the bytes
+ * @param[in] size the number of bytes
+ * @return false if the write failed
+ */
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+            return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Read all the bytes of a file
+ * @param[in] filename the file
+ * @param[out] data the bytes
+ * @return false if the file cannot be opened
+ */
+bool readAll(const std::string& filename, std::vector<char>& data) {
+    std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+    if (!infile)
+        return false;
+    data.resize(static_cast<size_t>(infile.tellg()));
+    infile.seekg(0);
+    return static_cast<bool>(infile.read(data.data(), static_cast<std::streamsize>(data.size())));
+}
+
 }
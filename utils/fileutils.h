@@ -1,16 +1,32 @@
 #ifndef FILEUTILS_H
 #define FILEUTILS_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <cg3/geometry/point2.h>
 #include <cg3/geometry/segment2.h>
 
+#include "data_structures/trapezoidalmap_dataset.h"
+#include "data_structures/trapezoidalmap.h"
+#include "data_structures/dag.h"
+
 namespace FileUtils {
 
 std::vector<cg3::Segment2d> getSegmentsFromFile(const std::string& filename);
 
 std::vector<cg3::Segment2d> saveSegmentsInFile(const std::string& filename, const std::vector<cg3::Segment2d>& segments);
 
+bool saveMapSnapshot(const std::string& filename, const Dag& dag, const TrapezoidalMap& trapezoidalMap, const TrapezoidalMapDataset& trapezoidalMapData, uint64_t sequence);
+
+bool loadMapSnapshot(const std::string& filename, Dag& dag, TrapezoidalMap& trapezoidalMap, TrapezoidalMapDataset& trapezoidalMapData, uint64_t& sequence);
+
+uint64_t checksum(const char* data, size_t size);
+
+bool writeAll(int fd, const char* data, size_t size);
+
+bool readAll(const std::string& filename, std::vector<char>& data);
+
 }
 
 #endif // FILEUTILS_H
@@ -0,0 +1,179 @@
+#include "predicates.h"
+#include <atomic>
+#include <cmath>
+
+namespace ProjectUtils{
+
+// Counter of the exact evaluations, shared by all the threads
+static std::atomic<size_t> exactOrientations(0);
+
+/**
+ * @brief Sum of two doubles without rounding error (Knuth's two-sum)
+ * @param[in] a first addend
+ * @param[in] b second addend
+ * @param[out] sum the rounded sum
+ * @param[out] error the rounding error, sum + error = a + b exactly
+ */
+static inline void twoSum(double a, double b, double &sum, double &error){
+    sum = a + b;
+    double bVirtual = sum - a;
+    double aVirtual = sum - bVirtual;
+    error = (a - aVirtual) + (b - bVirtual);
+}
+
+/**
+ * @brief Product of two doubles without rounding error (Dekker's two-product, it does not need a fused multiply-add)
+ * @param[in] a first factor
+ * @param[in] b second factor
+ * @param[out] product the rounded product
+ * @param[out] error the rounding error, product + error = a * b exactly
+ */
+static inline void twoProduct(double a, double b, double &product, double &error){
+    const double splitter = 134217729.0; // 2^27 + 1
+    product = a * b;
+    double c = splitter * a, aHigh = c - (c - a), aLow = a - aHigh;
+    c = splitter * b;
+    double bHigh = c - (c - b), bLow = b - bHigh;
+    error = ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+}
+
+/**
+ * @brief Compute the orientation of three points exactly
+ * @param[in] a first point of the line
+ * @param[in] b second point of the line
+ * @param[in] c the point to test
+ * @return a value with the sign of the exact orientation (the most significant component of the exact determinant)
+ * The determinant is expanded in six products of the input coordinates, each one split in two doubles without error, and the
+ * twelve terms are summed in a nonoverlapping expansion (Shewchuk's grow-expansion), whose largest component has the exact sign.
+ */
+double orient2dExact(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c){
+    exactOrientations.fetch_add(1, std::memory_order_relaxed);
+
+    // (ax - cx) * (by - cy) - (ay - cy) * (bx - cx) = ax*by - ax*cy - cx*by - ay*bx + ay*cx + cy*bx
+    double terms[12];
+    twoProduct(a.x(), b.y(), terms[0], terms[1]);
+    twoProduct(-a.x(), c.y(), terms[2], terms[3]);
+    twoProduct(-c.x(), b.y(), terms[4], terms[5]);
+    twoProduct(-a.y(), b.x(), terms[6], terms[7]);
+    twoProduct(a.y(), c.x(), terms[8], terms[9]);
+    twoProduct(c.y(), b.x(), terms[10], terms[11]);
+
+    double expansion[13];
+    size_t length = 0;
+    for(double term : terms){
+        double q = term;
+        for(size_t i = 0; i < length; i++){
+            twoSum(q, expansion[i], q, expansion[i]);
+        }
+        expansion[length++] = q;
+    }
+
+    for(size_t i = length; i-- > 0;){
+        if(expansion[i] != 0) return expansion[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief Compute the orientation of three points with adaptive precision
+ * @param[in] a first point of the line
+ * @param[in] b second point of the line
+ * @param[in] c the point to test
+ * @return positive if c lies on the left of the line from a to b, negative if on the right, zero if the points are collinear
+ * The floating point determinant is returned when its error bound proves the sign (almost always, a few multiplies),
+ * otherwise the exact evaluation decides (Shewchuk's orient2d filter).
+ */
+double orient2d(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c){
+    double detLeft = (a.x() - c.x()) * (b.y() - c.y());
+    double detRight = (a.y() - c.y()) * (b.x() - c.x());
+    double det = detLeft - detRight;
+
+    double detSum;
+    if(detLeft > 0){
+        if(detRight <= 0) return det;
+        detSum = detLeft + detRight;
+    }else if(detLeft < 0){
+        if(detRight >= 0) return det;
+        detSum = -detLeft - detRight;
+    }else{
+        return det;
+    }
+
+    double errorBound = ORIENT2D_ERROR_BOUND * detSum;
+    if(det >= errorBound || -det >= errorBound) return det;
+
+    return orient2dExact(a, b, c);
+}
+
+/**
+ * @brief Check if a point lies strictly above a segment
+ * @param[in] segment the segment, with the endpoints ordered by x
+ * @param[in] q the point
+ * @return true if q is strictly above the line of the segment
+ */
+bool isPointAbove(const cg3::Segment2d &segment, const cg3::Point2d &q){
+    return orient2d(segment.p1(), segment.p2(), q) > 0;
+}
+
+/**
+ * @brief Check if a point lies strictly below a segment
+ * @param[in] segment the segment, with the endpoints ordered by x
+ * @param[in] q the point
+ * @return true if q is strictly below the line of the segment
+ */
+bool isPointBelow(const cg3::Segment2d &segment, const cg3::Point2d &q){
+    return orient2d(segment.p1(), segment.p2(), q) < 0;
+}
+
+/**
+ * @brief Check if a point lies above a segment just to the right of the point
+ * @param[in] segment the segment, with the endpoints ordered by x (it must span an x just greater than the one of q)
+ * @param[in] q the point
+ * @return true if q is strictly above the line of the segment, or on it and the segment goes down to the right
+ * The convention of the x-nodes for the points of a vertical line: the line lies just to the right of its x.
+ */
+bool isPointAboveRight(const cg3::Segment2d &segment, const cg3::Point2d &q){
+    double orientation = orient2d(segment.p1(), segment.p2(), q);
+    if(orientation != 0) return orientation > 0;
+    return segment.p2().y() < segment.p1().y();
+}
+
+/**
+ * @brief Check if a segment lies above another one
+ * @param[in] s1 the first segment, with the endpoints ordered by x
+ * @param[in] s2 the second segment, with the endpoints ordered by x
+ * @return true if s1 is above s2 in the x-range they share (the segments must not cross and their x-ranges must overlap)
+ * The segments do not cross, so their order is the same in the whole open range they share: it is decided exactly by the orientation
+ * of an endpoint lying in the range with respect to the other segment, or of the other endpoint if the segments share that one.
+ */
+bool isSegmentAbove(const cg3::Segment2d &s1, const cg3::Segment2d &s2){
+    if(s2.p1().x() >= s1.p1().x()){
+        // The left endpoint of s2 lies in the range of s1
+        double orientation = orient2d(s1.p1(), s1.p2(), s2.p1());
+        if(orientation != 0) return orientation < 0;
+        if(s2.p2().x() <= s1.p2().x()) return isPointBelow(s1, s2.p2());
+        return isPointAbove(s2, s1.p2());
+    }
+    // The left endpoint of s1 lies in the range of s2
+    double orientation = orient2d(s2.p1(), s2.p2(), s1.p1());
+    if(orientation != 0) return orientation > 0;
+    if(s1.p2().x() <= s2.p2().x()) return isPointAbove(s2, s1.p2());
+    return isPointBelow(s1, s2.p2());
+}
+
+/**
+ * @brief Get the number of orientations decided by the exact evaluation
+ * @return the number of exact evaluations since the start (or the last reset)
+ */
+size_t orientationFallbacks(){
+    return exactOrientations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reset the counter of the exact evaluations
+ */
+void resetOrientationFallbacks(){
+    exactOrientations.store(0, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cg3/geometry/point2.h>
+#include <cg3/geometry/segment2.h>
+#include <cstddef>
+
+// Relative error bound of the floating point orientation (Shewchuk's ccwerrboundA, with epsilon = 2^-53)
+#define ORIENT2D_ERROR_BOUND ((3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16)
+
+// Adaptive precision geometric predicates
+namespace ProjectUtils{
+
+// Orientation of c with respect to the line through a and b: positive if c is on the left, negative on the right, zero if collinear
+double orient2d(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c);
+
+// Orientation computed exactly (used when the floating point filter cannot decide)
+double orient2dExact(const cg3::Point2d &a, const cg3::Point2d &b, const cg3::Point2d &c);
+
+// Position of a point with respect to a segment with endpoints ordered by x (strictly above / strictly below)
+bool isPointAbove(const cg3::Segment2d &segment, const cg3::Point2d &q);
+
+bool isPointBelow(const cg3::Segment2d &segment, const cg3::Point2d &q);
+
+// Position of a point with respect to a segment just to the right of the point's x (a point on the segment is above it if the segment goes down)
+bool isPointAboveRight(const cg3::Segment2d &segment, const cg3::Point2d &q);
+
+// Order of two non-crossing segments with endpoints ordered by x, in the x-range they share
+bool isSegmentAbove(const cg3::Segment2d &s1, const cg3::Segment2d &s2);
+
+// Number of orientations decided by the exact fallback
+size_t orientationFallbacks();
+
+void resetOrientationFallbacks();
+}
+
+#endif // PREDICATES_H
@@ -58,6 +58,60 @@ bool rightPointEqualBottomRightEndpoint(const Trapezoid &trapezoid){
     return trapezoid.getRightPoint() == bottomSegment.p2();
 }
 
+/**
+ * @brief Compute the y coordinate of the line supporting a (non vertical) segment at a given x
+ * @param[in] segment the segment
+ * @param[in] x the x coordinate
+ * @return the y coordinate of the segment at x
+*/
+double segmentYAt(const cg3::Segment2d &segment, double x){
+    if(x == segment.p1().x()) return segment.p1().y();
+    if(x == segment.p2().x()) return segment.p2().y();
+    double slope = (segment.p2().y() - segment.p1().y()) / (segment.p2().x() - segment.p1().x());
+    return segment.p1().y() + slope * (x - segment.p1().x());
+}
+
+/**
+ * @brief Compute the intersection point of the lines supporting two segments
+ * @param[in] s1 the first segment
+ * @param[in] s2 the second segment
+ * @return the intersection point (the first endpoint of s1 if the lines are parallel)
+*/
+cg3::Point2d linesIntersection(const cg3::Segment2d &s1, const cg3::Segment2d &s2){
+    double dx1 = s1.p2().x() - s1.p1().x(), dy1 = s1.p2().y() - s1.p1().y();
+    double dx2 = s2.p2().x() - s2.p1().x(), dy2 = s2.p2().y() - s2.p1().y();
+    double denominator = dx1 * dy2 - dy1 * dx2;
+    if(denominator == 0) return s1.p1();
+    double t = ((s2.p1().x() - s1.p1().x()) * dy2 - (s2.p1().y() - s1.p1().y()) * dx2) / denominator;
+    // Keep the exact x when s1 is vertical
+    double x = dx1 == 0 ? s1.p1().x() : s1.p1().x() + t * dx1;
+    return cg3::Point2d(x, s1.p1().y() + t * dy1);
+}
+
+/**
+ * @brief Restrict an x-range to the part where a (non vertical) segment lies above (or below) a horizontal line
+ * @param[in] segment the segment
+ * @param[in] y the y coordinate of the horizontal line
+ * @param[in] above true to keep the part where the segment is above the line, false for the part where it is below
+ * @param[in,out] xMin the lower limit of the range
+ * @param[in,out] xMax the upper limit of the range
+ * @return true if the restricted range is not empty, false otherwise
+*/
+bool clipRangeAboveBelow(const cg3::Segment2d &segment, double y, bool above, double &xMin, double &xMax){
+    double yMin = segmentYAt(segment, xMin);
+    double yMax = segmentYAt(segment, xMax);
+    bool minInside = above ? yMin >= y : yMin <= y;
+    bool maxInside = above ? yMax >= y : yMax <= y;
+    if(!minInside && !maxInside) return false;
+    if(minInside != maxInside){
+        // The segment crosses the line inside the range
+        double xCross = xMin + (y - yMin) * (xMax - xMin) / (yMax - yMin);
+        if(minInside) xMax = std::max(xMin, std::min(xMax, xCross));
+        else xMin = std::min(xMax, std::max(xMin, xCross));
+    }
+    return xMin <= xMax;
+}
+
 /**
  * @brief generate a random color
  * @return a random generated color
@@ -17,6 +17,13 @@ bool leftPointEqualBottomLeftEndpoint(const Trapezoid &trapezoid);
 
 bool rightPointEqualBottomRightEndpoint(const Trapezoid &trapezoid);
 
+// Utility functions to evaluate a segment at a given x and to intersect the lines supporting two segments
+double segmentYAt(const cg3::Segment2d &segment, double x);
+
+cg3::Point2d linesIntersection(const cg3::Segment2d &s1, const cg3::Segment2d &s2);
+
+bool clipRangeAboveBelow(const cg3::Segment2d &segment, double y, bool above, double &xMin, double &xMax);
+
 // Utility function to generate a random color
 const cg3::Color randomColor();
 }